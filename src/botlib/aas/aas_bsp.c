@@ -0,0 +1,867 @@
+#include "aas_local.h"
+#include "aas_map.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "botlib/common/l_log.h"
+
+/*
+ * Static world collision built from the map's .bsp, mirroring the brush
+ * tracing in the engine's cmodel.c.  Everything is read-only once
+ * AAS_LoadBSPCollision returns and each trace keeps its state on the stack,
+ * so traces may run on any thread while the map stays loaded.
+ */
+
+#define AAS_BSP_MAX_BRUSHES   8192 /* MAX_MAP_BRUSHES in qfiles.h */
+#define AAS_BSP_MAX_DEPTH     256
+#define AAS_BSP_DIST_EPSILON  0.03125f
+#define AAS_BSP_MAX_PVS_BYTES (32U * 1024U * 1024U)
+
+/* on-disk record sizes from qfiles.h */
+#define Q2_DPLANE_SIZE     20
+#define Q2_DNODE_SIZE      28
+#define Q2_DLEAF_SIZE      28
+#define Q2_DLEAFBRUSH_SIZE 2
+#define Q2_DBRUSH_SIZE     12
+#define Q2_DBRUSHSIDE_SIZE 4
+#define Q2_DMODEL_SIZE     48
+
+typedef struct aas_bspnode_s
+{
+    int planenum;
+    int children[2]; /* negative numbers are -(leafnum + 1) */
+} aas_bspnode_t;
+
+typedef struct aas_bspleaf_s
+{
+    int contents;
+    int cluster;
+    int area;
+    int firstleafbrush;
+    int numleafbrushes;
+} aas_bspleaf_t;
+
+typedef struct aas_bspbrush_s
+{
+    int firstside;
+    int numsides;
+    int contents;
+} aas_bspbrush_t;
+
+typedef struct aas_bspmodel_s
+{
+    vec3_t mins;
+    vec3_t maxs;
+    vec3_t origin;
+    int headnode;
+} aas_bspmodel_t;
+
+typedef struct aas_bspworld_s
+{
+    qboolean loaded;
+    int numPlanes;
+    cplane_t *planes;
+    int numNodes;
+    aas_bspnode_t *nodes;
+    int numLeafs;
+    aas_bspleaf_t *leafs;
+    int numLeafBrushes;
+    int *leafbrushes;
+    int numBrushes;
+    aas_bspbrush_t *brushes;
+    int numBrushSides;
+    int *brushsidePlanes;
+    int numModels;
+    aas_bspmodel_t *models;
+    int numClusters;
+    size_t pvsRowBytes;
+    unsigned char *pvs; /* decompressed PVS, one row of cluster bits per cluster */
+} aas_bspworld_t;
+
+static aas_bspworld_t bspworld;
+
+typedef struct aas_bsptrace_s
+{
+    vec3_t start;
+    vec3_t end;
+    vec3_t mins;
+    vec3_t maxs;
+    vec3_t extents;
+    int contents;
+    qboolean ispoint;
+    bsp_trace_t trace;
+    unsigned char checked[AAS_BSP_MAX_BRUSHES / 8]; /* brushes already clipped */
+} aas_bsptrace_t;
+
+static int32_t BSP_ReadLong(const unsigned char *p)
+{
+    return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+static int BSP_ReadShort(const unsigned char *p)
+{
+    return (int16_t)(uint16_t)((unsigned int)p[0] | ((unsigned int)p[1] << 8));
+}
+
+static int BSP_ReadUnsignedShort(const unsigned char *p)
+{
+    return (int)((unsigned int)p[0] | ((unsigned int)p[1] << 8));
+}
+
+static float BSP_ReadFloat(const unsigned char *p)
+{
+    uint32_t bits = (uint32_t)BSP_ReadLong(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* Returns the lump's record count, or -1 when it is out of bounds or ragged. */
+static int BSP_LumpRecords(const q2_lump_t *lump, size_t size, size_t recordSize, const char *name)
+{
+    if (lump->offset < 0 || lump->length < 0
+        || (size_t)lump->offset > size || (size_t)lump->length > size - (size_t)lump->offset
+        || (size_t)lump->length % recordSize != 0U)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_LoadBSPCollision: malformed %s lump\n", name);
+        return -1;
+    }
+
+    return (int)((size_t)lump->length / recordSize);
+}
+
+void AAS_FreeBSPCollision(void)
+{
+    free(bspworld.planes);
+    free(bspworld.nodes);
+    free(bspworld.leafs);
+    free(bspworld.leafbrushes);
+    free(bspworld.brushes);
+    free(bspworld.brushsidePlanes);
+    free(bspworld.models);
+    free(bspworld.pvs);
+    memset(&bspworld, 0, sizeof(bspworld));
+}
+
+qboolean AAS_BSPCollisionLoaded(void)
+{
+    return bspworld.loaded;
+}
+
+static int BSP_LoadFail(const char *reason)
+{
+    BotLib_Print(PRT_WARNING, "AAS_LoadBSPCollision: %s, native traces disabled\n", reason);
+    AAS_FreeBSPCollision();
+    return BLERR_CANNOTREADBSPLUMP;
+}
+
+static qboolean BSP_ValidChild(int child)
+{
+    if (child >= 0)
+    {
+        return (child < bspworld.numNodes) ? qtrue : qfalse;
+    }
+    return (-1 - child < bspworld.numLeafs) ? qtrue : qfalse;
+}
+
+/* Expands one run-length coded PVS row (zero bytes are followed by a run count). */
+static qboolean BSP_DecompressVis(const unsigned char *in, const unsigned char *inEnd, unsigned char *out, size_t rowBytes)
+{
+    size_t written = 0U;
+    while (written < rowBytes)
+    {
+        if (in >= inEnd)
+        {
+            return qfalse;
+        }
+        if (*in != 0U)
+        {
+            out[written++] = *in++;
+            continue;
+        }
+        if (in + 1 >= inEnd)
+        {
+            return qfalse;
+        }
+        size_t run = in[1];
+        in += 2;
+        if (run > rowBytes - written)
+        {
+            run = rowBytes - written;
+        }
+        memset(out + written, 0, run);
+        written += run;
+    }
+    return qtrue;
+}
+
+/*
+ * Decompresses the PVS half of the visibility lump up front so cluster tests
+ * are a single bit lookup.  A missing or damaged lump leaves every cluster
+ * visible from every other, which only costs the culling.
+ */
+static void BSP_LoadVisibility(const unsigned char *data, size_t size, const q2_lump_t *lump)
+{
+    if (lump->length == 0)
+    {
+        return;
+    }
+    if (lump->offset < 0 || lump->length < 4
+        || (size_t)lump->offset > size || (size_t)lump->length > size - (size_t)lump->offset)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_LoadBSPCollision: malformed visibility lump, PVS disabled\n");
+        return;
+    }
+
+    const unsigned char *vis = data + lump->offset;
+    const unsigned char *visEnd = vis + lump->length;
+    int numClusters = BSP_ReadLong(vis);
+    size_t rowBytes = ((size_t)numClusters + 7U) / 8U;
+    if (numClusters <= 0 || (size_t)numClusters > ((size_t)lump->length - 4U) / 8U
+        || (size_t)numClusters * rowBytes > AAS_BSP_MAX_PVS_BYTES)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_LoadBSPCollision: unusable visibility lump, PVS disabled\n");
+        return;
+    }
+
+    unsigned char *pvs = (unsigned char *)malloc((size_t)numClusters * rowBytes);
+    if (pvs == NULL)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_LoadBSPCollision: out of memory, PVS disabled\n");
+        return;
+    }
+
+    for (int cluster = 0; cluster < numClusters; ++cluster)
+    {
+        int32_t offset = BSP_ReadLong(vis + 4 + cluster * 8);
+        if (offset < 0 || offset >= lump->length
+            || !BSP_DecompressVis(vis + offset, visEnd, pvs + (size_t)cluster * rowBytes, rowBytes))
+        {
+            BotLib_Print(PRT_WARNING, "AAS_LoadBSPCollision: corrupt PVS row %d, PVS disabled\n", cluster);
+            free(pvs);
+            return;
+        }
+    }
+
+    bspworld.numClusters = numClusters;
+    bspworld.pvsRowBytes = rowBytes;
+    bspworld.pvs = pvs;
+}
+
+/*
+ * Copies the collision lumps out of the .bsp image into compact arrays.  The
+ * caller passes lumps already converted to host byte order; records are read
+ * byte by byte so the image itself never needs swapping.
+ */
+int AAS_LoadBSPCollision(const unsigned char *data, size_t size, const struct q2_lump_s *lumps)
+{
+    AAS_FreeBSPCollision();
+
+    if (data == NULL || lumps == NULL)
+    {
+        return BLERR_CANNOTREADBSPLUMP;
+    }
+
+    int numPlanes = BSP_LumpRecords(&lumps[Q2_BSP_LUMP_PLANES], size, Q2_DPLANE_SIZE, "plane");
+    int numNodes = BSP_LumpRecords(&lumps[Q2_BSP_LUMP_NODES], size, Q2_DNODE_SIZE, "node");
+    int numLeafs = BSP_LumpRecords(&lumps[Q2_BSP_LUMP_LEAFS], size, Q2_DLEAF_SIZE, "leaf");
+    int numLeafBrushes = BSP_LumpRecords(&lumps[Q2_BSP_LUMP_LEAFBRUSHES], size, Q2_DLEAFBRUSH_SIZE, "leafbrush");
+    int numBrushes = BSP_LumpRecords(&lumps[Q2_BSP_LUMP_BRUSHES], size, Q2_DBRUSH_SIZE, "brush");
+    int numBrushSides = BSP_LumpRecords(&lumps[Q2_BSP_LUMP_BRUSHSIDES], size, Q2_DBRUSHSIDE_SIZE, "brushside");
+    int numModels = BSP_LumpRecords(&lumps[Q2_BSP_LUMP_MODELS], size, Q2_DMODEL_SIZE, "model");
+    if (numPlanes < 0 || numNodes < 0 || numLeafs < 0 || numLeafBrushes < 0
+        || numBrushes < 0 || numBrushSides < 0 || numModels < 0)
+    {
+        return BSP_LoadFail("malformed collision lumps");
+    }
+    if (numPlanes == 0 || numNodes == 0 || numLeafs == 0 || numModels == 0)
+    {
+        return BSP_LoadFail("map has no collision tree");
+    }
+    if (numBrushes > AAS_BSP_MAX_BRUSHES)
+    {
+        return BSP_LoadFail("too many brushes");
+    }
+
+    bspworld.planes = (cplane_t *)calloc((size_t)numPlanes, sizeof(cplane_t));
+    bspworld.nodes = (aas_bspnode_t *)calloc((size_t)numNodes, sizeof(aas_bspnode_t));
+    bspworld.leafs = (aas_bspleaf_t *)calloc((size_t)numLeafs, sizeof(aas_bspleaf_t));
+    bspworld.leafbrushes = (int *)calloc((size_t)numLeafBrushes + 1U, sizeof(int));
+    bspworld.brushes = (aas_bspbrush_t *)calloc((size_t)numBrushes + 1U, sizeof(aas_bspbrush_t));
+    bspworld.brushsidePlanes = (int *)calloc((size_t)numBrushSides + 1U, sizeof(int));
+    bspworld.models = (aas_bspmodel_t *)calloc((size_t)numModels, sizeof(aas_bspmodel_t));
+    if (bspworld.planes == NULL || bspworld.nodes == NULL || bspworld.leafs == NULL
+        || bspworld.leafbrushes == NULL || bspworld.brushes == NULL
+        || bspworld.brushsidePlanes == NULL || bspworld.models == NULL)
+    {
+        return BSP_LoadFail("out of memory");
+    }
+    bspworld.numPlanes = numPlanes;
+    bspworld.numNodes = numNodes;
+    bspworld.numLeafs = numLeafs;
+    bspworld.numLeafBrushes = numLeafBrushes;
+    bspworld.numBrushes = numBrushes;
+    bspworld.numBrushSides = numBrushSides;
+    bspworld.numModels = numModels;
+
+    const unsigned char *record = data + lumps[Q2_BSP_LUMP_PLANES].offset;
+    for (int index = 0; index < numPlanes; ++index, record += Q2_DPLANE_SIZE)
+    {
+        cplane_t *plane = &bspworld.planes[index];
+        int signbits = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            plane->normal[axis] = BSP_ReadFloat(record + axis * 4);
+            if (plane->normal[axis] < 0.0f)
+            {
+                signbits |= 1 << axis;
+            }
+        }
+        plane->dist = BSP_ReadFloat(record + 12);
+        int type = BSP_ReadLong(record + 16);
+        /* the axial fast path assumes a positive unit normal */
+        if (type < 0 || type >= 3 || plane->normal[type] != 1.0f)
+        {
+            type = 3;
+        }
+        plane->type = (byte)type;
+        plane->signbits = (byte)signbits;
+    }
+
+    record = data + lumps[Q2_BSP_LUMP_NODES].offset;
+    for (int index = 0; index < numNodes; ++index, record += Q2_DNODE_SIZE)
+    {
+        aas_bspnode_t *node = &bspworld.nodes[index];
+        node->planenum = BSP_ReadLong(record);
+        node->children[0] = BSP_ReadLong(record + 4);
+        node->children[1] = BSP_ReadLong(record + 8);
+        if (node->planenum < 0 || node->planenum >= numPlanes
+            || !BSP_ValidChild(node->children[0]) || !BSP_ValidChild(node->children[1]))
+        {
+            return BSP_LoadFail("node references out of range");
+        }
+    }
+
+    record = data + lumps[Q2_BSP_LUMP_LEAFS].offset;
+    for (int index = 0; index < numLeafs; ++index, record += Q2_DLEAF_SIZE)
+    {
+        aas_bspleaf_t *leaf = &bspworld.leafs[index];
+        leaf->contents = BSP_ReadLong(record);
+        leaf->cluster = BSP_ReadShort(record + 4);
+        leaf->area = BSP_ReadShort(record + 6);
+        leaf->firstleafbrush = BSP_ReadUnsignedShort(record + 24);
+        leaf->numleafbrushes = BSP_ReadUnsignedShort(record + 26);
+        if (leaf->firstleafbrush + leaf->numleafbrushes > numLeafBrushes)
+        {
+            return BSP_LoadFail("leaf brush range out of bounds");
+        }
+    }
+
+    record = data + lumps[Q2_BSP_LUMP_LEAFBRUSHES].offset;
+    for (int index = 0; index < numLeafBrushes; ++index, record += Q2_DLEAFBRUSH_SIZE)
+    {
+        bspworld.leafbrushes[index] = BSP_ReadUnsignedShort(record);
+        if (bspworld.leafbrushes[index] >= numBrushes)
+        {
+            return BSP_LoadFail("leaf brush index out of bounds");
+        }
+    }
+
+    record = data + lumps[Q2_BSP_LUMP_BRUSHES].offset;
+    for (int index = 0; index < numBrushes; ++index, record += Q2_DBRUSH_SIZE)
+    {
+        aas_bspbrush_t *brush = &bspworld.brushes[index];
+        brush->firstside = BSP_ReadLong(record);
+        brush->numsides = BSP_ReadLong(record + 4);
+        brush->contents = BSP_ReadLong(record + 8);
+        if (brush->firstside < 0 || brush->numsides < 0 || brush->firstside > numBrushSides
+            || brush->numsides > numBrushSides - brush->firstside)
+        {
+            return BSP_LoadFail("brush side range out of bounds");
+        }
+    }
+
+    record = data + lumps[Q2_BSP_LUMP_BRUSHSIDES].offset;
+    for (int index = 0; index < numBrushSides; ++index, record += Q2_DBRUSHSIDE_SIZE)
+    {
+        bspworld.brushsidePlanes[index] = BSP_ReadUnsignedShort(record);
+        if (bspworld.brushsidePlanes[index] >= numPlanes)
+        {
+            return BSP_LoadFail("brush side plane out of bounds");
+        }
+    }
+
+    record = data + lumps[Q2_BSP_LUMP_MODELS].offset;
+    for (int index = 0; index < numModels; ++index, record += Q2_DMODEL_SIZE)
+    {
+        aas_bspmodel_t *model = &bspworld.models[index];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            model->mins[axis] = BSP_ReadFloat(record + axis * 4);
+            model->maxs[axis] = BSP_ReadFloat(record + 12 + axis * 4);
+            model->origin[axis] = BSP_ReadFloat(record + 24 + axis * 4);
+        }
+        model->headnode = BSP_ReadLong(record + 36);
+        if (!BSP_ValidChild(model->headnode))
+        {
+            return BSP_LoadFail("model head node out of bounds");
+        }
+    }
+
+    bspworld.loaded = qtrue;
+    BSP_LoadVisibility(data, size, &lumps[Q2_BSP_LUMP_VISIBILITY]);
+    return BLERR_NOERROR;
+}
+
+static int BSP_PointLeafnum(int nodenum, const vec3_t point)
+{
+    for (int depth = 0; nodenum >= 0; ++depth)
+    {
+        if (depth >= AAS_BSP_MAX_DEPTH)
+        {
+            return 0;
+        }
+
+        const aas_bspnode_t *node = &bspworld.nodes[nodenum];
+        const cplane_t *plane = &bspworld.planes[node->planenum];
+        float dist = (plane->type < 3) ? point[plane->type] - plane->dist
+                                       : DotProduct(plane->normal, point) - plane->dist;
+        nodenum = node->children[(dist < 0.0f) ? 1 : 0];
+    }
+
+    return -1 - nodenum;
+}
+
+/* Leaf containing the point in the world model, or -1 without collision data. */
+int AAS_BSPPointLeafnum(const vec3_t point)
+{
+    if (!bspworld.loaded || point == NULL)
+    {
+        return -1;
+    }
+
+    return BSP_PointLeafnum(bspworld.models[0].headnode, point);
+}
+
+/* PVS cluster containing the point, or -1 when unknown or in solid. */
+int AAS_BSPPointCluster(const vec3_t point)
+{
+    int leafnum = AAS_BSPPointLeafnum(point);
+    return (leafnum < 0) ? -1 : bspworld.leafs[leafnum].cluster;
+}
+
+/*
+ * Conservative: anything without PVS data (no lump, a point outside any
+ * cluster) counts as potentially visible so callers fall back to tracing.
+ */
+qboolean AAS_BSPClustersVisible(int cluster1, int cluster2)
+{
+    if (bspworld.pvs == NULL || cluster1 < 0 || cluster2 < 0
+        || cluster1 >= bspworld.numClusters || cluster2 >= bspworld.numClusters)
+    {
+        return qtrue;
+    }
+
+    const unsigned char *row = bspworld.pvs + (size_t)cluster1 * bspworld.pvsRowBytes;
+    return (row[cluster2 >> 3] & (1U << (cluster2 & 7))) ? qtrue : qfalse;
+}
+
+int AAS_BSPPointContents(const vec3_t point)
+{
+    int leafnum = AAS_BSPPointLeafnum(point);
+    return (leafnum < 0) ? 0 : bspworld.leafs[leafnum].contents;
+}
+
+static qboolean BSP_BrushChecked(aas_bsptrace_t *tw, int brushnum)
+{
+    unsigned char bit = (unsigned char)(1U << (brushnum & 7));
+    if (tw->checked[brushnum >> 3] & bit)
+    {
+        return qtrue;
+    }
+    tw->checked[brushnum >> 3] |= bit;
+    return qfalse;
+}
+
+static float BSP_BrushSideDist(const aas_bsptrace_t *tw, const cplane_t *plane)
+{
+    if (tw->ispoint)
+    {
+        return plane->dist;
+    }
+
+    vec3_t offset;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        offset[axis] = (plane->normal[axis] < 0.0f) ? tw->maxs[axis] : tw->mins[axis];
+    }
+    return plane->dist - DotProduct(offset, plane->normal);
+}
+
+static void BSP_ClipBoxToBrush(aas_bsptrace_t *tw, int brushnum)
+{
+    const aas_bspbrush_t *brush = &bspworld.brushes[brushnum];
+    if (brush->numsides == 0)
+    {
+        return;
+    }
+
+    float enterfrac = -1.0f;
+    float leavefrac = 1.0f;
+    int leadside = -1;
+    qboolean getout = qfalse;
+    qboolean startout = qfalse;
+
+    for (int side = 0; side < brush->numsides; ++side)
+    {
+        int sidenum = brush->firstside + side;
+        const cplane_t *plane = &bspworld.planes[bspworld.brushsidePlanes[sidenum]];
+        float dist = BSP_BrushSideDist(tw, plane);
+        float d1 = DotProduct(tw->start, plane->normal) - dist;
+        float d2 = DotProduct(tw->end, plane->normal) - dist;
+
+        if (d2 > 0.0f)
+        {
+            getout = qtrue;
+        }
+        if (d1 > 0.0f)
+        {
+            startout = qtrue;
+        }
+
+        /* completely in front of this face, the brush cannot be hit */
+        if (d1 > 0.0f && d2 >= d1)
+        {
+            return;
+        }
+        if (d1 <= 0.0f && d2 <= 0.0f)
+        {
+            continue;
+        }
+
+        if (d1 > d2)
+        {
+            float f = (d1 - AAS_BSP_DIST_EPSILON) / (d1 - d2);
+            if (f > enterfrac)
+            {
+                enterfrac = f;
+                leadside = sidenum;
+            }
+        }
+        else
+        {
+            float f = (d1 + AAS_BSP_DIST_EPSILON) / (d1 - d2);
+            if (f < leavefrac)
+            {
+                leavefrac = f;
+            }
+        }
+    }
+
+    if (!startout)
+    {
+        tw->trace.startsolid = qtrue;
+        if (!getout)
+        {
+            tw->trace.allsolid = qtrue;
+            tw->trace.fraction = 0.0f;
+            tw->trace.contents = brush->contents;
+        }
+        return;
+    }
+
+    if (enterfrac < leavefrac && enterfrac > -1.0f && enterfrac < tw->trace.fraction && leadside >= 0)
+    {
+        tw->trace.fraction = (enterfrac < 0.0f) ? 0.0f : enterfrac;
+        tw->trace.plane = bspworld.planes[bspworld.brushsidePlanes[leadside]];
+        tw->trace.sidenum = leadside;
+        tw->trace.contents = brush->contents;
+    }
+}
+
+static void BSP_TestBoxInBrush(aas_bsptrace_t *tw, int brushnum)
+{
+    const aas_bspbrush_t *brush = &bspworld.brushes[brushnum];
+    if (brush->numsides == 0)
+    {
+        return;
+    }
+
+    for (int side = 0; side < brush->numsides; ++side)
+    {
+        const cplane_t *plane = &bspworld.planes[bspworld.brushsidePlanes[brush->firstside + side]];
+        if (DotProduct(tw->start, plane->normal) - BSP_BrushSideDist(tw, plane) > 0.0f)
+        {
+            return;
+        }
+    }
+
+    tw->trace.startsolid = qtrue;
+    tw->trace.allsolid = qtrue;
+    tw->trace.fraction = 0.0f;
+    tw->trace.contents = brush->contents;
+}
+
+static void BSP_TraceToLeaf(aas_bsptrace_t *tw, int leafnum, qboolean positionTest)
+{
+    const aas_bspleaf_t *leaf = &bspworld.leafs[leafnum];
+    if (!(leaf->contents & tw->contents))
+    {
+        return;
+    }
+
+    for (int index = 0; index < leaf->numleafbrushes; ++index)
+    {
+        int brushnum = bspworld.leafbrushes[leaf->firstleafbrush + index];
+        if (BSP_BrushChecked(tw, brushnum) || !(bspworld.brushes[brushnum].contents & tw->contents))
+        {
+            continue;
+        }
+
+        if (positionTest)
+        {
+            BSP_TestBoxInBrush(tw, brushnum);
+            if (tw->trace.allsolid)
+            {
+                return;
+            }
+        }
+        else
+        {
+            BSP_ClipBoxToBrush(tw, brushnum);
+            if (tw->trace.fraction == 0.0f)
+            {
+                return;
+            }
+        }
+    }
+}
+
+/* 1 when the box is in front of the plane, 2 behind, 3 spanning. */
+static int BSP_BoxOnPlaneSide(const vec3_t absmins, const vec3_t absmaxs, const cplane_t *plane)
+{
+    float dist1 = 0.0f;
+    float dist2 = 0.0f;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float lo = plane->normal[axis] * absmins[axis];
+        float hi = plane->normal[axis] * absmaxs[axis];
+        dist1 += (lo > hi) ? lo : hi;
+        dist2 += (lo > hi) ? hi : lo;
+    }
+
+    int side = 0;
+    if (dist1 >= plane->dist)
+    {
+        side = 1;
+    }
+    if (dist2 < plane->dist)
+    {
+        side |= 2;
+    }
+    return side;
+}
+
+static void BSP_TestBoxLeafs(aas_bsptrace_t *tw, int nodenum, const vec3_t absmins, const vec3_t absmaxs, int depth)
+{
+    while (!tw->trace.allsolid)
+    {
+        if (nodenum < 0)
+        {
+            BSP_TraceToLeaf(tw, -1 - nodenum, qtrue);
+            return;
+        }
+        if (depth >= AAS_BSP_MAX_DEPTH)
+        {
+            return;
+        }
+
+        const aas_bspnode_t *node = &bspworld.nodes[nodenum];
+        int side = BSP_BoxOnPlaneSide(absmins, absmaxs, &bspworld.planes[node->planenum]);
+        if (side == 1)
+        {
+            nodenum = node->children[0];
+        }
+        else if (side == 2)
+        {
+            nodenum = node->children[1];
+        }
+        else
+        {
+            BSP_TestBoxLeafs(tw, node->children[0], absmins, absmaxs, depth + 1);
+            nodenum = node->children[1];
+        }
+        ++depth;
+    }
+}
+
+static void BSP_RecursiveHullCheck(aas_bsptrace_t *tw, int nodenum, float p1f, float p2f,
+                                   const vec3_t p1, const vec3_t p2, int depth)
+{
+    if (tw->trace.fraction <= p1f)
+    {
+        return;
+    }
+
+    if (nodenum < 0)
+    {
+        BSP_TraceToLeaf(tw, -1 - nodenum, qfalse);
+        return;
+    }
+    if (depth >= AAS_BSP_MAX_DEPTH)
+    {
+        return;
+    }
+
+    const aas_bspnode_t *node = &bspworld.nodes[nodenum];
+    const cplane_t *plane = &bspworld.planes[node->planenum];
+    float t1;
+    float t2;
+    float offset;
+    if (plane->type < 3)
+    {
+        t1 = p1[plane->type] - plane->dist;
+        t2 = p2[plane->type] - plane->dist;
+        offset = tw->extents[plane->type];
+    }
+    else
+    {
+        t1 = DotProduct(plane->normal, p1) - plane->dist;
+        t2 = DotProduct(plane->normal, p2) - plane->dist;
+        offset = tw->ispoint ? 0.0f
+                             : fabsf(tw->extents[0] * plane->normal[0])
+                                   + fabsf(tw->extents[1] * plane->normal[1])
+                                   + fabsf(tw->extents[2] * plane->normal[2]);
+    }
+
+    if (t1 >= offset && t2 >= offset)
+    {
+        BSP_RecursiveHullCheck(tw, node->children[0], p1f, p2f, p1, p2, depth + 1);
+        return;
+    }
+    if (t1 < -offset && t2 < -offset)
+    {
+        BSP_RecursiveHullCheck(tw, node->children[1], p1f, p2f, p1, p2, depth + 1);
+        return;
+    }
+
+    /* the segment straddles the plane: walk the near side, then the far side */
+    int side = 0;
+    float frac = 1.0f;
+    float frac2 = 0.0f;
+    if (t1 < t2)
+    {
+        float idist = 1.0f / (t1 - t2);
+        side = 1;
+        frac2 = (t1 + offset + AAS_BSP_DIST_EPSILON) * idist;
+        frac = (t1 - offset + AAS_BSP_DIST_EPSILON) * idist;
+    }
+    else if (t1 > t2)
+    {
+        float idist = 1.0f / (t1 - t2);
+        frac2 = (t1 - offset - AAS_BSP_DIST_EPSILON) * idist;
+        frac = (t1 + offset + AAS_BSP_DIST_EPSILON) * idist;
+    }
+
+    frac = (frac < 0.0f) ? 0.0f : ((frac > 1.0f) ? 1.0f : frac);
+    frac2 = (frac2 < 0.0f) ? 0.0f : ((frac2 > 1.0f) ? 1.0f : frac2);
+
+    vec3_t mid;
+    float midf = p1f + (p2f - p1f) * frac;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        mid[axis] = p1[axis] + frac * (p2[axis] - p1[axis]);
+    }
+    BSP_RecursiveHullCheck(tw, node->children[side], p1f, midf, p1, mid, depth + 1);
+
+    midf = p1f + (p2f - p1f) * frac2;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        mid[axis] = p1[axis] + frac2 * (p2[axis] - p1[axis]);
+    }
+    BSP_RecursiveHullCheck(tw, node->children[side ^ 1], midf, p2f, mid, p2, depth + 1);
+}
+
+/*
+ * Sweeps the box from start to end through the world model's brushes that
+ * match contentmask.  Entities are not considered; ent is always 0 (the
+ * world).  Without collision data the trace reports no hit.
+ */
+bsp_trace_t AAS_BSPTrace(const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int contentmask)
+{
+    aas_bsptrace_t tw;
+    memset(&tw.trace, 0, sizeof(tw.trace));
+    tw.trace.fraction = 1.0f;
+    tw.trace.sidenum = -1;
+    if (end != NULL)
+    {
+        VectorCopy(end, tw.trace.endpos);
+    }
+
+    if (!bspworld.loaded || start == NULL || end == NULL)
+    {
+        return tw.trace;
+    }
+
+    memset(tw.checked, 0, (size_t)(bspworld.numBrushes + 7) / 8U);
+    VectorCopy(start, tw.start);
+    VectorCopy(end, tw.end);
+    if (mins != NULL)
+    {
+        VectorCopy(mins, tw.mins);
+    }
+    else
+    {
+        VectorClear(tw.mins);
+    }
+    if (maxs != NULL)
+    {
+        VectorCopy(maxs, tw.maxs);
+    }
+    else
+    {
+        VectorClear(tw.maxs);
+    }
+    tw.contents = contentmask;
+
+    int headnode = bspworld.models[0].headnode;
+    if (start[0] == end[0] && start[1] == end[1] && start[2] == end[2])
+    {
+        vec3_t absmins;
+        vec3_t absmaxs;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            absmins[axis] = start[axis] + tw.mins[axis] - 1.0f;
+            absmaxs[axis] = start[axis] + tw.maxs[axis] + 1.0f;
+        }
+        tw.ispoint = qfalse;
+        BSP_TestBoxLeafs(&tw, headnode, absmins, absmaxs, 0);
+        VectorCopy(start, tw.trace.endpos);
+        return tw.trace;
+    }
+
+    tw.ispoint = qtrue;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        tw.extents[axis] = (-tw.mins[axis] > tw.maxs[axis]) ? -tw.mins[axis] : tw.maxs[axis];
+        if (tw.mins[axis] != 0.0f || tw.maxs[axis] != 0.0f)
+        {
+            tw.ispoint = qfalse;
+        }
+    }
+
+    BSP_RecursiveHullCheck(&tw, headnode, 0.0f, 1.0f, tw.start, tw.end, 0);
+
+    if (tw.trace.fraction < 1.0f)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            tw.trace.endpos[axis] = start[axis] + tw.trace.fraction * (end[axis] - start[axis]);
+        }
+    }
+    return tw.trace;
+}
@@ -103,8 +103,8 @@ static size_t AAS_DebugListReachabilities(int fromArea)
         BotLib_Print(PRT_MESSAGE,
                      "    reach[%d]: %d -> %d travel=%d time=%u start=(%.2f %.2f %.2f) end=(%.2f %.2f %.2f)\n",
                      index,
-                     fromArea,
-                     reach->areanum,
+                     AAS_AreaOriginalNum(fromArea),
+                     AAS_AreaOriginalNum(reach->areanum),
                      reach->traveltype,
                      (unsigned int)reach->traveltime,
                      reach->start[0],
@@ -120,7 +120,7 @@ static size_t AAS_DebugListReachabilities(int fromArea)
     {
         BotLib_Print(PRT_MESSAGE,
                      "    (no reachability links from area %d)\n",
-                     fromArea);
+                     AAS_AreaOriginalNum(fromArea));
     }
 
     return count;
@@ -135,7 +135,7 @@ static void AAS_DebugDescribeArea(const aas_area_t *area)
 
     BotLib_Print(PRT_MESSAGE,
                  "area %d: faces=%d firstface=%d center=(%.2f %.2f %.2f) mins=(%.2f %.2f %.2f) maxs=(%.2f %.2f %.2f)\n",
-                 area->areanum,
+                 AAS_AreaOriginalNum(area->areanum),
                  area->numfaces,
                  area->firstface,
                  area->center[0],
@@ -236,31 +236,7 @@ static void AAS_DebugDescribeArea(const aas_area_t *area)
 
 static int AAS_DebugFindAreaFromPoint(const vec3_t point)
 {
-    if (aasworld.areas == NULL || aasworld.numAreas <= 0)
-    {
-        return 0;
-    }
-
-    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
-    {
-        const aas_area_t *area = &aasworld.areas[areanum];
-        if (point[0] < area->mins[0] || point[0] > area->maxs[0])
-        {
-            continue;
-        }
-        if (point[1] < area->mins[1] || point[1] > area->maxs[1])
-        {
-            continue;
-        }
-        if (point[2] < area->mins[2] || point[2] > area->maxs[2])
-        {
-            continue;
-        }
-
-        return area->areanum;
-    }
-
-    return 0;
+    return AAS_PointAreaNum(point);
 }
 
 static bool AAS_DebugBuildPath(int startArea,
@@ -454,7 +430,7 @@ void AAS_DebugBotTest(int entnum, const char *arguments, const vec3_t origin, co
     int requestedArea = 0;
     if (arguments != NULL && *arguments != '\0')
     {
-        requestedArea = (int)strtol(arguments, NULL, 10);
+        requestedArea = AAS_AreaInternalNum((int)strtol(arguments, NULL, 10));
     }
 
     if (!AAS_DebugValidArea(requestedArea))
@@ -473,7 +449,7 @@ void AAS_DebugBotTest(int entnum, const char *arguments, const vec3_t origin, co
     {
         BotLib_Print(PRT_WARNING,
                      "bot_test: area %d is invalid\n",
-                     requestedArea);
+                     AAS_AreaOriginalNum(requestedArea));
         return;
     }
 
@@ -488,6 +464,10 @@ void AAS_DebugShowPath(int startArea, int goalArea, const vec3_t start, const ve
         return;
     }
 
+    /* Callers pass file area numbers; see AAS_RenumberAreas. */
+    startArea = AAS_AreaInternalNum(startArea);
+    goalArea = AAS_AreaInternalNum(goalArea);
+
     if (!AAS_DebugValidArea(startArea))
     {
         startArea = AAS_DebugFindAreaFromPoint(start);
@@ -500,15 +480,15 @@ void AAS_DebugShowPath(int startArea, int goalArea, const vec3_t start, const ve
 
     BotLib_Print(PRT_MESSAGE,
                  "aas_showpath start=%d goal=%d\n",
-                 startArea,
-                 goalArea);
+                 AAS_AreaOriginalNum(startArea),
+                 AAS_AreaOriginalNum(goalArea));
 
     if (!AAS_DebugValidArea(startArea) || !AAS_DebugValidArea(goalArea))
     {
         BotLib_Print(PRT_WARNING,
                      "aas_showpath: invalid start (%d) or goal (%d) area\n",
-                     startArea,
-                     goalArea);
+                     AAS_AreaOriginalNum(startArea),
+                     AAS_AreaOriginalNum(goalArea));
         return;
     }
 
@@ -526,8 +506,8 @@ void AAS_DebugShowPath(int startArea, int goalArea, const vec3_t start, const ve
     {
         BotLib_Print(PRT_WARNING,
                      "[aas_debug] aas_showpath: no path found from %d to %d\n",
-                     startArea,
-                     goalArea);
+                     AAS_AreaOriginalNum(startArea),
+                     AAS_AreaOriginalNum(goalArea));
         free(pathIndices);
         return;
     }
@@ -547,8 +527,8 @@ void AAS_DebugShowPath(int startArea, int goalArea, const vec3_t start, const ve
         BotLib_Print(PRT_MESSAGE,
                      "  step %zu: %d -> %d travel=%d time=%u start=(%.2f %.2f %.2f) end=(%.2f %.2f %.2f)\n",
                      step,
-                     fromArea,
-                     reach->areanum,
+                     AAS_AreaOriginalNum(fromArea),
+                     AAS_AreaOriginalNum(reach->areanum),
                      reach->traveltype,
                      (unsigned int)reach->traveltime,
                      reach->start[0],
@@ -594,12 +574,12 @@ void AAS_DebugShowAreas(const int *areas, size_t areaCount)
 
     for (size_t index = 0; index < areaCount; ++index)
     {
-        int areanum = areas[index];
+        int areanum = AAS_AreaInternalNum(areas[index]);
         if (!AAS_DebugValidArea(areanum))
         {
             BotLib_Print(PRT_WARNING,
                          "  area %d is outside the loaded set\n",
-                         areanum);
+                         areas[index]);
             continue;
         }
 
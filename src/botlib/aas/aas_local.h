@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "shared/q_shared.h"
 #include "q2bridge/botlib.h"
@@ -34,6 +35,13 @@ typedef struct aas_node_s
     int children[2];    /* <0 means leaf/area, 0 means solid */
 } aas_node_t;
 
+typedef struct aas_plane_s
+{
+    vec3_t normal;      /* unit normal of the splitting plane */
+    float dist;         /* distance from the origin along normal */
+    int type;           /* axial plane type used by the compiler */
+} aas_plane_t;
+
 /*
  * Travel type definitions reconstructed from the Quake III / Gladiator
  * binaries. The values mirror the original enum encoded in the reachability
@@ -100,6 +108,9 @@ typedef struct aas_node_s
      | TFL_SWIM | TFL_WATERJUMP | TFL_TELEPORT | TFL_ELEVATOR | TFL_AIR | TFL_WATER            \
      | TFL_JUMPPAD | TFL_FUNCBOB)
 
+/* AAS_AreaTravelTimesToGoalAreas: the route is still being searched under the frame budget. */
+#define AAS_TRAVELTIME_PENDING (-1)
+
 typedef struct aas_reachability_s
 {
     int areanum;
@@ -123,6 +134,29 @@ typedef struct aas_areasettings_s
     int firstreachablearea;
 } aas_areasettings_t;
 
+/*
+ * Cluster/portal layout shared with the Quake III AAS format. Cluster and
+ * portal zero are dummies; aas_areasettings_t::cluster stores the cluster
+ * number for regular areas and the negated portal number for portal areas.
+ */
+typedef struct aas_portal_s
+{
+    int areanum;            /* area acting as the portal */
+    int frontcluster;       /* cluster on the front side of the portal */
+    int backcluster;        /* cluster on the back side of the portal */
+    int clusterareanum[2];  /* portal index inside the front/back cluster */
+} aas_portal_t;
+
+typedef int aas_portalindex_t;
+
+typedef struct aas_cluster_s
+{
+    int numareas;             /* areas in the cluster, portals included */
+    int numreachabilityareas; /* leading cluster areas that have reachabilities */
+    int numportals;           /* portals bounding the cluster */
+    int firstportal;          /* first entry in the portal index */
+} aas_cluster_t;
+
 typedef struct aas_link_s
 {
     int entnum;
@@ -133,6 +167,18 @@ typedef struct aas_link_s
     struct aas_link_s *prev_area;
 } aas_link_t;
 
+#define AAS_LINK_BLOCK_SIZE 256
+
+/* Areas an entity remembers inline; bigger entities fall back to their links. */
+#define AAS_ENTITY_AREA_SLOTS 8
+
+/* Storage for pooled entity links; free links are threaded via next_ent. */
+typedef struct aas_linkblock_s
+{
+    struct aas_linkblock_s *next;
+    aas_link_t links[AAS_LINK_BLOCK_SIZE];
+} aas_linkblock_t;
+
 typedef struct bsp_link_s
 {
     int entnum;
@@ -173,29 +219,72 @@ typedef struct aas_entity_s
     aas_link_t *areas;      /* offset 0x84 in original 32-bit build */
     bsp_link_t *leaves;     /* offset 0x88 in original 32-bit build */
 
-    unsigned int *areaOccupancyBits; /* mirrors bitfield built by AAS_AreaEdict */
-    size_t areaOccupancyWords;       /* number of 32-bit words allocated */
-    int areaOccupancyCount;          /* total linked areas for diagnostics */
+    int areaList[AAS_ENTITY_AREA_SLOTS]; /* first areas linked, in link order */
+    int areaOccupancyCount;              /* total linked areas */
     qboolean outsideAllAreas;        /* qtrue if no valid areas were found */
     float lastOutsideUpdate;         /* aasworld.time when outsideAllAreas became true */
+    qboolean frameListed;            /* qtrue while on aasworld.frameEntities */
 } aas_entity_t;
 
-typedef struct aas_reversedreachability_s
+#define AAS_REVERSEEDGE_NONE 0xFF
+
+/*
+ * A reachability seen from its destination, packed with just what the route
+ * searches read per edge.
+ */
+typedef struct aas_reverseedge_s
+{
+    int startArea;
+    int travelflags;           /* AAS_TravelFlagForType of the reachability */
+    unsigned short cost;       /* reachability travel time */
+    unsigned char reachOffset; /* index relative to startArea's first reachability, or NONE */
+    unsigned char moverBit;    /* AAS_MoverModelBitIndex of a mover reachability, or NONE */
+} aas_reverseedge_t;
+
+typedef enum aas_routingcache_type_e
 {
-    int count;
-    int *reachIndexes;
-} aas_reversedreachability_t;
+    AAS_ROUTECACHE_WORLD = 0,   /* whole-map travel times towards a goal area */
+    AAS_ROUTECACHE_CLUSTER = 1, /* travel times inside one cluster towards a goal area */
+    AAS_ROUTECACHE_PORTAL = 2   /* travel times from every portal towards a goal area */
+} aas_routingcache_type_t;
+
+/* One block of a compact routing cache; see RouteCache_Compact. */
+typedef struct aas_routeblock_s
+{
+    unsigned int data;       /* byte offset of the block payload in blockData */
+    unsigned short base;     /* fastest travel time in the block */
+    unsigned char timeBits;  /* bits per packed time delta, 0 when nothing is reachable */
+    unsigned char reachBits; /* bits per packed reachability offset */
+} aas_routeblock_t;
 
 typedef struct aas_routingcache_s
 {
+    int type;               /* aas_routingcache_type_t */
+    int cluster;            /* owning cluster for AAS_ROUTECACHE_CLUSTER entries */
     int goalArea;
     int travelflags;
+    int numTraveltimes;     /* entries in traveltimes */
+    size_t size;            /* bytes charged against max_routingcache */
+    int pinned;             /* non-zero while a search still reads the cache */
+    uint64_t moverModels;   /* mover bit of every mover reachability a stored route takes */
     unsigned short *traveltimes;
+    unsigned char *reachabilities; /* best reach offset per entry, 0xFF when none */
+    aas_routeblock_t *blocks;      /* compact form; replaces the two arrays above when set */
+    unsigned char *blockData;      /* block payloads, allocated with blocks */
+    struct aas_route_kernel_s *frontier; /* paused search of a cache still being filled */
     struct aas_routingcache_s *hashNext;
     struct aas_routingcache_s *prev;
     struct aas_routingcache_s *next;
 } aas_routingcache_t;
 
+/* A whole file mapped read-only, or read into memory where mmap is unavailable. */
+typedef struct aas_fileimage_s
+{
+    unsigned char *data;
+    size_t size;
+    qboolean mapped;
+} aas_fileimage_t;
+
 typedef struct aas_world_s
 {
     qboolean loaded;        /* mirrors data_100667e0 */
@@ -211,6 +300,9 @@ typedef struct aas_world_s
 
     int numAreas;
     aas_area_t *areas;
+    int areaOrder;          /* 0 = file order, 1 = renumbered along a Morton curve */
+    int *areaOriginalNum;   /* file area number of each area, NULL in file order */
+    int *areaInternalNum;   /* area number of each file area, NULL in file order */
 
     int numReachability;
     aas_reachability_t *reachability;
@@ -219,43 +311,129 @@ typedef struct aas_world_s
     aas_areasettings_t *areasettings;
 
     int *reachabilityFromArea; /* index of the source area for each reachability */
-    aas_reversedreachability_t *reversedReachability;
+    int *reverseEdgeOffsets;   /* numAreas + 2 row offsets into reverseEdges */
+    aas_reverseedge_t *reverseEdges;
+    int numReverseEdges;
+    unsigned short maxReverseEdgeCost;
+    int reachabilityTravelFlags; /* union of the travel flags of every edge */
+    int *moverModels;            /* sorted model numbers of elevator and func_bob reachabilities */
+    int numMoverModels;
+
+    int numPlanes;
+    aas_plane_t *planes;
 
     int numNodes;
     aas_node_t *nodes;
 
+    int numPortals;
+    aas_portal_t *portals;
+
+    int numPortalIndex;
+    aas_portalindex_t *portalIndex;
+
+    int numClusters;
+    aas_cluster_t *clusters;
+
+    qboolean clusterRouting; /* qtrue when the cluster/portal lumps validated */
+
     int maxEntities;
     aas_entity_t *entities; /* base pointer from data_100669a0 */
+    int *frameEntities;        /* entities updated since the last AAS_InvalidateEntities */
+    int numFrameEntities;
+    int *lastFrameEntities;    /* the frame before that, walked by AAS_UnlinkInvalidEntities */
+    int numLastFrameEntities;
 
     size_t areaEntityListCount;  /* number of heads in areaEntityLists */
     aas_link_t **areaEntityLists; /* entities linked per area */
+    int *areaEntityCounts;        /* length of each areaEntityLists chain */
+    aas_linkblock_t *linkBlocks;  /* backing storage for the link pool */
+    aas_link_t *freeLinks;        /* recycled links ready for reuse */
 
     int travelflagfortype[MAX_TRAVELTYPES];
 
     size_t routingCacheTableSize;
     aas_routingcache_t **routingCacheTable;
-    aas_routingcache_t *routingCacheHead;
-    aas_routingcache_t *routingCacheTail;
+    aas_routingcache_t *routingCacheHead; /* least recently used */
+    aas_routingcache_t *routingCacheTail; /* most recently used */
+    size_t routingCacheBytes;
 } aas_world_t;
 
 extern aas_world_t aasworld;
 
 void AAS_InitTravelFlagFromType(void);
+int AAS_TravelFlagForType(int traveltype);
 void AAS_ClearReachabilityData(void);
 int AAS_PrepareReachability(void);
+int AAS_MoverModelBitIndex(int modelnum);
 void AAS_FreeAllRoutingCaches(void);
 void AAS_InvalidateRouteCache(void);
+int AAS_InvalidateModelRouteCaches(int modelnum);
 void AAS_ContinueInit(float time);
 void AAS_UnlinkInvalidEntities(void);
 void AAS_InvalidateEntities(void);
 void AAS_FrameSynchronise(float time);
 int AAS_AreaTravelTimeToGoalArea(int areanum, vec3_t origin, int goalareanum, int travelflags);
+qboolean AAS_AreaRouteToGoalArea(int areanum,
+                                 const vec3_t origin,
+                                 int goalareanum,
+                                 int travelflags,
+                                 int *traveltime,
+                                 int *reachnum);
+int AAS_AreaTravelTimesToGoalAreas(int areanum,
+                                   const vec3_t origin,
+                                   const int *goalareas,
+                                   int numgoals,
+                                   int travelflags,
+                                   int *traveltimes);
+qboolean AAS_RouteGraphReady(void);
+void AAS_RegisterRouteGoalArea(int areanum);
+void AAS_ShutdownRoutePrecompute(void);
+int AAS_WriteRouteCache(void);
+int AAS_ReadRouteCache(void);
+void AAS_SaveRouteCache(void);
+qboolean AAS_InitRouteMatrix(void);
+void AAS_FreeRouteMatrix(void);
+qboolean AAS_OpenFileImage(const char *path, aas_fileimage_t *image);
+void AAS_CloseFileImage(aas_fileimage_t *image);
+void AAS_InitClusterRouting(void);
+int AAS_ClusterAreaNum(int cluster, int areanum);
+int AAS_PointAreaNum(const vec3_t point);
+int AAS_BBoxAreas(const vec3_t absmins, const vec3_t absmaxs, int *areas, int maxareas);
+int AAS_TraceAreas(const vec3_t start, const vec3_t end, int *areas, vec3_t *points, int maxareas);
+struct q2_lump_s;
+int AAS_LoadBSPCollision(const unsigned char *data, size_t size, const struct q2_lump_s *lumps);
+void AAS_FreeBSPCollision(void);
+qboolean AAS_BSPCollisionLoaded(void);
+int AAS_BSPPointLeafnum(const vec3_t point);
+int AAS_BSPPointContents(const vec3_t point);
+int AAS_BSPPointCluster(const vec3_t point);
+qboolean AAS_BSPClustersVisible(int cluster1, int cluster2);
+bsp_trace_t AAS_BSPTrace(const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int contentmask);
+void AAS_RenumberAreas(void);
+int AAS_AreaOriginalNum(int areanum);
+int AAS_AreaInternalNum(int areanum);
+qboolean AAS_NodeTreeValid(void);
+int AAS_BoxOnPlaneSide2(const vec3_t absmins, const vec3_t absmaxs, const aas_plane_t *plane);
+void AAS_UnlinkEntityFromAreas(aas_entity_t *entity);
+qboolean AAS_EntityInArea(int entnum, int areanum);
+int AAS_AreaEntityCount(int areanum);
+aas_link_t *AAS_AllocAASLink(void);
+void AAS_DeAllocAASLink(aas_link_t *link);
+void AAS_FreeAASLinkHeap(void);
 void AAS_RouteFrameUpdate(void);
 void AAS_RouteFrameResetDiagnostics(void);
 int AAS_RouteFrameWorkCounter(void);
 int AAS_RouteFrameSkipCounter(void);
 int AAS_RouteFrameLastBudget(void);
 bool AAS_RouteFrameForceWriteActive(void);
+void AAS_RouteCacheResetDiagnostics(void);
+int AAS_RouteCacheHitCounter(void);
+int AAS_RouteCacheMissCounter(void);
+int AAS_RouteCacheEvictionCounter(void);
+int AAS_RouteCacheMoverInvalidationCounter(void);
+int AAS_RouteForwardSearchCounter(void);
+int AAS_RoutePrecomputePendingCounter(void);
+size_t AAS_RouteCacheBytesInUse(void);
 void AAS_ReachabilityFrameUpdate(void);
 void AAS_ReachabilityFrameResetDiagnostics(void);
 int AAS_ReachabilityFrameWorkCounter(void);
@@ -6,45 +6,6 @@
 #include "botlib/common/l_log.h"
 #include "q2bridge/update_translator.h"
 
-static void AAS_FrameRemoveLink(aas_link_t *link)
-{
-    if (link == NULL)
-    {
-        return;
-    }
-
-    if (aasworld.areaEntityLists == NULL)
-    {
-        return;
-    }
-
-    int areanum = link->areanum;
-    if (areanum < 0)
-    {
-        return;
-    }
-
-    size_t index = (size_t)areanum;
-    if (index >= aasworld.areaEntityListCount)
-    {
-        return;
-    }
-
-    if (link->prev_ent != NULL)
-    {
-        link->prev_ent->next_ent = link->next_ent;
-    }
-    else
-    {
-        aasworld.areaEntityLists[index] = link->next_ent;
-    }
-
-    if (link->next_ent != NULL)
-    {
-        link->next_ent->prev_ent = link->prev_ent;
-    }
-}
-
 static void AAS_FrameUnlinkEntity(aas_entity_t *entity)
 {
     if (entity == NULL)
@@ -52,27 +13,16 @@ static void AAS_FrameUnlinkEntity(aas_entity_t *entity)
         return;
     }
 
-    aas_link_t *link = entity->areas;
-    while (link != NULL)
-    {
-        aas_link_t *next = link->next_area;
-        AAS_FrameRemoveLink(link);
-        free(link);
-        link = next;
-    }
-
-    entity->areas = NULL;
-
-    if (entity->areaOccupancyBits != NULL && entity->areaOccupancyWords > 0U)
-    {
-        memset(entity->areaOccupancyBits, 0, entity->areaOccupancyWords * sizeof(unsigned int));
-    }
-
-    entity->areaOccupancyCount = 0;
+    AAS_UnlinkEntityFromAreas(entity);
     entity->outsideAllAreas = qtrue;
     entity->lastOutsideUpdate = aasworld.time;
 }
 
+/*
+ * Entities still linked but not updated last frame.  Only entities updated
+ * the frame before can be in that state, so walk that list rather than the
+ * whole table.
+ */
 void AAS_UnlinkInvalidEntities(void)
 {
     if (aasworld.entities == NULL || aasworld.maxEntities <= 0)
@@ -80,9 +30,9 @@ void AAS_UnlinkInvalidEntities(void)
         return;
     }
 
-    for (int entnum = 0; entnum < aasworld.maxEntities; ++entnum)
+    for (int index = 0; index < aasworld.numLastFrameEntities; ++index)
     {
-        aas_entity_t *entity = &aasworld.entities[entnum];
+        aas_entity_t *entity = &aasworld.entities[aasworld.lastFrameEntities[index]];
         if (!entity->inuse && entity->areas != NULL)
         {
             AAS_FrameUnlinkEntity(entity);
@@ -94,12 +44,18 @@ void AAS_InvalidateEntities(void)
 {
     if (aasworld.entities != NULL && aasworld.maxEntities > 0)
     {
-        for (int entnum = 0; entnum < aasworld.maxEntities; ++entnum)
+        for (int index = 0; index < aasworld.numFrameEntities; ++index)
         {
-            aas_entity_t *entity = &aasworld.entities[entnum];
-            entity->number = entnum;
+            aas_entity_t *entity = &aasworld.entities[aasworld.frameEntities[index]];
             entity->inuse = qfalse;
+            entity->frameListed = qfalse;
         }
+
+        int *lastFrame = aasworld.lastFrameEntities;
+        aasworld.lastFrameEntities = aasworld.frameEntities;
+        aasworld.numLastFrameEntities = aasworld.numFrameEntities;
+        aasworld.frameEntities = lastFrame;
+        aasworld.numFrameEntities = 0;
     }
 
     aasworld.entitiesValid = qfalse;
@@ -10,19 +10,28 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "aas_local.h"
 #include "aas_sound.h"
 #include "botlib/ai_move/mover_catalogue.h"
 #include "botlib/common/l_log.h"
 #include "botlib/interface/botlib_interface.h"
+#include "q2bridge/bridge_config.h"
+#include "q2bridge/update_translator.h"
 #include "botlib/ai_move/mover_catalogue.h"
 
-static void AAS_UnlinkEntityFromAreas(aas_entity_t *entity);
+#define AAS_LINK_STACK_SIZE 128
+#define AAS_MIN_ENTITY_CAPACITY 64
+
 static int AAS_LinkEntityToComputedAreas(aas_entity_t *entity, const vec3_t absmins, const vec3_t absmaxs);
-static void AAS_ResetEntityBitset(aas_entity_t *entity);
-static int AAS_PrepareEntityBitset(aas_entity_t *entity);
 static int AAS_EnsureAreaListArray(void);
-static size_t AAS_AreaBitWordCount(void);
+static int AAS_EnsureEntityCapacity(int ent);
 static void AAS_ClampMinsMaxs(vec3_t mins, vec3_t maxs);
 static void AAS_ClearWorld(void);
 static void AAS_ParseEntityLump(const char *data, size_t length);
@@ -802,9 +811,207 @@ static void AAS_FixupNodes(aas_node_t *nodes, int count)
     }
 }
 
+static void AAS_FixupPlanes(aas_plane_t *planes, int count)
+{
+    if (planes == NULL || count <= 0)
+    {
+        return;
+    }
+
+    for (int index = 0; index < count; ++index)
+    {
+        aas_plane_t *plane = &planes[index];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            plane->normal[axis] = AAS_LittleFloat(plane->normal[axis]);
+        }
+        plane->dist = AAS_LittleFloat(plane->dist);
+        plane->type = AAS_LittleLong(plane->type);
+    }
+}
+
+static void AAS_FixupPortals(aas_portal_t *portals, int count)
+{
+    if (portals == NULL || count <= 0)
+    {
+        return;
+    }
+
+    for (int index = 0; index < count; ++index)
+    {
+        aas_portal_t *portal = &portals[index];
+        portal->areanum = AAS_LittleLong(portal->areanum);
+        portal->frontcluster = AAS_LittleLong(portal->frontcluster);
+        portal->backcluster = AAS_LittleLong(portal->backcluster);
+        portal->clusterareanum[0] = AAS_LittleLong(portal->clusterareanum[0]);
+        portal->clusterareanum[1] = AAS_LittleLong(portal->clusterareanum[1]);
+    }
+}
+
+static void AAS_FixupPortalIndex(aas_portalindex_t *portalIndex, int count)
+{
+    if (portalIndex == NULL || count <= 0)
+    {
+        return;
+    }
+
+    for (int index = 0; index < count; ++index)
+    {
+        portalIndex[index] = AAS_LittleLong(portalIndex[index]);
+    }
+}
+
+static void AAS_FixupClusters(aas_cluster_t *clusters, int count)
+{
+    if (clusters == NULL || count <= 0)
+    {
+        return;
+    }
+
+    for (int index = 0; index < count; ++index)
+    {
+        aas_cluster_t *cluster = &clusters[index];
+        cluster->numareas = AAS_LittleLong(cluster->numareas);
+        cluster->numreachabilityareas = AAS_LittleLong(cluster->numreachabilityareas);
+        cluster->numportals = AAS_LittleLong(cluster->numportals);
+        cluster->firstportal = AAS_LittleLong(cluster->firstportal);
+    }
+}
+
+/*
+ * Whole-file images.  Both map files are brought into memory exactly once per
+ * load: mapped read-only where the platform supports it, otherwise read with a
+ * single fread.  The checksum and every lump are taken from the same bytes.
+ */
+
+/*
+ * Lumps are stored little-endian, so on little-endian hosts an aligned lump
+ * can be used in place and the fixup passes have nothing to do.
+ */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define AAS_LUMPS_NATIVE_ORDER 1
+#else
+#define AAS_LUMPS_NATIVE_ORDER 0
+#endif
+
+static aas_fileimage_t g_aasFileImage;
+
+static qboolean AAS_ReadFileImage(const char *path, aas_fileimage_t *image)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return qfalse;
+    }
+
+    if (fseek(file, 0L, SEEK_END) != 0)
+    {
+        fclose(file);
+        return qfalse;
+    }
+
+    long size = ftell(file);
+    if (size < 0 || fseek(file, 0L, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return qfalse;
+    }
+
+    unsigned char *data = NULL;
+    if (size > 0)
+    {
+        data = (unsigned char *)malloc((size_t)size);
+        if (data == NULL || fread(data, 1U, (size_t)size, file) != (size_t)size)
+        {
+            free(data);
+            fclose(file);
+            return qfalse;
+        }
+    }
+
+    fclose(file);
+    image->data = data;
+    image->size = (size_t)size;
+    image->mapped = qfalse;
+    return qtrue;
+}
+
+qboolean AAS_OpenFileImage(const char *path, aas_fileimage_t *image)
+{
+    if (path == NULL || image == NULL)
+    {
+        return qfalse;
+    }
+
+    memset(image, 0, sizeof(*image));
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return qfalse;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        close(fd);
+        return AAS_ReadFileImage(path, image);
+    }
+
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data != MAP_FAILED)
+    {
+        image->data = (unsigned char *)data;
+        image->size = (size_t)info.st_size;
+        image->mapped = qtrue;
+        return qtrue;
+    }
+#endif
+
+    return AAS_ReadFileImage(path, image);
+}
+
+void AAS_CloseFileImage(aas_fileimage_t *image)
+{
+    if (image == NULL || image->data == NULL)
+    {
+        return;
+    }
+
+#ifndef _WIN32
+    if (image->mapped)
+    {
+        munmap(image->data, image->size);
+    }
+    else
+#endif
+    {
+        free(image->data);
+    }
+
+    memset(image, 0, sizeof(*image));
+}
+
+static qboolean AAS_FileImageContains(const aas_fileimage_t *image, const void *pointer)
+{
+    if (image == NULL || image->data == NULL || pointer == NULL)
+    {
+        return qfalse;
+    }
+
+    const unsigned char *bytes = (const unsigned char *)pointer;
+    return (bytes >= image->data && bytes < image->data + image->size) ? qtrue : qfalse;
+}
+
+/*
+ * CRC-32 (polynomial 0xEDB88320) using slice-by-8 tables: eight input bytes
+ * per step instead of one, with results identical to the bytewise form.
+ */
 static uint32_t AAS_CRC32Update(uint32_t crc, const void *data, size_t length)
 {
-    static uint32_t table[256];
+    static uint32_t table[8][256];
     static int tableInitialised = 0;
 
     if (!tableInitialised)
@@ -824,7 +1031,16 @@ static uint32_t AAS_CRC32Update(uint32_t crc, const void *data, size_t length)
                 }
             }
 
-            table[index] = value;
+            table[0][index] = value;
+        }
+
+        for (uint32_t index = 0; index < 256U; ++index)
+        {
+            for (int slice = 1; slice < 8; ++slice)
+            {
+                uint32_t previous = table[slice - 1][index];
+                table[slice][index] = (previous >> 8) ^ table[0][previous & 0xFFU];
+            }
         }
 
         tableInitialised = 1;
@@ -832,45 +1048,39 @@ static uint32_t AAS_CRC32Update(uint32_t crc, const void *data, size_t length)
 
     const uint8_t *bytes = (const uint8_t *)data;
     crc = ~crc;
-    for (size_t i = 0; i < length; ++i)
-    {
-        crc = table[(crc ^ bytes[i]) & 0xFFU] ^ (crc >> 8);
-    }
-
-    return ~crc;
-}
-
-static qboolean AAS_ComputeFileChecksum(const char *path, uint32_t *checksum)
-{
-    if (path == NULL || checksum == NULL)
-    {
-        return qfalse;
-    }
 
-    FILE *file = fopen(path, "rb");
-    if (file == NULL)
+    while (length >= 8U)
     {
-        return qfalse;
-    }
+        uint32_t low = crc
+                       ^ ((uint32_t)bytes[0]
+                          | ((uint32_t)bytes[1] << 8)
+                          | ((uint32_t)bytes[2] << 16)
+                          | ((uint32_t)bytes[3] << 24));
+        uint32_t high = (uint32_t)bytes[4]
+                        | ((uint32_t)bytes[5] << 8)
+                        | ((uint32_t)bytes[6] << 16)
+                        | ((uint32_t)bytes[7] << 24);
 
-    uint8_t buffer[8192];
-    size_t bytesRead;
-    uint32_t crc = 0U;
+        crc = table[7][low & 0xFFU]
+              ^ table[6][(low >> 8) & 0xFFU]
+              ^ table[5][(low >> 16) & 0xFFU]
+              ^ table[4][low >> 24]
+              ^ table[3][high & 0xFFU]
+              ^ table[2][(high >> 8) & 0xFFU]
+              ^ table[1][(high >> 16) & 0xFFU]
+              ^ table[0][high >> 24];
 
-    while ((bytesRead = fread(buffer, 1U, sizeof(buffer), file)) > 0U)
-    {
-        crc = AAS_CRC32Update(crc, buffer, bytesRead);
+        bytes += 8;
+        length -= 8U;
     }
 
-    if (ferror(file))
+    while (length > 0U)
     {
-        fclose(file);
-        return qfalse;
+        crc = table[0][(crc ^ *bytes++) & 0xFFU] ^ (crc >> 8);
+        --length;
     }
 
-    fclose(file);
-    *checksum = crc;
-    return qtrue;
+    return ~crc;
 }
 
 static int AAS_StringEndsWithIgnoreCase(const char *value, const char *suffix)
@@ -961,45 +1171,16 @@ static qboolean AAS_BuildPath(char *buffer,
     return qtrue;
 }
 
-static long AAS_GetFileSize(FILE *file)
-{
-    if (file == NULL)
-    {
-        return -1L;
-    }
-
-    long current = ftell(file);
-    if (current < 0)
-    {
-        return -1L;
-    }
-
-    if (fseek(file, 0L, SEEK_END) != 0)
-    {
-        return -1L;
-    }
-
-    long size = ftell(file);
-    if (size < 0)
-    {
-        return -1L;
-    }
-
-    if (fseek(file, current, SEEK_SET) != 0)
-    {
-        return -1L;
-    }
-
-    return size;
-}
-
-static int AAS_ReadLump(FILE *file,
+/*
+ * Returns a lump's elements straight out of the file image when the bytes are
+ * already in host order and suitably aligned; otherwise hands back a private
+ * copy the fixup passes may rewrite.  Release with AAS_ReleaseLump.
+ */
+static int AAS_LumpView(const aas_fileimage_t *image,
                         const q2_lump_t *lump,
                         size_t elementSize,
                         void **outBuffer,
                         int *outCount,
-                        long fileSize,
-                        int seekError,
                         int readError)
 {
     if (outBuffer == NULL)
@@ -1013,7 +1194,7 @@ static int AAS_ReadLump(FILE *file,
         *outCount = 0;
     }
 
-    if (lump == NULL || file == NULL)
+    if (lump == NULL || image == NULL)
     {
         return readError;
     }
@@ -1028,42 +1209,41 @@ static int AAS_ReadLump(FILE *file,
         return readError;
     }
 
-    long end = (long)lump->offset + (long)lump->length;
-    if (fileSize >= 0 && (lump->offset > fileSize || end > fileSize))
+    size_t offset = (size_t)lump->offset;
+    size_t length = (size_t)lump->length;
+    if (offset > image->size || length > image->size - offset)
     {
         return readError;
     }
 
-    if (elementSize == 0U || (size_t)lump->length % elementSize != 0U)
+    if (elementSize == 0U || length % elementSize != 0U)
     {
         return readError;
     }
 
-    size_t count = (size_t)lump->length / elementSize;
+    size_t count = length / elementSize;
     if (count > (size_t)INT_MAX)
     {
         return readError;
     }
 
-    if (fseek(file, lump->offset, SEEK_SET) != 0)
+    unsigned char *source = image->data + offset;
+    if (AAS_LUMPS_NATIVE_ORDER && ((uintptr_t)source % sizeof(int32_t)) == 0U)
     {
-        return seekError;
+        *outBuffer = source;
     }
-
-    void *buffer = malloc(count * elementSize);
-    if (buffer == NULL)
+    else
     {
-        return readError;
-    }
+        void *buffer = malloc(length);
+        if (buffer == NULL)
+        {
+            return readError;
+        }
 
-    size_t read = fread(buffer, elementSize, count, file);
-    if (read != count)
-    {
-        free(buffer);
-        return readError;
+        memcpy(buffer, source, length);
+        *outBuffer = buffer;
     }
 
-    *outBuffer = buffer;
     if (outCount != NULL)
     {
         *outCount = (int)count;
@@ -1072,85 +1252,394 @@ static int AAS_ReadLump(FILE *file,
     return BLERR_NOERROR;
 }
 
-static size_t AAS_AreaBitWordCount(void)
+static void AAS_ReleaseLump(const aas_fileimage_t *image, void *buffer)
 {
-    int numAreas = aasworld.numAreas;
-    if (numAreas < 0)
+    if (buffer != NULL && !AAS_FileImageContains(image, buffer))
     {
-        numAreas = 0;
+        free(buffer);
     }
+}
+
+/*
+ * Load-time area renumbering (areaorder 1).  BSPC numbers areas in
+ * compilation order, which scatters neighbouring areas across the area,
+ * settings and route cache arrays that searches and entity linking walk.
+ * Sorting the areas along a Morton curve over their centres keeps areas that
+ * are close in the world close in memory, and every area's reachabilities
+ * are regrouped to follow it.  The library runs on the new numbers from then
+ * on; AAS_AreaOriginalNum and AAS_AreaInternalNum translate where area
+ * numbers meet people, such as the debug commands.
+ */
+typedef struct
+{
+    uint32_t code;
+    int area;
+} aas_areaorder_key_t;
+
+static uint32_t AAS_MortonSpread(uint32_t value)
+{
+    value &= 0x3FFU;
+    value = (value | (value << 16)) & 0x030000FFU;
+    value = (value | (value << 8)) & 0x0300F00FU;
+    value = (value | (value << 4)) & 0x030C30C3U;
+    value = (value | (value << 2)) & 0x09249249U;
+    return value;
+}
 
-    size_t totalBits = (size_t)numAreas + 1U;
-    if (totalBits == 0U)
+static int AAS_CompareAreaOrderKeys(const void *left, const void *right)
+{
+    const aas_areaorder_key_t *a = (const aas_areaorder_key_t *)left;
+    const aas_areaorder_key_t *b = (const aas_areaorder_key_t *)right;
+    if (a->code != b->code)
     {
-        return 0U;
+        return (a->code < b->code) ? -1 : 1;
     }
-
-    return (totalBits + 31U) / 32U;
+    return a->area - b->area;
 }
 
-static void AAS_ClearWorld(void)
+static void AAS_AreaOrderKeys(aas_areaorder_key_t *keys, int numAreas)
 {
-    BotMove_MoverCatalogueReset();
-    AAS_RouteFrameResetDiagnostics();
-    AAS_ReachabilityFrameResetDiagnostics();
-    AAS_FreeAllRoutingCaches();
-    AAS_ClearReachabilityData();
+    vec3_t mins;
+    vec3_t maxs;
+    VectorCopy(aasworld.areas[1].center, mins);
+    VectorCopy(aasworld.areas[1].center, maxs);
+    for (int area = 2; area <= numAreas; ++area)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float value = aasworld.areas[area].center[axis];
+            mins[axis] = (value < mins[axis]) ? value : mins[axis];
+            maxs[axis] = (value > maxs[axis]) ? value : maxs[axis];
+        }
+    }
 
-    if (aasworld.entities != NULL)
+    for (int area = 1; area <= numAreas; ++area)
     {
-        for (int i = 0; i < aasworld.maxEntities; ++i)
+        uint32_t code = 0U;
+        for (int axis = 0; axis < 3; ++axis)
         {
-            AAS_UnlinkEntityFromAreas(&aasworld.entities[i]);
-            if (aasworld.entities[i].areaOccupancyBits != NULL)
+            float extent = maxs[axis] - mins[axis];
+            float scaled = 0.0f;
+            if (extent > 0.0f)
             {
-                free(aasworld.entities[i].areaOccupancyBits);
-                aasworld.entities[i].areaOccupancyBits = NULL;
-                aasworld.entities[i].areaOccupancyWords = 0U;
+                scaled = (aasworld.areas[area].center[axis] - mins[axis]) * 1023.0f / extent;
             }
-            aasworld.entities[i].areaOccupancyCount = 0;
+            code |= AAS_MortonSpread((uint32_t)scaled) << axis;
         }
-
-        free(aasworld.entities);
-        aasworld.entities = NULL;
+        keys[area - 1].code = code;
+        keys[area - 1].area = area;
     }
 
-    if (aasworld.areaEntityLists != NULL)
-    {
-        free(aasworld.areaEntityLists);
-        aasworld.areaEntityLists = NULL;
-        aasworld.areaEntityListCount = 0U;
-    }
+    qsort(keys, (size_t)numAreas, sizeof(keys[0]), AAS_CompareAreaOrderKeys);
+}
 
-    if (aasworld.areas != NULL)
+/* Marks the reachabilities owned by an area; false when two ranges overlap. */
+static bool AAS_MarkOwnedReachabilities(unsigned char *owned, int numAreas)
+{
+    for (int area = 1; area <= numAreas; ++area)
     {
-        free(aasworld.areas);
-        aasworld.areas = NULL;
+        const aas_areasettings_t *settings = &aasworld.areasettings[area];
+        if (settings->numreachableareas <= 0)
+        {
+            continue;
+        }
+        if (settings->firstreachablearea < 0
+            || settings->firstreachablearea > aasworld.numReachability - settings->numreachableareas)
+        {
+            return false;
+        }
+        for (int index = 0; index < settings->numreachableareas; ++index)
+        {
+            unsigned char *mark = &owned[settings->firstreachablearea + index];
+            if (*mark)
+            {
+                return false;
+            }
+            *mark = 1U;
+        }
     }
+    return true;
+}
 
-    if (aasworld.areasettings != NULL)
-    {
-        free(aasworld.areasettings);
-        aasworld.areasettings = NULL;
-    }
+static int AAS_RenumberedArea(const int *internalNum, int numAreas, int areanum)
+{
+    return (areanum > 0 && areanum <= numAreas) ? internalNum[areanum] : areanum;
+}
 
-    if (aasworld.reachability != NULL)
+void AAS_RenumberAreas(void)
+{
+    libvar_t *order = Bridge_AreaOrder();
+    int numAreas = aasworld.numAreas;
+    if (order == NULL || (int)order->value != 1 || aasworld.areaOriginalNum != NULL || numAreas < 2
+        || aasworld.areas == NULL || aasworld.areasettings == NULL)
     {
-        free(aasworld.reachability);
-        aasworld.reachability = NULL;
+        return;
     }
 
-    if (aasworld.nodes != NULL)
+    /* Every later loop walks numAreas, so both lumps must cover the same areas. */
+    if (aasworld.numAreaSettings != numAreas + 1)
     {
-        free(aasworld.nodes);
-        aasworld.nodes = NULL;
+        BotLib_Print(PRT_WARNING,
+                     "AAS_RenumberAreas: %d areas but %d area settings, keeping file order\n",
+                     numAreas,
+                     aasworld.numAreaSettings - 1);
+        return;
     }
 
-    AAS_SoundSubsystem_ClearMapAssets();
-    BotMove_MoverCatalogueReset();
-    memset(&aasworld, 0, sizeof(aasworld));
+    size_t count = (size_t)numAreas + 1U;
+    int numReachability = (aasworld.reachability != NULL && aasworld.numReachability > 0) ? aasworld.numReachability : 0;
+    int numNodes = (aasworld.nodes != NULL && aasworld.numNodes > 0) ? aasworld.numNodes : 0;
+    int numPortals = (aasworld.portals != NULL && aasworld.numPortals > 0) ? aasworld.numPortals : 0;
 
-    TranslateEntity_SetCurrentTime(0.0f);
+    aas_areaorder_key_t *keys = (aas_areaorder_key_t *)malloc((size_t)numAreas * sizeof(aas_areaorder_key_t));
+    int *originalNum = (int *)malloc(count * sizeof(int));
+    int *internalNum = (int *)malloc(count * sizeof(int));
+    aas_area_t *areas = (aas_area_t *)malloc(count * sizeof(aas_area_t));
+    aas_areasettings_t *settings = (aas_areasettings_t *)malloc(count * sizeof(aas_areasettings_t));
+    unsigned char *owned = (unsigned char *)calloc((size_t)numReachability + 1U, 1U);
+    aas_reachability_t *reachability =
+        (aas_reachability_t *)malloc(((size_t)numReachability + 1U) * sizeof(aas_reachability_t));
+    aas_node_t *nodes = (aas_node_t *)malloc(((size_t)numNodes + 1U) * sizeof(aas_node_t));
+    aas_portal_t *portals = (aas_portal_t *)malloc(((size_t)numPortals + 1U) * sizeof(aas_portal_t));
+
+    bool ok = keys != NULL && originalNum != NULL && internalNum != NULL && areas != NULL && settings != NULL
+              && owned != NULL && reachability != NULL && nodes != NULL && portals != NULL;
+    if (ok && !AAS_MarkOwnedReachabilities(owned, numAreas))
+    {
+        BotLib_Print(PRT_WARNING, "AAS_RenumberAreas: overlapping reachability ranges, keeping file order\n");
+        ok = false;
+    }
+    if (!ok)
+    {
+        free(keys);
+        free(originalNum);
+        free(internalNum);
+        free(areas);
+        free(settings);
+        free(owned);
+        free(reachability);
+        free(nodes);
+        free(portals);
+        return;
+    }
+
+    AAS_AreaOrderKeys(keys, numAreas);
+    originalNum[0] = 0;
+    internalNum[0] = 0;
+    for (int area = 1; area <= numAreas; ++area)
+    {
+        originalNum[area] = keys[area - 1].area;
+        internalNum[keys[area - 1].area] = area;
+    }
+    free(keys);
+
+    areas[0] = aasworld.areas[0];
+    settings[0] = aasworld.areasettings[0];
+    for (int area = 1; area <= numAreas; ++area)
+    {
+        areas[area] = aasworld.areas[originalNum[area]];
+        areas[area].areanum = area;
+        settings[area] = aasworld.areasettings[originalNum[area]];
+    }
+
+    /* Entries no area owns (the dummy at 0) keep their order in front. */
+    int next = 0;
+    for (int index = 0; index < numReachability; ++index)
+    {
+        if (!owned[index])
+        {
+            reachability[next++] = aasworld.reachability[index];
+        }
+    }
+    for (int area = 1; area <= numAreas; ++area)
+    {
+        int first = settings[area].firstreachablearea;
+        if (settings[area].numreachableareas <= 0)
+        {
+            continue;
+        }
+        settings[area].firstreachablearea = next;
+        for (int index = 0; index < settings[area].numreachableareas; ++index)
+        {
+            reachability[next++] = aasworld.reachability[first + index];
+        }
+    }
+    for (int index = 0; index < numReachability; ++index)
+    {
+        reachability[index].areanum = AAS_RenumberedArea(internalNum, numAreas, reachability[index].areanum);
+    }
+    free(owned);
+
+    for (int index = 0; index < numNodes; ++index)
+    {
+        nodes[index] = aasworld.nodes[index];
+        for (int side = 0; side < 2; ++side)
+        {
+            if (nodes[index].children[side] < 0)
+            {
+                nodes[index].children[side] =
+                    -AAS_RenumberedArea(internalNum, numAreas, -nodes[index].children[side]);
+            }
+        }
+    }
+
+    for (int index = 0; index < numPortals; ++index)
+    {
+        portals[index] = aasworld.portals[index];
+        portals[index].areanum = AAS_RenumberedArea(internalNum, numAreas, portals[index].areanum);
+    }
+
+    AAS_ReleaseLump(&g_aasFileImage, aasworld.areas);
+    AAS_ReleaseLump(&g_aasFileImage, aasworld.areasettings);
+    AAS_ReleaseLump(&g_aasFileImage, aasworld.reachability);
+    AAS_ReleaseLump(&g_aasFileImage, aasworld.nodes);
+    AAS_ReleaseLump(&g_aasFileImage, aasworld.portals);
+
+    aasworld.areas = areas;
+    aasworld.areasettings = settings;
+    aasworld.reachability = (numReachability > 0) ? reachability : NULL;
+    aasworld.nodes = (numNodes > 0) ? nodes : NULL;
+    aasworld.portals = (numPortals > 0) ? portals : NULL;
+    if (numReachability == 0)
+    {
+        free(reachability);
+    }
+    if (numNodes == 0)
+    {
+        free(nodes);
+    }
+    if (numPortals == 0)
+    {
+        free(portals);
+    }
+
+    aasworld.areaOrder = 1;
+    aasworld.areaOriginalNum = originalNum;
+    aasworld.areaInternalNum = internalNum;
+}
+
+/* File area number of an area; the identity unless areaorder renumbered them. */
+int AAS_AreaOriginalNum(int areanum)
+{
+    if (aasworld.areaOriginalNum == NULL || areanum <= 0 || areanum > aasworld.numAreas)
+    {
+        return areanum;
+    }
+    return aasworld.areaOriginalNum[areanum];
+}
+
+/* Area number the library uses for a file area number. */
+int AAS_AreaInternalNum(int areanum)
+{
+    if (aasworld.areaInternalNum == NULL || areanum <= 0 || areanum > aasworld.numAreas)
+    {
+        return areanum;
+    }
+    return aasworld.areaInternalNum[areanum];
+}
+
+static void AAS_ClearWorld(void)
+{
+    AAS_SaveRouteCache();
+    BotMove_MoverCatalogueReset();
+    AAS_RouteFrameResetDiagnostics();
+    AAS_RouteCacheResetDiagnostics();
+    AAS_ReachabilityFrameResetDiagnostics();
+    AAS_FreeAllRoutingCaches();
+    AAS_ShutdownRoutePrecompute();
+    AAS_FreeRouteMatrix();
+    AAS_ClearReachabilityData();
+
+    if (aasworld.entities != NULL)
+    {
+        for (int i = 0; i < aasworld.maxEntities; ++i)
+        {
+            AAS_UnlinkEntityFromAreas(&aasworld.entities[i]);
+        }
+
+        free(aasworld.entities);
+        aasworld.entities = NULL;
+    }
+
+    free(aasworld.frameEntities);
+    free(aasworld.lastFrameEntities);
+    aasworld.frameEntities = NULL;
+    aasworld.lastFrameEntities = NULL;
+    aasworld.numFrameEntities = 0;
+    aasworld.numLastFrameEntities = 0;
+
+    if (aasworld.areaEntityLists != NULL)
+    {
+        free(aasworld.areaEntityLists);
+        aasworld.areaEntityLists = NULL;
+        aasworld.areaEntityListCount = 0U;
+    }
+    free(aasworld.areaEntityCounts);
+    aasworld.areaEntityCounts = NULL;
+
+    AAS_FreeAASLinkHeap();
+    AAS_FreeBSPCollision();
+
+    if (aasworld.areas != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.areas);
+        aasworld.areas = NULL;
+    }
+
+    if (aasworld.areasettings != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.areasettings);
+        aasworld.areasettings = NULL;
+    }
+
+    if (aasworld.reachability != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.reachability);
+        aasworld.reachability = NULL;
+    }
+
+    if (aasworld.nodes != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.nodes);
+        aasworld.nodes = NULL;
+    }
+
+    if (aasworld.planes != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.planes);
+        aasworld.planes = NULL;
+    }
+
+    if (aasworld.portals != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.portals);
+        aasworld.portals = NULL;
+    }
+
+    if (aasworld.portalIndex != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.portalIndex);
+        aasworld.portalIndex = NULL;
+    }
+
+    if (aasworld.clusters != NULL)
+    {
+        AAS_ReleaseLump(&g_aasFileImage, aasworld.clusters);
+        aasworld.clusters = NULL;
+    }
+
+    free(aasworld.areaOriginalNum);
+    free(aasworld.areaInternalNum);
+    aasworld.areaOriginalNum = NULL;
+    aasworld.areaInternalNum = NULL;
+
+    AAS_CloseFileImage(&g_aasFileImage);
+
+    AAS_SoundSubsystem_ClearMapAssets();
+    BotMove_MoverCatalogueReset();
+    memset(&aasworld, 0, sizeof(aasworld));
+
+    TranslateEntity_SetCurrentTime(0.0f);
     TranslateEntity_SetWorldLoaded(qfalse);
 }
 
@@ -1192,21 +1681,22 @@ int AAS_LoadMap(const char *mapname,
         return BLERR_NOAASFILE;
     }
 
-    FILE *bspFile = fopen(bspPath, "rb");
-    if (bspFile == NULL)
+    aas_fileimage_t bspImage;
+    if (!AAS_OpenFileImage(bspPath, &bspImage))
     {
         BotLib_Print(PRT_ERROR, "AAS_LoadMap: cannot open BSP %s (%s)\n", bspPath, strerror(errno));
         return BLERR_CANNOTOPENBSPFILE;
     }
 
     q2_bsp_header_t bspHeader;
-    if (fread(&bspHeader, sizeof(bspHeader), 1U, bspFile) != 1U)
+    if (bspImage.size < sizeof(bspHeader))
     {
         BotLib_Print(PRT_ERROR, "AAS_LoadMap: failed to read BSP header from %s\n", bspPath);
-        fclose(bspFile);
+        AAS_CloseFileImage(&bspImage);
         return BLERR_CANNOTREADBSPHEADER;
     }
 
+    memcpy(&bspHeader, bspImage.data, sizeof(bspHeader));
     bspHeader.ident = AAS_LittleLong(bspHeader.ident);
     bspHeader.version = AAS_LittleLong(bspHeader.version);
     for (int index = 0; index < Q2_BSP_LUMP_MAX; ++index)
@@ -1218,7 +1708,7 @@ int AAS_LoadMap(const char *mapname,
     if (bspHeader.ident != Q2_BSP_IDENT)
     {
         BotLib_Print(PRT_ERROR, "AAS_LoadMap: %s is not a Quake II BSP\n", bspPath);
-        fclose(bspFile);
+        AAS_CloseFileImage(&bspImage);
         return BLERR_WRONGBSPFILEID;
     }
 
@@ -1229,7 +1719,7 @@ int AAS_LoadMap(const char *mapname,
                      bspPath,
                      bspHeader.version,
                      Q2_BSP_VERSION);
-        fclose(bspFile);
+        AAS_CloseFileImage(&bspImage);
         return BLERR_WRONGBSPFILEVERSION;
     }
 
@@ -1243,6 +1733,8 @@ int AAS_LoadMap(const char *mapname,
     }
     else if (entitiesLump->length > 0)
     {
+        size_t lumpOffset = (size_t)entitiesLump->offset;
+        size_t lumpLength = (size_t)entitiesLump->length;
         if (entitiesLump->offset < 0)
         {
             BotLib_Print(PRT_WARNING,
@@ -1250,16 +1742,15 @@ int AAS_LoadMap(const char *mapname,
                          bspPath,
                          entitiesLump->offset);
         }
-        else if (fseek(bspFile, entitiesLump->offset, SEEK_SET) != 0)
+        else if (lumpOffset > bspImage.size || lumpLength > bspImage.size - lumpOffset)
         {
             BotLib_Print(PRT_WARNING,
-                         "AAS_LoadMap: failed to seek to entity lump in %s (%s)\n",
-                         bspPath,
-                         strerror(errno));
+                         "AAS_LoadMap: failed to read entity lump from %s\n",
+                         bspPath);
         }
         else
         {
-            size_t lumpLength = (size_t)entitiesLump->length;
+            /* The parser wants a terminated string, so this lump is copied. */
             char *entityData = (char *)malloc(lumpLength + 1U);
             if (entityData == NULL)
             {
@@ -1269,47 +1760,35 @@ int AAS_LoadMap(const char *mapname,
             }
             else
             {
-                size_t readLength = fread(entityData, 1U, lumpLength, bspFile);
-                if (readLength != lumpLength)
-                {
-                    BotLib_Print(PRT_WARNING,
-                                 "AAS_LoadMap: failed to read entity lump from %s\n",
-                                 bspPath);
-                }
-                else
-                {
-                    entityData[lumpLength] = '\0';
-                    AAS_ParseEntityLump(entityData, lumpLength);
-                }
+                memcpy(entityData, bspImage.data + lumpOffset, lumpLength);
+                entityData[lumpLength] = '\0';
+                AAS_ParseEntityLump(entityData, lumpLength);
                 free(entityData);
             }
         }
     }
 
-    fclose(bspFile);
+    /* Native traces are optional; a map without usable lumps still loads. */
+    AAS_LoadBSPCollision(bspImage.data, bspImage.size, bspHeader.lumps);
 
-    uint32_t bspChecksum = 0U;
-    if (!AAS_ComputeFileChecksum(bspPath, &bspChecksum))
-    {
-        BotLib_Print(PRT_ERROR, "AAS_LoadMap: failed to compute BSP checksum for %s\n", bspPath);
-        return BLERR_CANNOTREADBSPHEADER;
-    }
+    uint32_t bspChecksum = AAS_CRC32Update(0U, bspImage.data, bspImage.size);
+    AAS_CloseFileImage(&bspImage);
 
-    FILE *aasFile = fopen(aasPath, "rb");
-    if (aasFile == NULL)
+    if (!AAS_OpenFileImage(aasPath, &g_aasFileImage))
     {
         BotLib_Print(PRT_ERROR, "AAS_LoadMap: cannot open AAS %s (%s)\n", aasPath, strerror(errno));
         return BLERR_CANNOTOPENAASFILE;
     }
 
     q2_aas_header_t aasHeader;
-    if (fread(&aasHeader, sizeof(aasHeader), 1U, aasFile) != 1U)
+    if (g_aasFileImage.size < sizeof(aasHeader))
     {
         BotLib_Print(PRT_ERROR, "AAS_LoadMap: failed to read AAS header from %s\n", aasPath);
-        fclose(aasFile);
+        AAS_CloseFileImage(&g_aasFileImage);
         return BLERR_CANNOTREADAASHEADER;
     }
 
+    memcpy(&aasHeader, g_aasFileImage.data, sizeof(aasHeader));
     aasHeader.ident = AAS_LittleLong(aasHeader.ident);
     aasHeader.version = AAS_LittleLong(aasHeader.version);
     for (int index = 0; index < Q2_AAS_LUMP_MAX; ++index)
@@ -1321,7 +1800,7 @@ int AAS_LoadMap(const char *mapname,
     if (aasHeader.ident != Q2_AAS_IDENT)
     {
         BotLib_Print(PRT_ERROR, "AAS_LoadMap: %s is not an AAS file\n", aasPath);
-        fclose(aasFile);
+        AAS_CloseFileImage(&g_aasFileImage);
         return BLERR_WRONGAASFILEID;
     }
 
@@ -1336,106 +1815,78 @@ int AAS_LoadMap(const char *mapname,
                      aasPath,
                      aasHeader.version,
                      Q2_AAS_VERSION);
-        fclose(aasFile);
+        AAS_CloseFileImage(&g_aasFileImage);
         return BLERR_WRONGAASFILEVERSION;
     }
 
-    long aasFileSize = AAS_GetFileSize(aasFile);
-    if (aasFileSize < 0)
-    {
-        BotLib_Print(PRT_ERROR, "AAS_LoadMap: failed to determine size of %s\n", aasPath);
-        fclose(aasFile);
-        return BLERR_CANNOTREADAASHEADER;
-    }
-
     aas_area_t *areas = NULL;
     int numAreas = 0;
-    int result = AAS_ReadLump(aasFile,
-                              &aasHeader.lumps[Q2_AAS_LUMP_AREAS],
-                              sizeof(aas_area_t),
-                              (void **)&areas,
-                              &numAreas,
-                              aasFileSize,
-                              BLERR_CANNOTSEEKTOAASFILE,
-                              BLERR_CANNOTREADAASLUMP);
-    if (result != BLERR_NOERROR)
-    {
-        fclose(aasFile);
-        return result;
-    }
-
     aas_areasettings_t *areasettings = NULL;
     int numAreaSettings = 0;
-    result = AAS_ReadLump(aasFile,
-                          &aasHeader.lumps[Q2_AAS_LUMP_AREASETTINGS],
-                          sizeof(aas_areasettings_t),
-                          (void **)&areasettings,
-                          &numAreaSettings,
-                          aasFileSize,
-                          BLERR_CANNOTSEEKTOAASFILE,
-                          BLERR_CANNOTREADAASLUMP);
-    if (result != BLERR_NOERROR)
-    {
-        free(areas);
-        fclose(aasFile);
-        return result;
-    }
-
     aas_reachability_t *reachability = NULL;
     int numReachability = 0;
-    result = AAS_ReadLump(aasFile,
-                          &aasHeader.lumps[Q2_AAS_LUMP_REACHABILITY],
-                          sizeof(aas_reachability_t),
-                          (void **)&reachability,
-                          &numReachability,
-                          aasFileSize,
-                          BLERR_CANNOTSEEKTOAASFILE,
-                          BLERR_CANNOTREADAASLUMP);
-    if (result != BLERR_NOERROR)
-    {
-        free(areas);
-        free(areasettings);
-        fclose(aasFile);
-        return result;
-    }
-
     aas_node_t *nodes = NULL;
     int numNodes = 0;
-    result = AAS_ReadLump(aasFile,
-                          &aasHeader.lumps[Q2_AAS_LUMP_NODES],
-                          sizeof(aas_node_t),
-                          (void **)&nodes,
-                          &numNodes,
-                          aasFileSize,
-                          BLERR_CANNOTSEEKTOAASFILE,
-                          BLERR_CANNOTREADAASLUMP);
-    if (result != BLERR_NOERROR)
+    aas_portal_t *portals = NULL;
+    int numPortals = 0;
+    aas_portalindex_t *portalIndex = NULL;
+    int numPortalIndex = 0;
+    aas_cluster_t *clusters = NULL;
+    int numClusters = 0;
+    aas_plane_t *planes = NULL;
+    int numPlanes = 0;
+
+    struct
+    {
+        int lump;
+        size_t elementSize;
+        void **buffer;
+        int *count;
+    } lumpViews[] = {
+        {Q2_AAS_LUMP_AREAS, sizeof(aas_area_t), (void **)&areas, &numAreas},
+        {Q2_AAS_LUMP_AREASETTINGS, sizeof(aas_areasettings_t), (void **)&areasettings, &numAreaSettings},
+        {Q2_AAS_LUMP_REACHABILITY, sizeof(aas_reachability_t), (void **)&reachability, &numReachability},
+        {Q2_AAS_LUMP_NODES, sizeof(aas_node_t), (void **)&nodes, &numNodes},
+        {Q2_AAS_LUMP_PORTALS, sizeof(aas_portal_t), (void **)&portals, &numPortals},
+        {Q2_AAS_LUMP_PORTALINDEX, sizeof(aas_portalindex_t), (void **)&portalIndex, &numPortalIndex},
+        {Q2_AAS_LUMP_CLUSTERS, sizeof(aas_cluster_t), (void **)&clusters, &numClusters},
+        {Q2_AAS_LUMP_PLANES, sizeof(aas_plane_t), (void **)&planes, &numPlanes},
+    };
+    size_t numLumpViews = sizeof(lumpViews) / sizeof(lumpViews[0]);
+
+    for (size_t view = 0; view < numLumpViews; ++view)
     {
-        free(areas);
-        free(areasettings);
-        free(reachability);
-        fclose(aasFile);
-        return result;
+        int result = AAS_LumpView(&g_aasFileImage,
+                                  &aasHeader.lumps[lumpViews[view].lump],
+                                  lumpViews[view].elementSize,
+                                  lumpViews[view].buffer,
+                                  lumpViews[view].count,
+                                  BLERR_CANNOTREADAASLUMP);
+        if (result != BLERR_NOERROR)
+        {
+            for (size_t loaded = 0; loaded < view; ++loaded)
+            {
+                AAS_ReleaseLump(&g_aasFileImage, *lumpViews[loaded].buffer);
+            }
+            AAS_CloseFileImage(&g_aasFileImage);
+            return result;
+        }
     }
 
-    fclose(aasFile);
-
-    AAS_FixupAreas(areas, numAreas);
-    AAS_FixupAreaSettings(areasettings, numAreaSettings);
-    AAS_FixupReachability(reachability, numReachability);
-    AAS_FixupNodes(nodes, numNodes);
-
-    uint32_t aasChecksum = 0U;
-    if (!AAS_ComputeFileChecksum(aasPath, &aasChecksum))
+    if (!AAS_LUMPS_NATIVE_ORDER)
     {
-        BotLib_Print(PRT_ERROR, "AAS_LoadMap: failed to compute checksum for %s\n", aasPath);
-        free(areas);
-        free(areasettings);
-        free(reachability);
-        free(nodes);
-        return BLERR_CANNOTREADAASHEADER;
+        AAS_FixupAreas(areas, numAreas);
+        AAS_FixupAreaSettings(areasettings, numAreaSettings);
+        AAS_FixupReachability(reachability, numReachability);
+        AAS_FixupNodes(nodes, numNodes);
+        AAS_FixupPlanes(planes, numPlanes);
+        AAS_FixupPortals(portals, numPortals);
+        AAS_FixupPortalIndex(portalIndex, numPortalIndex);
+        AAS_FixupClusters(clusters, numClusters);
     }
 
+    uint32_t aasChecksum = AAS_CRC32Update(0U, g_aasFileImage.data, g_aasFileImage.size);
+
     strncpy(aasworld.aasFilePath, aasPath, sizeof(aasworld.aasFilePath) - 1U);
     aasworld.aasFilePath[sizeof(aasworld.aasFilePath) - 1U] = '\0';
 
@@ -1449,6 +1900,14 @@ int AAS_LoadMap(const char *mapname,
     aasworld.areasettings = areasettings;
     aasworld.numNodes = numNodes;
     aasworld.nodes = nodes;
+    aasworld.numPlanes = numPlanes;
+    aasworld.planes = planes;
+    aasworld.numPortals = numPortals;
+    aasworld.portals = portals;
+    aasworld.numPortalIndex = numPortalIndex;
+    aasworld.portalIndex = portalIndex;
+    aasworld.numClusters = numClusters;
+    aasworld.clusters = clusters;
     aasworld.maxEntities = 0;
     aasworld.entities = NULL;
     aasworld.entitiesValid = qfalse;
@@ -1465,6 +1924,7 @@ int AAS_LoadMap(const char *mapname,
         return BLERR_INVALIDIMPORT;
     }
 
+    AAS_RenumberAreas();
     AAS_InitTravelFlagFromType();
     int reachStatus = AAS_PrepareReachability();
     if (reachStatus != BLERR_NOERROR)
@@ -1473,6 +1933,8 @@ int AAS_LoadMap(const char *mapname,
         return reachStatus;
     }
 
+    AAS_InitClusterRouting();
+
     int areaStatus = AAS_EnsureAreaListArray();
     if (areaStatus != BLERR_NOERROR)
     {
@@ -1480,7 +1942,21 @@ int AAS_LoadMap(const char *mapname,
         return areaStatus;
     }
 
+    /* Size the entity table for the whole map now rather than during the first frames. */
+    int entityLimit = Bridge_EntityLimit();
+    if (entityLimit > 0)
+    {
+        int entityStatus = AAS_EnsureEntityCapacity(entityLimit - 1);
+        if (entityStatus != BLERR_NOERROR)
+        {
+            AAS_ClearWorld();
+            return entityStatus;
+        }
+    }
+
     AAS_InvalidateRouteCache();
+    (void)AAS_ReadRouteCache();
+    (void)AAS_InitRouteMatrix();
 
     AAS_FrameSynchronise(0.0f);
     TranslateEntity_SetWorldLoaded(qtrue);
@@ -1512,94 +1988,55 @@ static int AAS_EnsureEntityCapacity(int ent)
         return BLERR_NOERROR;
     }
 
+    /* Grow geometrically so entities arriving one at a time do not realloc each time. */
     size_t previousCount = (size_t)aasworld.maxEntities;
-    size_t requiredCount = (size_t)ent + 1U;
-    size_t newSize = requiredCount * sizeof(aas_entity_t);
-
-    aas_entity_t *resized = realloc(aasworld.entities, newSize);
-    if (resized == NULL)
+    size_t requiredCount = (previousCount > 0U) ? previousCount * 2U : AAS_MIN_ENTITY_CAPACITY;
+    while (requiredCount < (size_t)ent + 1U)
     {
-        return BLERR_INVALIDENTITYNUMBER;
+        requiredCount *= 2U;
     }
-
-    /* zero initialise the new tail */
-    if (requiredCount > previousCount)
+    if (requiredCount > (size_t)INT_MAX)
     {
-        size_t delta = requiredCount - previousCount;
-        memset(resized + previousCount, 0, delta * sizeof(aas_entity_t));
+        requiredCount = (size_t)ent + 1U;
     }
 
-    aasworld.entities = resized;
-    aasworld.maxEntities = (int)requiredCount;
-    return BLERR_NOERROR;
-}
-
-static void AAS_ResetEntityBitset(aas_entity_t *entity)
-{
-    if (entity->areaOccupancyBits != NULL && entity->areaOccupancyWords > 0U)
+    /* the frame lists hold each entity at most once, so they never outgrow the table */
+    int *frameList = realloc(aasworld.frameEntities, requiredCount * sizeof(int));
+    if (frameList == NULL)
     {
-        memset(entity->areaOccupancyBits, 0, entity->areaOccupancyWords * sizeof(unsigned int));
+        return BLERR_INVALIDENTITYNUMBER;
     }
+    aasworld.frameEntities = frameList;
 
-    entity->areaOccupancyCount = 0;
-}
-
-static int AAS_PrepareEntityBitset(aas_entity_t *entity)
-{
-    size_t requiredWords = AAS_AreaBitWordCount();
-    if (requiredWords == 0U)
+    int *lastFrameList = realloc(aasworld.lastFrameEntities, requiredCount * sizeof(int));
+    if (lastFrameList == NULL)
     {
-        if (entity->areaOccupancyBits != NULL)
-        {
-            free(entity->areaOccupancyBits);
-            entity->areaOccupancyBits = NULL;
-        }
+        return BLERR_INVALIDENTITYNUMBER;
+    }
+    aasworld.lastFrameEntities = lastFrameList;
 
-        entity->areaOccupancyWords = 0U;
-        AAS_ResetEntityBitset(entity);
-        return BLERR_NOERROR;
+    aas_entity_t *resized = realloc(aasworld.entities, requiredCount * sizeof(aas_entity_t));
+    if (resized == NULL)
+    {
+        return BLERR_INVALIDENTITYNUMBER;
     }
 
-    if (entity->areaOccupancyWords != requiredWords)
+    /* zero initialise the new tail */
+    if (requiredCount > previousCount)
     {
-        unsigned int *bits = (unsigned int *)realloc(entity->areaOccupancyBits,
-                                                     requiredWords * sizeof(unsigned int));
-        if (bits == NULL)
+        size_t delta = requiredCount - previousCount;
+        memset(resized + previousCount, 0, delta * sizeof(aas_entity_t));
+        for (size_t index = previousCount; index < requiredCount; ++index)
         {
-            return BLERR_INVALIDENTITYNUMBER;
+            resized[index].number = (int)index;
         }
-
-        entity->areaOccupancyBits = bits;
-        entity->areaOccupancyWords = requiredWords;
     }
 
-    memset(entity->areaOccupancyBits, 0, requiredWords * sizeof(unsigned int));
-    entity->areaOccupancyCount = 0;
+    aasworld.entities = resized;
+    aasworld.maxEntities = (int)requiredCount;
     return BLERR_NOERROR;
 }
 
-static void AAS_SetEntityAreaBit(aas_entity_t *entity, int areanum)
-{
-    if (entity->areaOccupancyBits == NULL || entity->areaOccupancyWords == 0U)
-    {
-        return;
-    }
-
-    if (areanum < 0)
-    {
-        return;
-    }
-
-    size_t bitIndex = (size_t)areanum;
-    size_t wordIndex = bitIndex / 32U;
-    size_t bitOffset = bitIndex % 32U;
-
-    if (wordIndex < entity->areaOccupancyWords)
-    {
-        entity->areaOccupancyBits[wordIndex] |= (1U << bitOffset);
-    }
-}
-
 static int AAS_EnsureAreaListArray(void)
 {
     size_t desired = (size_t)aasworld.numAreas + 1U;
@@ -1608,21 +2045,24 @@ static int AAS_EnsureAreaListArray(void)
         desired = 1U;
     }
 
-    if (aasworld.areaEntityLists != NULL && aasworld.areaEntityListCount == desired)
+    if (aasworld.areaEntityLists != NULL && aasworld.areaEntityCounts != NULL
+        && aasworld.areaEntityListCount == desired)
     {
         return BLERR_NOERROR;
     }
 
-    if (aasworld.areaEntityLists != NULL)
-    {
-        free(aasworld.areaEntityLists);
-        aasworld.areaEntityLists = NULL;
-        aasworld.areaEntityListCount = 0U;
-    }
+    free(aasworld.areaEntityLists);
+    free(aasworld.areaEntityCounts);
+    aasworld.areaEntityListCount = 0U;
 
     aasworld.areaEntityLists = (aas_link_t **)calloc(desired, sizeof(aas_link_t *));
-    if (aasworld.areaEntityLists == NULL)
+    aasworld.areaEntityCounts = (int *)calloc(desired, sizeof(int));
+    if (aasworld.areaEntityLists == NULL || aasworld.areaEntityCounts == NULL)
     {
+        free(aasworld.areaEntityLists);
+        free(aasworld.areaEntityCounts);
+        aasworld.areaEntityLists = NULL;
+        aasworld.areaEntityCounts = NULL;
         return BLERR_INVALIDENTITYNUMBER;
     }
 
@@ -1662,9 +2102,14 @@ static void AAS_RemoveLinkFromAreaList(aas_link_t *link)
     {
         link->next_ent->prev_ent = link->prev_ent;
     }
+
+    if (aasworld.areaEntityCounts != NULL)
+    {
+        aasworld.areaEntityCounts[index] -= 1;
+    }
 }
 
-static void AAS_UnlinkEntityFromAreas(aas_entity_t *entity)
+void AAS_UnlinkEntityFromAreas(aas_entity_t *entity)
 {
     if (entity == NULL)
     {
@@ -1676,11 +2121,54 @@ static void AAS_UnlinkEntityFromAreas(aas_entity_t *entity)
     {
         aas_link_t *next = link->next_area;
         AAS_RemoveLinkFromAreaList(link);
-        free(link);
+        AAS_DeAllocAASLink(link);
         link = next;
     }
 
     entity->areas = NULL;
+    entity->areaOccupancyCount = 0;
+}
+
+/* O(1) while the entity spans at most AAS_ENTITY_AREA_SLOTS areas. */
+qboolean AAS_EntityInArea(int entnum, int areanum)
+{
+    if (aasworld.entities == NULL || entnum < 0 || entnum >= aasworld.maxEntities)
+    {
+        return qfalse;
+    }
+
+    const aas_entity_t *entity = &aasworld.entities[entnum];
+    if (entity->areaOccupancyCount <= AAS_ENTITY_AREA_SLOTS)
+    {
+        for (int index = 0; index < entity->areaOccupancyCount; ++index)
+        {
+            if (entity->areaList[index] == areanum)
+            {
+                return qtrue;
+            }
+        }
+        return qfalse;
+    }
+
+    for (const aas_link_t *link = entity->areas; link != NULL; link = link->next_area)
+    {
+        if (link->areanum == areanum)
+        {
+            return qtrue;
+        }
+    }
+    return qfalse;
+}
+
+/* Number of entities linked to an area; aasworld.areaEntityLists names them. */
+int AAS_AreaEntityCount(int areanum)
+{
+    if (aasworld.areaEntityCounts == NULL || areanum < 0 || (size_t)areanum >= aasworld.areaEntityListCount)
+    {
+        return 0;
+    }
+
+    return aasworld.areaEntityCounts[areanum];
 }
 
 static int AAS_LinkEntityToArea(aas_entity_t *entity, int areanum)
@@ -1690,13 +2178,13 @@ static int AAS_LinkEntityToArea(aas_entity_t *entity, int areanum)
         return BLERR_INVALIDENTITYNUMBER;
     }
 
-    if (aasworld.areaEntityLists == NULL ||
+    if (aasworld.areaEntityLists == NULL || aasworld.areaEntityCounts == NULL ||
         (size_t)areanum >= aasworld.areaEntityListCount)
     {
         return BLERR_INVALIDENTITYNUMBER;
     }
 
-    aas_link_t *link = (aas_link_t *)malloc(sizeof(aas_link_t));
+    aas_link_t *link = AAS_AllocAASLink();
     if (link == NULL)
     {
         return BLERR_INVALIDENTITYNUMBER;
@@ -1720,6 +2208,13 @@ static int AAS_LinkEntityToArea(aas_entity_t *entity, int areanum)
         link->next_ent->prev_ent = link;
     }
     aasworld.areaEntityLists[areanum] = link;
+    aasworld.areaEntityCounts[areanum] += 1;
+
+    if (entity->areaOccupancyCount < AAS_ENTITY_AREA_SLOTS)
+    {
+        entity->areaList[entity->areaOccupancyCount] = areanum;
+    }
+    entity->areaOccupancyCount += 1;
 
     return BLERR_NOERROR;
 }
@@ -1755,6 +2250,101 @@ static void AAS_ClampMinsMaxs(vec3_t mins, vec3_t maxs)
     }
 }
 
+/*
+ * A relink starts from no links and pushes every new one onto the front of
+ * its area list, so an area this pass already linked has the entity at the
+ * head.  That keeps the tree walk's repeated leaves an O(1) check.
+ */
+static qboolean AAS_EntityLinkedThisPass(const aas_entity_t *entity, int areanum)
+{
+    const aas_link_t *head = aasworld.areaEntityLists[areanum];
+    return (head != NULL && head->entnum == entity->number) ? qtrue : qfalse;
+}
+
+static int AAS_LinkEntityToBoxArea(aas_entity_t *entity, const vec3_t absmins, const vec3_t absmaxs, int areanum)
+{
+    if (AAS_EntityLinkedThisPass(entity, areanum)
+        || !AAS_BoxIntersectsArea(absmins, absmaxs, &aasworld.areas[areanum]))
+    {
+        return BLERR_NOERROR;
+    }
+
+    return AAS_LinkEntityToArea(entity, areanum);
+}
+
+static int AAS_LinkEntityToBoundsAreas(aas_entity_t *entity, const vec3_t absmins, const vec3_t absmaxs)
+{
+    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
+    {
+        int status = AAS_LinkEntityToBoxArea(entity, absmins, absmaxs, areanum);
+        if (status != BLERR_NOERROR)
+        {
+            return status;
+        }
+    }
+
+    return BLERR_NOERROR;
+}
+
+/* Mirrors AAS_AASLinkEntity: push the box down every side of the tree it spans. */
+static int AAS_LinkEntityToTreeAreas(aas_entity_t *entity, const vec3_t absmins, const vec3_t absmaxs)
+{
+    int stack[AAS_LINK_STACK_SIZE];
+    int depth = 0;
+    stack[depth++] = 1;
+
+    while (depth > 0)
+    {
+        int nodenum = stack[--depth];
+        if (nodenum < 0)
+        {
+            int areanum = -nodenum;
+            if (areanum > aasworld.numAreas)
+            {
+                continue;
+            }
+
+            int status = AAS_LinkEntityToBoxArea(entity, absmins, absmaxs, areanum);
+            if (status != BLERR_NOERROR)
+            {
+                return status;
+            }
+            continue;
+        }
+
+        if (nodenum == 0 || nodenum >= aasworld.numNodes)
+        {
+            continue;
+        }
+
+        const aas_node_t *node = &aasworld.nodes[nodenum];
+        if (node->planenum < 0 || node->planenum >= aasworld.numPlanes)
+        {
+            continue;
+        }
+
+        if (depth + 2 > AAS_LINK_STACK_SIZE)
+        {
+            BotLib_Print(PRT_WARNING,
+                         "AAS_LinkEntity: stack overflow linking entity %d\n",
+                         entity->number);
+            break;
+        }
+
+        int side = AAS_BoxOnPlaneSide2(absmins, absmaxs, &aasworld.planes[node->planenum]);
+        if (side & 1)
+        {
+            stack[depth++] = node->children[0];
+        }
+        if (side & 2)
+        {
+            stack[depth++] = node->children[1];
+        }
+    }
+
+    return BLERR_NOERROR;
+}
+
 static int AAS_LinkEntityToComputedAreas(aas_entity_t *entity, const vec3_t absmins, const vec3_t absmaxs)
 {
     if (entity == NULL)
@@ -1764,48 +2354,33 @@ static int AAS_LinkEntityToComputedAreas(aas_entity_t *entity, const vec3_t absm
 
     AAS_UnlinkEntityFromAreas(entity);
 
-    int status = AAS_PrepareEntityBitset(entity);
-    if (status != BLERR_NOERROR)
-    {
-        return status;
-    }
-
     if (aasworld.areas == NULL || aasworld.numAreas <= 0)
     {
         entity->outsideAllAreas = qtrue;
         entity->lastOutsideUpdate = aasworld.time;
-        entity->areaOccupancyCount = 0;
         return BLERR_NOERROR;
     }
 
-    status = AAS_EnsureAreaListArray();
+    int status = AAS_EnsureAreaListArray();
     if (status != BLERR_NOERROR)
     {
         return status;
     }
 
-    int occupied = 0;
-    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
+    if (AAS_NodeTreeValid())
     {
-        const aas_area_t *area = &aasworld.areas[areanum];
-        if (!AAS_BoxIntersectsArea(absmins, absmaxs, area))
-        {
-            continue;
-        }
-
-        status = AAS_LinkEntityToArea(entity, areanum);
-        if (status != BLERR_NOERROR)
-        {
-            return status;
-        }
-
-        AAS_SetEntityAreaBit(entity, areanum);
-        ++occupied;
+        status = AAS_LinkEntityToTreeAreas(entity, absmins, absmaxs);
+    }
+    else
+    {
+        status = AAS_LinkEntityToBoundsAreas(entity, absmins, absmaxs);
+    }
+    if (status != BLERR_NOERROR)
+    {
+        return status;
     }
 
-    entity->areaOccupancyCount = occupied;
-
-    if (occupied == 0)
+    if (entity->areaOccupancyCount == 0)
     {
         entity->outsideAllAreas = qtrue;
         entity->lastOutsideUpdate = aasworld.time;
@@ -1841,7 +2416,6 @@ int AAS_UpdateEntity(int ent, const AASEntityFrame *state)
     if (state == NULL)
     {
         AAS_UnlinkEntityFromAreas(entity);
-        AAS_ResetEntityBitset(entity);
         entity->inuse = qfalse;
         entity->outsideAllAreas = qtrue;
         entity->lastOutsideUpdate = aasworld.time;
@@ -1850,6 +2424,12 @@ int AAS_UpdateEntity(int ent, const AASEntityFrame *state)
         return BLERR_NOERROR;
     }
 
+    if (!entity->frameListed && aasworld.frameEntities != NULL)
+    {
+        entity->frameListed = qtrue;
+        aasworld.frameEntities[aasworld.numFrameEntities++] = ent;
+    }
+
     entity->inuse = qtrue;
     entity->solid = state->solid;
     entity->modelindex = state->modelindex;
@@ -1895,7 +2475,7 @@ int AAS_UpdateEntity(int ent, const AASEntityFrame *state)
         float dz = fabsf(state->origin[2] - state->previous_origin[2]);
         if (dx > 0.125f || dy > 0.125f || dz > 0.125f)
         {
-            AAS_InvalidateRouteCache();
+            AAS_InvalidateModelRouteCaches(entity->modelindex);
         }
     }
 
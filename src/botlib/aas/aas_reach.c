@@ -18,29 +18,129 @@ typedef struct
 
 static aas_reachability_frame_state_t g_reach_frame_state;
 
-static void AAS_FreeReverseReachability(void)
+void AAS_ClearReachabilityData(void)
+{
+    free(aasworld.reverseEdgeOffsets);
+    free(aasworld.reverseEdges);
+    free(aasworld.reachabilityFromArea);
+    free(aasworld.moverModels);
+    aasworld.reverseEdgeOffsets = NULL;
+    aasworld.reverseEdges = NULL;
+    aasworld.numReverseEdges = 0;
+    aasworld.maxReverseEdgeCost = 0;
+    aasworld.reachabilityTravelFlags = 0;
+    aasworld.reachabilityFromArea = NULL;
+    aasworld.moverModels = NULL;
+    aasworld.numMoverModels = 0;
+}
+
+/* Model number an elevator or func_bob reachability rides, 0 for other travel types. */
+static int AAS_ReachabilityMoverModel(const aas_reachability_t *reach)
 {
-    if (aasworld.reversedReachability != NULL)
+    int traveltype = reach->traveltype & TRAVELTYPE_MASK;
+    if (traveltype != TRAVEL_ELEVATOR && traveltype != TRAVEL_FUNCBOB)
+    {
+        return 0;
+    }
+    return reach->facenum & 0x0000FFFF;
+}
+
+static int AAS_CompareModelNumbers(const void *left, const void *right)
+{
+    int a = *(const int *)left;
+    int b = *(const int *)right;
+    return (a > b) - (a < b);
+}
+
+/*
+ * Collects the distinct mover models of the reachabilities.  Their position
+ * in the sorted list is their bit in the route cache mover masks, so each
+ * mover has a bit of its own unless the map has more than 64 of them.
+ */
+static bool AAS_CollectMoverModels(void)
+{
+    int numReach = aasworld.numReachability;
+    int *models = (int *)malloc((size_t)numReach * sizeof(int));
+    if (models == NULL)
     {
-        int areaCount = (aasworld.numAreas > 0) ? aasworld.numAreas : 0;
-        for (int area = 0; area <= areaCount; ++area)
+        return false;
+    }
+
+    int count = 0;
+    for (int index = 0; index < numReach; ++index)
+    {
+        int model = AAS_ReachabilityMoverModel(&aasworld.reachability[index]);
+        if (model > 0)
+        {
+            models[count++] = model;
+        }
+    }
+
+    if (count == 0)
+    {
+        free(models);
+        return true;
+    }
+
+    qsort(models, (size_t)count, sizeof(int), AAS_CompareModelNumbers);
+    int unique = 1;
+    for (int index = 1; index < count; ++index)
+    {
+        if (models[index] != models[unique - 1])
         {
-            free(aasworld.reversedReachability[area].reachIndexes);
-            aasworld.reversedReachability[area].reachIndexes = NULL;
-            aasworld.reversedReachability[area].count = 0;
+            models[unique++] = models[index];
         }
-        free(aasworld.reversedReachability);
-        aasworld.reversedReachability = NULL;
     }
+
+    aasworld.moverModels = models;
+    aasworld.numMoverModels = unique;
+    return true;
 }
 
-void AAS_ClearReachabilityData(void)
+/* Bit of a mover model in the route cache mover masks, -1 when no reachability rides it. */
+int AAS_MoverModelBitIndex(int modelnum)
 {
-    AAS_FreeReverseReachability();
-    free(aasworld.reachabilityFromArea);
-    aasworld.reachabilityFromArea = NULL;
+    if (aasworld.moverModels == NULL || modelnum <= 0)
+    {
+        return -1;
+    }
+
+    const int *found = (const int *)bsearch(&modelnum,
+                                            aasworld.moverModels,
+                                            (size_t)aasworld.numMoverModels,
+                                            sizeof(int),
+                                            AAS_CompareModelNumbers);
+    return (found != NULL) ? (int)((found - aasworld.moverModels) & 63) : -1;
 }
 
+/* Packs one reachability the way the route searches read it. */
+static void AAS_BuildReverseEdge(aas_reverseedge_t *edge, int area, int reachIndex)
+{
+    const aas_reachability_t *reach = &aasworld.reachability[reachIndex];
+    int offset = reachIndex - aasworld.areasettings[area].firstreachablearea;
+
+    edge->startArea = area;
+    edge->travelflags = AAS_TravelFlagForType(reach->traveltype);
+    edge->cost = reach->traveltime;
+    edge->reachOffset = (reachIndex > 0 && offset >= 0 && offset < AAS_REVERSEEDGE_NONE)
+                            ? (unsigned char)offset
+                            : (unsigned char)AAS_REVERSEEDGE_NONE;
+    edge->moverBit = (unsigned char)AAS_REVERSEEDGE_NONE;
+
+    int bit = AAS_MoverModelBitIndex(AAS_ReachabilityMoverModel(reach));
+    if (bit >= 0)
+    {
+        edge->moverBit = (unsigned char)bit;
+    }
+}
+
+/*
+ * Builds the reversed reachability graph in compressed sparse row form: the
+ * edges arriving in area a are reverseEdges[reverseEdgeOffsets[a] ..
+ * reverseEdgeOffsets[a + 1]).  Travel flags are resolved here, so
+ * AAS_InitTravelFlagFromType must run first; their union keys the route
+ * caches, so caches built against an older graph must be freed.
+ */
 int AAS_PrepareReachability(void)
 {
     AAS_ClearReachabilityData();
@@ -64,26 +164,17 @@ int AAS_PrepareReachability(void)
 
     int numReach = aasworld.numReachability;
     aasworld.reachabilityFromArea = (int *)calloc((size_t)numReach, sizeof(int));
-    if (aasworld.reachabilityFromArea == NULL)
-    {
-        return BLERR_INVALIDIMPORT;
-    }
-
-    aasworld.reversedReachability =
-        (aas_reversedreachability_t *)calloc((size_t)numAreas + 1U, sizeof(aas_reversedreachability_t));
-    if (aasworld.reversedReachability == NULL)
-    {
-        AAS_ClearReachabilityData();
-        return BLERR_INVALIDIMPORT;
-    }
-
-    int *reverseCounts = (int *)calloc((size_t)numAreas + 1U, sizeof(int));
-    if (reverseCounts == NULL)
+    aasworld.reverseEdgeOffsets = (int *)calloc((size_t)numAreas + 2U, sizeof(int));
+    if (aasworld.reachabilityFromArea == NULL || aasworld.reverseEdgeOffsets == NULL
+        || !AAS_CollectMoverModels())
     {
         AAS_ClearReachabilityData();
         return BLERR_INVALIDIMPORT;
     }
 
+    /* First pass: validate and count the edges arriving in each area. */
+    int *offsets = aasworld.reverseEdgeOffsets;
+    int numEdges = 0;
     for (int area = 1; area <= numAreas && area < aasworld.numAreaSettings; ++area)
     {
         const aas_areasettings_t *settings = &aasworld.areasettings[area];
@@ -107,7 +198,6 @@ int AAS_PrepareReachability(void)
             BotLib_Print(PRT_ERROR,
                          "AAS_PrepareReachability: area %d references reachabilities beyond file bounds\n",
                          area);
-            free(reverseCounts);
             AAS_ClearReachabilityData();
             return BLERR_INVALIDIMPORT;
         }
@@ -123,47 +213,43 @@ int AAS_PrepareReachability(void)
                 continue;
             }
 
-            reverseCounts[destination] += 1;
+            offsets[destination + 1] += 1;
+            numEdges += 1;
         }
     }
 
     for (int area = 0; area <= numAreas; ++area)
     {
-        int count = reverseCounts[area];
-        if (count <= 0)
-        {
-            continue;
-        }
+        offsets[area + 1] += offsets[area];
+    }
 
-        aasworld.reversedReachability[area].reachIndexes = (int *)malloc((size_t)count * sizeof(int));
-        if (aasworld.reversedReachability[area].reachIndexes == NULL)
+    if (numEdges > 0)
+    {
+        aasworld.reverseEdges = (aas_reverseedge_t *)malloc((size_t)numEdges * sizeof(aas_reverseedge_t));
+        if (aasworld.reverseEdges == NULL)
         {
-            free(reverseCounts);
             AAS_ClearReachabilityData();
             return BLERR_INVALIDIMPORT;
         }
-        aasworld.reversedReachability[area].count = count;
     }
 
-    int *reverseOffsets = (int *)calloc((size_t)numAreas + 1U, sizeof(int));
-    if (reverseOffsets == NULL)
+    int *insert = (int *)malloc(((size_t)numAreas + 1U) * sizeof(int));
+    if (insert == NULL)
     {
-        free(reverseCounts);
         AAS_ClearReachabilityData();
         return BLERR_INVALIDIMPORT;
     }
+    memcpy(insert, offsets, ((size_t)numAreas + 1U) * sizeof(int));
 
+    /* Second pass: pack each edge into its destination's row. */
+    unsigned short maxCost = 0;
+    int usedFlags = 0;
     for (int area = 1; area <= numAreas && area < aasworld.numAreaSettings; ++area)
     {
         const aas_areasettings_t *settings = &aasworld.areasettings[area];
-        if (settings->numreachableareas <= 0)
-        {
-            continue;
-        }
-
         int first = settings->firstreachablearea;
         int count = settings->numreachableareas;
-        if (first < 0)
+        if (count <= 0 || first < 0)
         {
             continue;
         }
@@ -177,17 +263,20 @@ int AAS_PrepareReachability(void)
                 continue;
             }
 
-            int insert = reverseOffsets[destination];
-            if (insert < aasworld.reversedReachability[destination].count)
+            aas_reverseedge_t *edge = &aasworld.reverseEdges[insert[destination]++];
+            AAS_BuildReverseEdge(edge, area, reachIndex);
+            if (edge->cost > maxCost)
             {
-                aasworld.reversedReachability[destination].reachIndexes[insert] = reachIndex;
-                reverseOffsets[destination] = insert + 1;
+                maxCost = edge->cost;
             }
+            usedFlags |= edge->travelflags;
         }
     }
 
-    free(reverseOffsets);
-    free(reverseCounts);
+    free(insert);
+    aasworld.numReverseEdges = numEdges;
+    aasworld.maxReverseEdgeCost = maxCost;
+    aasworld.reachabilityTravelFlags = usedFlags;
     return BLERR_NOERROR;
 }
 
@@ -2,30 +2,220 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #include "botlib/common/l_log.h"
 #include "botlib/common/l_libvar.h"
 #include "q2bridge/bridge_config.h"
 
 #define ROUTECACHE_TABLE_SIZE 256U
 #define ROUTE_INVALID_TIME 0xFFFFU
+#define ROUTE_NO_REACH 0xFFU
+#define ROUTE_UNSEEN 0xFFFFFFFFU
+#define ROUTE_PENDING_TIME 0x10000U /* a paused search has not reached the area yet */
+#define ROUTE_BATCH_SEARCH (-2)     /* AAS_AreaTravelTimesToGoalAreas: goal left to the forward search */
+
+#define ROUTECACHE_FILE_IDENT (('D' << 24) + ('C' << 16) + ('R' << 8) + 'G')
+#define ROUTECACHE_FILE_VERSION 3
+#define ROUTEMATRIX_FILE_IDENT (('M' << 24) + ('T' << 16) + ('R' << 8) + 'G')
+#define ROUTEMATRIX_FILE_VERSION 2
+
+/* Header of the .rcd sidecar written next to the .aas file. */
+typedef struct
+{
+    int32_t ident;
+    int32_t version;
+    int32_t aasChecksum;
+    int32_t bspChecksum;
+    int32_t numAreas;
+    int32_t numReachability;
+    int32_t numClusters;
+    int32_t numPortals;
+    int32_t areaOrder; /* caches are indexed by the renumbered areas */
+    int32_t numCaches;
+} aas_routecache_file_header_t;
+
+/* Per-cache record; traveltimes and, if present, reachabilities follow. */
+typedef struct
+{
+    int32_t type;
+    int32_t cluster;
+    int32_t goalArea;
+    int32_t travelflags;
+    int32_t numTraveltimes;
+    int32_t reserved;
+    uint64_t moverModels;
+} aas_routecache_file_record_t;
+
+/*
+ * Header of the .rtm all-pairs sidecar.  (numAreas + 1)^2 travel times
+ * follow, row goal holding the time from every area to goal.
+ */
+typedef struct
+{
+    int32_t ident;
+    int32_t version;
+    int32_t aasChecksum;
+    int32_t bspChecksum;
+    int32_t numAreas;
+    int32_t numReachability;
+    int32_t travelflags;
+    int32_t areaOrder;
+} aas_routematrix_file_header_t;
+
+/*
+ * Optional all-pairs travel times for small maps (routematrix = largest area
+ * count to build one for).  While loaded, lookups with the matrix travel
+ * flags are a single array read.  The times come from the static
+ * reachability costs alone, so moving brush models never invalidate a row.
+ */
+typedef struct
+{
+    aas_fileimage_t image;      /* mapped sidecar, empty when built this load */
+    unsigned short *owned;      /* matrix built this load */
+    const unsigned short *times;
+    int stride;                 /* numAreas + 1 */
+    int travelflags;
+} aas_route_matrix_t;
+
+static aas_route_matrix_t g_route_matrix;
 
 typedef struct
 {
     int frames_with_work;
     int frames_skipped;
     int last_budget;
+    int remaining;          /* area settles left for pending caches this frame */
     bool forcewrite_active;
 } aas_route_frame_state_t;
 
 static aas_route_frame_state_t g_route_frame_state;
 
+typedef struct
+{
+    int hits;
+    int misses;
+    int evictions;
+    int mover_invalidations;
+    int forward_searches;
+} aas_route_cache_stats_t;
+
+static aas_route_cache_stats_t g_route_cache_stats;
+
+/*
+ * Optional map-start precompute (routeprecompute = worker count).  Once the
+ * level items have registered their goal areas, worker threads fill the
+ * world or cluster caches those goals will need.  Workers only run the
+ * self-contained searches into caches that are not yet in the table; the
+ * main thread publishes finished jobs each frame, and a lookup that misses
+ * waits for or takes over the matching job.
+ */
+#define ROUTE_PRECOMPUTE_MAX_THREADS 16
+
+typedef enum
+{
+    ROUTE_JOB_QUEUED,
+    ROUTE_JOB_RUNNING,
+    ROUTE_JOB_DONE,
+    ROUTE_JOB_RETIRED /* published, discarded or taken over by the main thread */
+} aas_route_job_state_t;
+
+typedef struct
+{
+    aas_routingcache_t *cache;
+    aas_route_job_state_t state;
+} aas_route_job_t;
+
+typedef enum
+{
+    ROUTE_STATUS_NONE,
+    ROUTE_STATUS_FOUND,
+    ROUTE_STATUS_PENDING /* a search paused by the frame budget owes the answer */
+} aas_route_status_t;
+
+typedef struct
+{
+    int *goalAreas;
+    int numGoalAreas;
+    int maxGoalAreas;
+    bool started;
+    aas_route_job_t *jobs;
+    int numJobs;
+    int maxJobs;
+    int nextJob;
+    int pending;
+    bool cancel;
+    bool compact; /* workers pack the caches they finish */
+    uint64_t invalidatedModels;
+#ifndef _WIN32
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    pthread_t threads[ROUTE_PRECOMPUTE_MAX_THREADS];
+    int numThreads;
+#endif
+} aas_route_precompute_t;
+
+static aas_route_precompute_t g_route_precompute = {
+#ifndef _WIN32
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .finished = PTHREAD_COND_INITIALIZER,
+#endif
+    .goalAreas = NULL,
+};
+
+static void AAS_RoutePrecomputeStop(void);
+static int AAS_ReadIntLibVar(libvar_t *var);
+static bool AAS_LibVarEnabled(libvar_t *var);
+
+static uint64_t AAS_MoverModelBit(int modelnum);
+
+/*
+ * Scratch for the bucket-queue searches, indexed like the cache being
+ * filled.  Each thread that runs searches owns one, and so does every cache
+ * whose search is paused until a later frame.
+ */
+typedef struct aas_route_kernel_s
+{
+    unsigned int *times;  /* tentative travel time, ROUTE_UNSEEN if not queued */
+    unsigned char *reach; /* reachability offset behind the tentative time */
+    unsigned char *mover; /* mover bit of that reachability, or AAS_REVERSEEDGE_NONE */
+    int *area;            /* area number behind each cache index */
+    int *next;
+    int *prev;
+    int capacity;
+    int *buckets;
+    int numBuckets;
+    unsigned int time; /* bucket time a paused search resumes at */
+    int queued;        /* entries still in the buckets */
+} aas_route_kernel_t;
+
+static aas_route_kernel_t g_route_kernel;
+
+static void AAS_RouteKernelFree(aas_route_kernel_t *kernel)
+{
+    free(kernel->times);
+    free(kernel->reach);
+    free(kernel->mover);
+    free(kernel->area);
+    free(kernel->next);
+    free(kernel->prev);
+    free(kernel->buckets);
+    memset(kernel, 0, sizeof(*kernel));
+}
+
 typedef struct
 {
     int area;
     unsigned int time;
+    uint64_t movers; /* mover bits of the route that queued area */
 } routing_heap_node_t;
 
 typedef struct
@@ -63,7 +253,7 @@ static void Heap_Destroy(routing_minheap_t *heap)
     heap->capacity = 0;
 }
 
-static int Heap_Push(routing_minheap_t *heap, int area, unsigned int time)
+static int Heap_Push(routing_minheap_t *heap, int area, unsigned int time, uint64_t movers)
 {
     if (heap->capacity == 0)
     {
@@ -107,12 +297,13 @@ static int Heap_Push(routing_minheap_t *heap, int area, unsigned int time)
 
     heap->nodes[index].area = area;
     heap->nodes[index].time = time;
+    heap->nodes[index].movers = movers;
     return 1;
 }
 
 static routing_heap_node_t Heap_Pop(routing_minheap_t *heap)
 {
-    routing_heap_node_t result = {-1, 0};
+    routing_heap_node_t result = {-1, 0, 0};
     if (heap->size <= 0)
     {
         return result;
@@ -156,10 +347,25 @@ static routing_heap_node_t Heap_Pop(routing_minheap_t *heap)
     return result;
 }
 
-static unsigned int RouteCacheHash(int goalArea, int travelflags)
+/*
+ * Drops travel-flag bits no reachability in the prepared graph carries.  Masks
+ * that differ only in such bits route identically, so they share one cache.
+ */
+static int RouteCache_KeyTravelFlags(int travelflags)
+{
+    if (aasworld.reverseEdges == NULL)
+    {
+        return travelflags;
+    }
+
+    return travelflags & aasworld.reachabilityTravelFlags;
+}
+
+static unsigned int RouteCacheHash(int type, int cluster, int goalArea, int travelflags)
 {
     unsigned int value = (unsigned int)goalArea * 1315423911U;
     value ^= (unsigned int)travelflags * 2654435761U;
+    value ^= ((unsigned int)cluster << 8) ^ (unsigned int)type;
     return value;
 }
 
@@ -183,18 +389,74 @@ static int RouteCache_EnsureTable(void)
     return 1;
 }
 
-static aas_routingcache_t *RouteCache_Find(int goalArea, int travelflags)
+static void RouteCache_Unlink(aas_routingcache_t *cache)
+{
+    if (cache == NULL)
+    {
+        return;
+    }
+
+    if (cache->prev != NULL)
+    {
+        cache->prev->next = cache->next;
+    }
+    else
+    {
+        aasworld.routingCacheHead = cache->next;
+    }
+
+    if (cache->next != NULL)
+    {
+        cache->next->prev = cache->prev;
+    }
+    else
+    {
+        aasworld.routingCacheTail = cache->prev;
+    }
+}
+
+static void RouteCache_Append(aas_routingcache_t *cache)
+{
+    cache->prev = aasworld.routingCacheTail;
+    cache->next = NULL;
+    if (aasworld.routingCacheTail != NULL)
+    {
+        aasworld.routingCacheTail->next = cache;
+    }
+    else
+    {
+        aasworld.routingCacheHead = cache;
+    }
+    aasworld.routingCacheTail = cache;
+}
+
+/* Move a cache to the most recently used end of the list. */
+static void RouteCache_Touch(aas_routingcache_t *cache)
+{
+    if (cache == NULL || cache == aasworld.routingCacheTail)
+    {
+        return;
+    }
+
+    RouteCache_Unlink(cache);
+    RouteCache_Append(cache);
+}
+
+static aas_routingcache_t *RouteCache_Find(int type, int cluster, int goalArea, int travelflags)
 {
     if (aasworld.routingCacheTable == NULL || aasworld.routingCacheTableSize == 0)
     {
         return NULL;
     }
 
-    unsigned int hash = RouteCacheHash(goalArea, travelflags) % aasworld.routingCacheTableSize;
+    travelflags = RouteCache_KeyTravelFlags(travelflags);
+    unsigned int hash = RouteCacheHash(type, cluster, goalArea, travelflags) % aasworld.routingCacheTableSize;
     for (aas_routingcache_t *cache = aasworld.routingCacheTable[hash]; cache != NULL; cache = cache->hashNext)
     {
-        if (cache->goalArea == goalArea && cache->travelflags == travelflags)
+        if (cache->goalArea == goalArea && cache->travelflags == travelflags
+            && cache->type == type && cache->cluster == cluster)
         {
+            RouteCache_Touch(cache);
             return cache;
         }
     }
@@ -214,52 +476,101 @@ static void RouteCache_Insert(aas_routingcache_t *cache)
         return;
     }
 
-    unsigned int hash = RouteCacheHash(cache->goalArea, cache->travelflags) % aasworld.routingCacheTableSize;
+    unsigned int hash = RouteCacheHash(cache->type, cache->cluster, cache->goalArea, cache->travelflags)
+                        % aasworld.routingCacheTableSize;
     cache->hashNext = aasworld.routingCacheTable[hash];
     aasworld.routingCacheTable[hash] = cache;
 
-    cache->prev = aasworld.routingCacheTail;
-    cache->next = NULL;
-    if (aasworld.routingCacheTail != NULL)
-    {
-        aasworld.routingCacheTail->next = cache;
-    }
-    else
+    RouteCache_Append(cache);
+    aasworld.routingCacheBytes += cache->size;
+}
+
+/* Releases a cache that is not linked into the table. */
+static void RouteCache_Destroy(aas_routingcache_t *cache)
+{
+    free(cache->traveltimes);
+    free(cache->reachabilities);
+    free(cache->blocks);
+    if (cache->frontier != NULL)
     {
-        aasworld.routingCacheHead = cache;
+        AAS_RouteKernelFree(cache->frontier);
+        free(cache->frontier);
     }
-    aasworld.routingCacheTail = cache;
+    free(cache);
 }
 
-static void RouteCache_Unlink(aas_routingcache_t *cache)
+static void RouteCache_Free(aas_routingcache_t *cache)
 {
-    if (cache == NULL)
+    RouteCache_Unlink(cache);
+
+    unsigned int hash = RouteCacheHash(cache->type, cache->cluster, cache->goalArea, cache->travelflags)
+                        % aasworld.routingCacheTableSize;
+    aas_routingcache_t **slot = &aasworld.routingCacheTable[hash];
+    while (*slot != NULL && *slot != cache)
     {
-        return;
+        slot = &(*slot)->hashNext;
+    }
+    if (*slot != NULL)
+    {
+        *slot = cache->hashNext;
     }
 
-    if (cache->prev != NULL)
+    aasworld.routingCacheBytes -= (cache->size <= aasworld.routingCacheBytes) ? cache->size
+                                                                              : aasworld.routingCacheBytes;
+    RouteCache_Destroy(cache);
+}
+
+static size_t RouteCache_Budget(void)
+{
+    libvar_t *var = Bridge_MaxRoutingCache();
+    if (var == NULL || var->value <= 0.0f)
     {
-        cache->prev->next = cache->next;
+        return 0U;
     }
-    else
+
+    return (size_t)var->value * 1024U;
+}
+
+/*
+ * Evict least recently used caches until incoming bytes fit the
+ * max_routingcache budget.  Pinned caches belong to a search that is still
+ * running and are skipped; the budget may be exceeded while they are held.
+ */
+static void RouteCache_EvictForBudget(size_t incoming)
+{
+    size_t budget = RouteCache_Budget();
+    if (budget == 0U)
     {
-        aasworld.routingCacheHead = cache->next;
+        return;
     }
 
-    if (cache->next != NULL)
+    aas_routingcache_t *cache = aasworld.routingCacheHead;
+    while (cache != NULL && aasworld.routingCacheBytes + incoming > budget)
     {
-        cache->next->prev = cache->prev;
+        aas_routingcache_t *next = cache->next;
+        if (!cache->pinned)
+        {
+            RouteCache_Free(cache);
+            g_route_cache_stats.evictions += 1;
+        }
+        cache = next;
     }
-    else
+}
+
+/* Portal caches only feed other searches, so they carry no next-hop table. */
+static size_t RouteCache_EntryBytes(int type)
+{
+    size_t bytes = sizeof(unsigned short);
+    if (type != AAS_ROUTECACHE_PORTAL)
     {
-        aasworld.routingCacheTail = cache->prev;
+        bytes += sizeof(unsigned char);
     }
+    return bytes;
 }
 
-static aas_routingcache_t *RouteCache_Alloc(int goalArea, int travelflags)
+static aas_routingcache_t *RouteCache_Alloc(int type, int cluster, int goalArea, int travelflags, int numTraveltimes)
 {
-    size_t numAreas = (aasworld.numAreas > 0) ? (size_t)aasworld.numAreas + 1U : 1U;
+    size_t count = (numTraveltimes > 0) ? (size_t)numTraveltimes : 1U;
 
     aas_routingcache_t *cache = (aas_routingcache_t *)calloc(1, sizeof(aas_routingcache_t));
     if (cache == NULL)
@@ -267,20 +578,36 @@ static aas_routingcache_t *RouteCache_Alloc(int goalArea, int travelflags)
         return NULL;
     }
 
-    cache->traveltimes = (unsigned short *)malloc(numAreas * sizeof(unsigned short));
+    cache->traveltimes = (unsigned short *)malloc(count * sizeof(unsigned short));
     if (cache->traveltimes == NULL)
     {
         free(cache);
         return NULL;
     }
 
-    for (size_t index = 0; index < numAreas; ++index)
+    for (size_t index = 0; index < count; ++index)
     {
         cache->traveltimes[index] = (unsigned short)ROUTE_INVALID_TIME;
     }
 
+    if (type != AAS_ROUTECACHE_PORTAL)
+    {
+        cache->reachabilities = (unsigned char *)malloc(count * sizeof(unsigned char));
+        if (cache->reachabilities == NULL)
+        {
+            free(cache->traveltimes);
+            free(cache);
+            return NULL;
+        }
+        memset(cache->reachabilities, ROUTE_NO_REACH, count * sizeof(unsigned char));
+    }
+
+    cache->type = type;
+    cache->cluster = cluster;
     cache->goalArea = goalArea;
-    cache->travelflags = travelflags;
+    cache->travelflags = RouteCache_KeyTravelFlags(travelflags);
+    cache->numTraveltimes = (int)count;
+    cache->size = sizeof(aas_routingcache_t) + count * RouteCache_EntryBytes(type);
     cache->hashNext = NULL;
     cache->prev = NULL;
     cache->next = NULL;
@@ -288,340 +615,2902 @@ static aas_routingcache_t *RouteCache_Alloc(int goalArea, int travelflags)
     return cache;
 }
 
-void AAS_FreeAllRoutingCaches(void)
+/*
+ * Compact caches split their entries into blocks of ROUTE_BLOCK_SIZE and
+ * store each block frame-of-reference style: travel times as deltas from the
+ * block's fastest time and reachability offsets as-is, each packed with the
+ * fewest bits that hold the block's largest value plus an all-ones
+ * "unreachable" / "no reachability" code.  A block without reachable entries
+ * has no payload at all.  Decoding an entry is a header load, a three-byte
+ * load and a shift, and the result is exact.  How much is saved depends on
+ * areas with nearby numbers having similar travel times, which holds for
+ * most of a world cache.
+ */
+#define ROUTE_BLOCK_SHIFT 5
+#define ROUTE_BLOCK_SIZE (1 << ROUTE_BLOCK_SHIFT)
+#define ROUTE_BLOCK_PADDING 2U /* RouteCache_BlockField reads up to two bytes past a field */
+
+/* Bits needed so value fits with the all-ones code left free. */
+static unsigned char RouteCache_FieldBits(int maxValue)
 {
-    aas_routingcache_t *cache = aasworld.routingCacheHead;
-    while (cache != NULL)
-    {
-        aas_routingcache_t *next = cache->next;
-        free(cache->traveltimes);
-        free(cache);
-        cache = next;
-    }
-
-    if (aasworld.routingCacheTable != NULL)
+    unsigned char bits = 0;
+    while (maxValue >= 0 && (1 << bits) - 1 <= maxValue)
     {
-        free(aasworld.routingCacheTable);
+        ++bits;
     }
-
-    aasworld.routingCacheTable = NULL;
-    aasworld.routingCacheTableSize = 0;
-    aasworld.routingCacheHead = NULL;
-    aasworld.routingCacheTail = NULL;
+    return bits;
 }
 
-void AAS_InvalidateRouteCache(void)
+/* Payload bytes of one packed field of a block. */
+static size_t RouteCache_FieldBytes(unsigned char bits)
 {
-    AAS_FreeAllRoutingCaches();
+    return ((size_t)bits * ROUTE_BLOCK_SIZE) / 8U;
 }
 
-void AAS_InitTravelFlagFromType(void)
+static void RouteCache_PlanBlock(const aas_routingcache_t *cache, int first, aas_routeblock_t *block)
 {
-    for (int i = 0; i < MAX_TRAVELTYPES; ++i)
+    int last = first + ROUTE_BLOCK_SIZE;
+    if (last > cache->numTraveltimes)
     {
-        aasworld.travelflagfortype[i] = TFL_INVALID;
+        last = cache->numTraveltimes;
     }
 
-    aasworld.travelflagfortype[TRAVEL_INVALID] = TFL_INVALID;
-    aasworld.travelflagfortype[TRAVEL_WALK] = TFL_WALK;
-    aasworld.travelflagfortype[TRAVEL_CROUCH] = TFL_CROUCH;
-    aasworld.travelflagfortype[TRAVEL_BARRIERJUMP] = TFL_BARRIERJUMP;
-    aasworld.travelflagfortype[TRAVEL_JUMP] = TFL_JUMP;
-    aasworld.travelflagfortype[TRAVEL_LADDER] = TFL_LADDER;
-    aasworld.travelflagfortype[TRAVEL_WALKOFFLEDGE] = TFL_WALKOFFLEDGE;
-    aasworld.travelflagfortype[TRAVEL_SWIM] = TFL_SWIM;
-    aasworld.travelflagfortype[TRAVEL_WATERJUMP] = TFL_WATERJUMP;
-    aasworld.travelflagfortype[TRAVEL_TELEPORT] = TFL_TELEPORT;
-    aasworld.travelflagfortype[TRAVEL_ELEVATOR] = TFL_ELEVATOR;
-    aasworld.travelflagfortype[TRAVEL_ROCKETJUMP] = TFL_ROCKETJUMP;
-    aasworld.travelflagfortype[TRAVEL_BFGJUMP] = TFL_BFGJUMP;
-    aasworld.travelflagfortype[TRAVEL_GRAPPLEHOOK] = TFL_GRAPPLEHOOK;
-    aasworld.travelflagfortype[TRAVEL_DOUBLEJUMP] = TFL_DOUBLEJUMP;
-    aasworld.travelflagfortype[TRAVEL_RAMPJUMP] = TFL_RAMPJUMP;
-    aasworld.travelflagfortype[TRAVEL_STRAFEJUMP] = TFL_STRAFEJUMP;
-    aasworld.travelflagfortype[TRAVEL_JUMPPAD] = TFL_JUMPPAD;
-    aasworld.travelflagfortype[TRAVEL_FUNCBOB] = TFL_FUNCBOB;
-}
-
-static int AAS_TravelFlagForType(int traveltype)
-{
-    int flags = 0;
-    if (traveltype & TRAVELFLAG_NOTTEAM1)
-    {
-        flags |= TFL_NOTTEAM1;
-    }
-    if (traveltype & TRAVELFLAG_NOTTEAM2)
+    unsigned int low = ROUTE_INVALID_TIME;
+    unsigned int high = 0U;
+    int maxReach = -1;
+    for (int index = first; index < last; ++index)
     {
-        flags |= TFL_NOTTEAM2;
+        unsigned int time = cache->traveltimes[index];
+        if (time == ROUTE_INVALID_TIME)
+        {
+            continue;
+        }
+
+        low = (time < low) ? time : low;
+        high = (time > high) ? time : high;
+        unsigned char reach = cache->reachabilities[index];
+        if (reach != ROUTE_NO_REACH && reach > maxReach)
+        {
+            maxReach = reach;
+        }
     }
 
-    int type = traveltype & TRAVELTYPE_MASK;
-    if (type < 0 || type >= MAX_TRAVELTYPES)
+    block->data = 0U;
+    block->base = 0;
+    block->timeBits = 0;
+    block->reachBits = 0;
+    if (low != ROUTE_INVALID_TIME)
     {
-        return TFL_INVALID;
+        block->base = (unsigned short)low;
+        block->timeBits = RouteCache_FieldBits((int)(high - low));
+        block->reachBits = RouteCache_FieldBits(maxReach);
     }
-
-    flags |= aasworld.travelflagfortype[type];
-    return flags;
 }
 
-static float VectorDistance(const vec3_t a, const vec3_t b)
+static void RouteCache_StoreField(unsigned char *field, int slot, unsigned char bits, unsigned int value)
 {
-    float dx = a[0] - b[0];
-    float dy = a[1] - b[1];
-    float dz = a[2] - b[2];
-    return sqrtf(dx * dx + dy * dy + dz * dz);
+    unsigned int bit = (unsigned int)slot * bits;
+    unsigned int word = value << (bit & 7U);
+    unsigned char *bytes = field + (bit >> 3);
+    bytes[0] |= (unsigned char)(word & 0xFFU);
+    bytes[1] |= (unsigned char)((word >> 8) & 0xFFU);
+    bytes[2] |= (unsigned char)((word >> 16) & 0xFFU);
 }
 
-static unsigned short AAS_LocalTravelTime(int areanum, const vec3_t origin)
+static unsigned int RouteCache_BlockField(const unsigned char *field, int slot, unsigned char bits)
 {
-    if (origin == NULL)
-    {
-        return 0;
-    }
+    unsigned int bit = (unsigned int)slot * bits;
+    const unsigned char *bytes = field + (bit >> 3);
+    unsigned int word = (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) | ((unsigned int)bytes[2] << 16);
+    return (word >> (bit & 7U)) & ((1U << bits) - 1U);
+}
 
-    if (areanum <= 0 || areanum > aasworld.numAreas)
-    {
-        return 0;
-    }
+static void RouteCache_PackBlock(const aas_routingcache_t *cache,
+                                 int first,
+                                 const aas_routeblock_t *block,
+                                 unsigned char *payload)
+{
+    unsigned int timeCode = (1U << block->timeBits) - 1U;
+    unsigned int reachCode = (1U << block->reachBits) - 1U;
+    unsigned char *reachField = payload + RouteCache_FieldBytes(block->timeBits);
 
-    vec3_t center;
-    VectorCopy(aasworld.areas[areanum].center, center);
-    float distance = VectorDistance(origin, center);
-    float travel = distance * 0.33f;
-    if (travel < 0.0f)
+    for (int slot = 0; slot < ROUTE_BLOCK_SIZE; ++slot)
     {
-        travel = 0.0f;
-    }
+        unsigned int time = ROUTE_INVALID_TIME;
+        unsigned char reach = ROUTE_NO_REACH;
+        if (first + slot < cache->numTraveltimes)
+        {
+            time = cache->traveltimes[first + slot];
+            reach = cache->reachabilities[first + slot];
+        }
 
-    if (travel >= ROUTE_INVALID_TIME)
-    {
-        return (unsigned short)ROUTE_INVALID_TIME;
+        RouteCache_StoreField(payload,
+                              slot,
+                              block->timeBits,
+                              (time == ROUTE_INVALID_TIME) ? timeCode : time - block->base);
+        RouteCache_StoreField(reachField,
+                              slot,
+                              block->reachBits,
+                              (time == ROUTE_INVALID_TIME || reach == ROUTE_NO_REACH) ? reachCode : reach);
     }
-
-    return (unsigned short)travel;
 }
 
-static void AAS_PopulateRouteCache(aas_routingcache_t *cache)
+/*
+ * Re-encodes a populated world or cluster cache into blocks and releases the
+ * flat arrays.  Portal caches are a few entries per map and stay flat.  The
+ * cache keeps its flat form when packing would not save memory.  Only size
+ * changes; a caller holding the cache in the table adjusts the byte count.
+ */
+static void RouteCache_Compact(aas_routingcache_t *cache)
 {
-    if (cache == NULL)
-    {
-        return;
-    }
-
-    int numAreas = aasworld.numAreas;
-    if (numAreas <= 0)
+    if (cache->type == AAS_ROUTECACHE_PORTAL || cache->blocks != NULL || cache->frontier != NULL
+        || cache->traveltimes == NULL || cache->reachabilities == NULL)
     {
         return;
     }
 
-    for (int area = 0; area <= numAreas; ++area)
+    int numBlocks = (cache->numTraveltimes + ROUTE_BLOCK_SIZE - 1) >> ROUTE_BLOCK_SHIFT;
+    size_t headerBytes = (size_t)numBlocks * sizeof(aas_routeblock_t);
+    size_t payloadBytes = ROUTE_BLOCK_PADDING;
+    for (int index = 0; index < numBlocks; ++index)
     {
-        cache->traveltimes[area] = (unsigned short)ROUTE_INVALID_TIME;
+        aas_routeblock_t block;
+        RouteCache_PlanBlock(cache, index << ROUTE_BLOCK_SHIFT, &block);
+        payloadBytes += RouteCache_FieldBytes(block.timeBits) + RouteCache_FieldBytes(block.reachBits);
     }
 
-    if (cache->goalArea <= 0 || cache->goalArea > numAreas)
+    size_t flatBytes = (size_t)cache->numTraveltimes * RouteCache_EntryBytes(cache->type);
+    if (headerBytes + payloadBytes >= flatBytes)
     {
         return;
     }
 
-    routing_minheap_t heap;
-    if (!Heap_Init(&heap, 64))
+    unsigned char *memory = (unsigned char *)calloc(1, headerBytes + payloadBytes);
+    if (memory == NULL)
     {
         return;
     }
 
-    if (!Heap_Push(&heap, cache->goalArea, 0))
+    aas_routeblock_t *blocks = (aas_routeblock_t *)memory;
+    unsigned char *data = memory + headerBytes;
+    size_t offset = 0U;
+    for (int index = 0; index < numBlocks; ++index)
     {
-        Heap_Destroy(&heap);
-        return;
+        int first = index << ROUTE_BLOCK_SHIFT;
+        aas_routeblock_t *block = &blocks[index];
+        RouteCache_PlanBlock(cache, first, block);
+        block->data = (unsigned int)offset;
+        if (block->timeBits != 0)
+        {
+            RouteCache_PackBlock(cache, first, block, data + offset);
+            offset += RouteCache_FieldBytes(block->timeBits) + RouteCache_FieldBytes(block->reachBits);
+        }
     }
 
-    while (heap.size > 0)
+    free(cache->traveltimes);
+    free(cache->reachabilities);
+    cache->traveltimes = NULL;
+    cache->reachabilities = NULL;
+    cache->blocks = blocks;
+    cache->blockData = data;
+    cache->size = sizeof(aas_routingcache_t) + headerBytes + payloadBytes;
+}
+
+/*
+ * Best time the paused search of a pending cache has found for an entry it
+ * has not settled yet.  It is the cost of a real path, only maybe not the
+ * shortest one.
+ */
+static unsigned int RouteCache_TentativeTime(const aas_routingcache_t *cache, int index)
+{
+    unsigned int time = cache->frontier->times[index];
+    return (time < ROUTE_INVALID_TIME) ? time : ROUTE_INVALID_TIME;
+}
+
+/*
+ * Travel time of one entry, ROUTE_INVALID_TIME when it cannot reach the goal.
+ * A pending cache answers with the tentative time of entries it has queued
+ * and ROUTE_PENDING_TIME for the ones its search has not reached yet.
+ */
+static unsigned int RouteCache_EntryTime(const aas_routingcache_t *cache, int index)
+{
+    if (cache->blocks == NULL)
     {
-        routing_heap_node_t node = Heap_Pop(&heap);
-        if (node.area <= 0 || node.area > numAreas)
+        unsigned int time = cache->traveltimes[index];
+        if (time == ROUTE_INVALID_TIME && cache->frontier != NULL)
         {
-            continue;
+            time = RouteCache_TentativeTime(cache, index);
+            if (time == ROUTE_INVALID_TIME)
+            {
+                time = ROUTE_PENDING_TIME;
+            }
         }
+        return time;
+    }
 
-        if (node.time >= cache->traveltimes[node.area])
-        {
-            continue;
-        }
+    const aas_routeblock_t *block = &cache->blocks[index >> ROUTE_BLOCK_SHIFT];
+    if (block->timeBits == 0)
+    {
+        return ROUTE_INVALID_TIME;
+    }
 
-        unsigned int clamped = node.time;
-        if (clamped > ROUTE_INVALID_TIME)
-        {
-            clamped = ROUTE_INVALID_TIME;
-        }
-        cache->traveltimes[node.area] = (unsigned short)clamped;
+    unsigned int delta =
+        RouteCache_BlockField(cache->blockData + block->data, index & (ROUTE_BLOCK_SIZE - 1), block->timeBits);
+    return (delta == (1U << block->timeBits) - 1U) ? ROUTE_INVALID_TIME : block->base + delta;
+}
 
-        const aas_reversedreachability_t *reverse = &aasworld.reversedReachability[node.area];
-        if (reverse->count <= 0 || reverse->reachIndexes == NULL)
+/* Reachability offset of one entry, ROUTE_NO_REACH when there is none. */
+static unsigned char RouteCache_EntryReach(const aas_routingcache_t *cache, int index)
+{
+    if (cache->blocks == NULL)
+    {
+        if (cache->frontier != NULL && cache->traveltimes[index] == ROUTE_INVALID_TIME
+            && RouteCache_TentativeTime(cache, index) != ROUTE_INVALID_TIME)
         {
-            continue;
+            return cache->frontier->reach[index];
+        }
+        return cache->reachabilities[index];
+    }
+
+    const aas_routeblock_t *block = &cache->blocks[index >> ROUTE_BLOCK_SHIFT];
+    if (block->reachBits == 0)
+    {
+        return (unsigned char)ROUTE_NO_REACH;
+    }
+
+    const unsigned char *field = cache->blockData + block->data + RouteCache_FieldBytes(block->timeBits);
+    unsigned int reach = RouteCache_BlockField(field, index & (ROUTE_BLOCK_SIZE - 1), block->reachBits);
+    return (reach == (1U << block->reachBits) - 1U) ? (unsigned char)ROUTE_NO_REACH : (unsigned char)reach;
+}
+
+static bool RouteCache_CompactEnabled(void)
+{
+    return AAS_LibVarEnabled(Bridge_RouteCompact());
+}
+
+/*
+ * One-to-many forward searches of the current frame.  A search stops once
+ * its goals are settled but keeps its frontier, so a later batch from the
+ * same start area resumes it instead of starting over.  Settled times are
+ * final; a search is only reused within the frame that started it.
+ */
+#define ROUTE_FORWARD_SEARCHES 4
+
+typedef struct
+{
+    unsigned short *times; /* settled time per area, ROUTE_INVALID_TIME when not yet */
+    routing_minheap_t heap;
+    int startArea;
+    int travelflags;
+    int frame;
+    bool active;
+} aas_route_forward_search_t;
+
+typedef struct
+{
+    aas_route_forward_search_t searches[ROUTE_FORWARD_SEARCHES];
+    int numAreas;
+    int nextVictim;
+} aas_route_search_scratch_t;
+
+static aas_route_search_scratch_t g_route_search_scratch;
+
+static void AAS_FreeRouteSearchScratch(void)
+{
+    for (int index = 0; index < ROUTE_FORWARD_SEARCHES; ++index)
+    {
+        free(g_route_search_scratch.searches[index].times);
+        Heap_Destroy(&g_route_search_scratch.searches[index].heap);
+    }
+    memset(&g_route_search_scratch, 0, sizeof(g_route_search_scratch));
+}
+
+/* Drops the kept searches; their times no longer match the reachabilities. */
+static void AAS_ResetForwardSearches(void)
+{
+    for (int index = 0; index < ROUTE_FORWARD_SEARCHES; ++index)
+    {
+        g_route_search_scratch.searches[index].active = false;
+    }
+}
+
+/*
+ * This frame's search from areanum, or a new one in the least recently
+ * started slot.  NULL when its memory cannot be allocated.
+ */
+static aas_route_forward_search_t *AAS_ForwardSearchFor(int areanum, int travelflags)
+{
+    int numAreas = aasworld.numAreas;
+    if (g_route_search_scratch.numAreas != numAreas)
+    {
+        AAS_FreeRouteSearchScratch();
+        g_route_search_scratch.numAreas = numAreas;
+    }
+
+    int key = RouteCache_KeyTravelFlags(travelflags);
+    for (int index = 0; index < ROUTE_FORWARD_SEARCHES; ++index)
+    {
+        aas_route_forward_search_t *search = &g_route_search_scratch.searches[index];
+        if (search->active && search->startArea == areanum && search->travelflags == key
+            && search->frame == aasworld.numFrames)
+        {
+            return search;
+        }
+    }
+
+    int victim = g_route_search_scratch.nextVictim;
+    g_route_search_scratch.nextVictim = (victim + 1) % ROUTE_FORWARD_SEARCHES;
+    aas_route_forward_search_t *search = &g_route_search_scratch.searches[victim];
+    search->active = false;
+    if (search->times == NULL)
+    {
+        search->times = (unsigned short *)malloc(((size_t)numAreas + 1U) * sizeof(unsigned short));
+        if (search->times == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    memset(search->times, 0xFF, ((size_t)numAreas + 1U) * sizeof(unsigned short));
+    search->heap.size = 0;
+    if (!Heap_Push(&search->heap, areanum, 0, 0U))
+    {
+        return NULL;
+    }
+
+    search->startArea = areanum;
+    search->travelflags = key;
+    search->frame = aasworld.numFrames;
+    search->active = true;
+    g_route_cache_stats.forward_searches += 1;
+    return search;
+}
+
+/*
+ * Resumes search until goal is settled or the frontier is exhausted.  Returns
+ * false and drops the search when the heap cannot grow.
+ */
+static bool AAS_ForwardSearchSettle(aas_route_forward_search_t *search, int goal)
+{
+    unsigned short *times = search->times;
+    int numAreas = aasworld.numAreas;
+    while (times[goal] == ROUTE_INVALID_TIME && search->heap.size > 0)
+    {
+        routing_heap_node_t node = Heap_Pop(&search->heap);
+        if (node.time >= times[node.area])
+        {
+            continue;
         }
 
-        for (int index = 0; index < reverse->count; ++index)
+        times[node.area] = (unsigned short)node.time;
+        if (node.area >= aasworld.numAreaSettings)
         {
-            int reachIndex = reverse->reachIndexes[index];
+            continue;
+        }
+
+        const aas_areasettings_t *settings = &aasworld.areasettings[node.area];
+        for (int offset = 0; offset < settings->numreachableareas; ++offset)
+        {
+            int reachIndex = settings->firstreachablearea + offset;
             if (reachIndex < 0 || reachIndex >= aasworld.numReachability)
             {
                 continue;
             }
 
-            int startArea = aasworld.reachabilityFromArea[reachIndex];
-            if (startArea <= 0 || startArea > numAreas)
+            const aas_reachability_t *reach = &aasworld.reachability[reachIndex];
+            int required = AAS_TravelFlagForType(reach->traveltype);
+            if ((required & search->travelflags) != required)
             {
                 continue;
             }
 
-            int traveltype = aasworld.reachability[reachIndex].traveltype;
-            int required = AAS_TravelFlagForType(traveltype);
-            if ((required & cache->travelflags) != required)
+            if (reach->areanum <= 0 || reach->areanum > numAreas)
             {
                 continue;
             }
 
-            unsigned int cost = node.time + aasworld.reachability[reachIndex].traveltime;
-            if (cost >= cache->traveltimes[startArea])
+            unsigned int cost = node.time + reach->traveltime;
+            if (cost >= ROUTE_INVALID_TIME || cost >= times[reach->areanum])
             {
                 continue;
             }
 
-            Heap_Push(&heap, startArea, cost);
+            if (!Heap_Push(&search->heap, reach->areanum, cost, 0U))
+            {
+                search->active = false;
+                return false;
+            }
         }
     }
 
-    Heap_Destroy(&heap);
+    return true;
 }
 
-static aas_routingcache_t *RouteCache_Get(int goalArea, int travelflags)
+void AAS_FreeAllRoutingCaches(void)
 {
-    aas_routingcache_t *cache = RouteCache_Find(goalArea, travelflags);
-    if (cache != NULL)
+    AAS_RoutePrecomputeStop();
+    g_route_precompute.started = false;
+
+    aas_routingcache_t *cache = aasworld.routingCacheHead;
+    while (cache != NULL)
     {
-        return cache;
+        aas_routingcache_t *next = cache->next;
+        RouteCache_Destroy(cache);
+        cache = next;
     }
 
-    cache = RouteCache_Alloc(goalArea, travelflags);
-    if (cache == NULL)
+    if (aasworld.routingCacheTable != NULL)
     {
-        return NULL;
+        free(aasworld.routingCacheTable);
     }
 
-    AAS_PopulateRouteCache(cache);
-    RouteCache_Insert(cache);
-    return cache;
+    aasworld.routingCacheTable = NULL;
+    aasworld.routingCacheTableSize = 0;
+    aasworld.routingCacheHead = NULL;
+    aasworld.routingCacheTail = NULL;
+    aasworld.routingCacheBytes = 0U;
+
+    AAS_FreeRouteSearchScratch();
+    AAS_RouteKernelFree(&g_route_kernel);
 }
 
-int AAS_AreaTravelTimeToGoalArea(int areanum, vec3_t origin, int goalareanum, int travelflags)
+void AAS_InvalidateRouteCache(void)
 {
-    if (!aasworld.loaded)
+    AAS_FreeAllRoutingCaches();
+}
+
+int AAS_InvalidateModelRouteCaches(int modelnum)
+{
+    if (modelnum <= 0)
     {
         return 0;
     }
 
-    if (areanum <= 0 || areanum > aasworld.numAreas)
+    uint64_t bit = AAS_MoverModelBit(modelnum);
+    if (bit == 0U)
     {
-        BotLib_Print(PRT_ERROR, "AAS_AreaTravelTimeToGoalArea: areanum %d out of range\n", areanum);
         return 0;
     }
 
-    if (goalareanum <= 0 || goalareanum > aasworld.numAreas)
+    int removed = 0;
+    g_route_precompute.invalidatedModels |= bit;
+
+    aas_routingcache_t *cache = aasworld.routingCacheHead;
+    while (cache != NULL)
     {
-        BotLib_Print(PRT_ERROR, "AAS_AreaTravelTimeToGoalArea: goalareanum %d out of range\n", goalareanum);
-        return 0;
+        aas_routingcache_t *next = cache->next;
+        if ((cache->moverModels & bit) != 0U && !cache->pinned)
+        {
+            RouteCache_Free(cache);
+            ++removed;
+        }
+        cache = next;
     }
 
-    if (areanum == goalareanum)
+    AAS_ResetForwardSearches();
+    g_route_cache_stats.mover_invalidations += removed;
+    return removed;
+}
+
+void AAS_InitTravelFlagFromType(void)
+{
+    for (int i = 0; i < MAX_TRAVELTYPES; ++i)
     {
-        return (int)AAS_LocalTravelTime(areanum, origin);
+        aasworld.travelflagfortype[i] = TFL_INVALID;
     }
 
-    aas_routingcache_t *cache = RouteCache_Get(goalareanum, travelflags);
-    if (cache == NULL)
+    aasworld.travelflagfortype[TRAVEL_INVALID] = TFL_INVALID;
+    aasworld.travelflagfortype[TRAVEL_WALK] = TFL_WALK;
+    aasworld.travelflagfortype[TRAVEL_CROUCH] = TFL_CROUCH;
+    aasworld.travelflagfortype[TRAVEL_BARRIERJUMP] = TFL_BARRIERJUMP;
+    aasworld.travelflagfortype[TRAVEL_JUMP] = TFL_JUMP;
+    aasworld.travelflagfortype[TRAVEL_LADDER] = TFL_LADDER;
+    aasworld.travelflagfortype[TRAVEL_WALKOFFLEDGE] = TFL_WALKOFFLEDGE;
+    aasworld.travelflagfortype[TRAVEL_SWIM] = TFL_SWIM;
+    aasworld.travelflagfortype[TRAVEL_WATERJUMP] = TFL_WATERJUMP;
+    aasworld.travelflagfortype[TRAVEL_TELEPORT] = TFL_TELEPORT;
+    aasworld.travelflagfortype[TRAVEL_ELEVATOR] = TFL_ELEVATOR;
+    aasworld.travelflagfortype[TRAVEL_ROCKETJUMP] = TFL_ROCKETJUMP;
+    aasworld.travelflagfortype[TRAVEL_BFGJUMP] = TFL_BFGJUMP;
+    aasworld.travelflagfortype[TRAVEL_GRAPPLEHOOK] = TFL_GRAPPLEHOOK;
+    aasworld.travelflagfortype[TRAVEL_DOUBLEJUMP] = TFL_DOUBLEJUMP;
+    aasworld.travelflagfortype[TRAVEL_RAMPJUMP] = TFL_RAMPJUMP;
+    aasworld.travelflagfortype[TRAVEL_STRAFEJUMP] = TFL_STRAFEJUMP;
+    aasworld.travelflagfortype[TRAVEL_JUMPPAD] = TFL_JUMPPAD;
+    aasworld.travelflagfortype[TRAVEL_FUNCBOB] = TFL_FUNCBOB;
+}
+
+int AAS_TravelFlagForType(int traveltype)
+{
+    int flags = 0;
+    if (traveltype & TRAVELFLAG_NOTTEAM1)
+    {
+        flags |= TFL_NOTTEAM1;
+    }
+    if (traveltype & TRAVELFLAG_NOTTEAM2)
+    {
+        flags |= TFL_NOTTEAM2;
+    }
+
+    int type = traveltype & TRAVELTYPE_MASK;
+    if (type < 0 || type >= MAX_TRAVELTYPES)
+    {
+        return TFL_INVALID;
+    }
+
+    flags |= aasworld.travelflagfortype[type];
+    return flags;
+}
+
+static float VectorDistance(const vec3_t a, const vec3_t b)
+{
+    float dx = a[0] - b[0];
+    float dy = a[1] - b[1];
+    float dz = a[2] - b[2];
+    return sqrtf(dx * dx + dy * dy + dz * dz);
+}
+
+static unsigned short AAS_LocalTravelTime(int areanum, const vec3_t origin)
+{
+    if (origin == NULL)
     {
         return 0;
     }
 
-    unsigned short base = cache->traveltimes[areanum];
-    if (base == 0 || base == (unsigned short)ROUTE_INVALID_TIME)
+    if (areanum <= 0 || areanum > aasworld.numAreas)
     {
         return 0;
     }
 
-    unsigned int total = base + (unsigned int)AAS_LocalTravelTime(areanum, origin);
-    if (total > ROUTE_INVALID_TIME)
+    vec3_t center;
+    VectorCopy(aasworld.areas[areanum].center, center);
+    float distance = VectorDistance(origin, center);
+    float travel = distance * 0.33f;
+    if (travel < 0.0f)
     {
-        total = ROUTE_INVALID_TIME;
+        travel = 0.0f;
+    }
+
+    if (travel >= ROUTE_INVALID_TIME)
+    {
+        return (unsigned short)ROUTE_INVALID_TIME;
     }
 
-    return (int)total;
+    return (unsigned short)travel;
 }
 
-void AAS_RouteFrameResetDiagnostics(void)
+static uint64_t AAS_MoverModelBit(int modelnum)
 {
-    memset(&g_route_frame_state, 0, sizeof(g_route_frame_state));
+    int bit = AAS_MoverModelBitIndex(modelnum);
+    return (bit >= 0) ? (uint64_t)1U << bit : 0U;
 }
 
-static int AAS_ReadIntLibVar(libvar_t *var)
+static bool AAS_RouteKernelReserve(aas_route_kernel_t *kernel, int count, int numBuckets)
 {
-    if (var == NULL)
+    if (count > kernel->capacity)
     {
-        return 0;
+        free(kernel->times);
+        free(kernel->reach);
+        free(kernel->mover);
+        free(kernel->area);
+        free(kernel->next);
+        free(kernel->prev);
+        kernel->times = (unsigned int *)malloc((size_t)count * sizeof(unsigned int));
+        kernel->reach = (unsigned char *)malloc((size_t)count);
+        kernel->mover = (unsigned char *)malloc((size_t)count);
+        kernel->area = (int *)malloc((size_t)count * sizeof(int));
+        kernel->next = (int *)malloc((size_t)count * sizeof(int));
+        kernel->prev = (int *)malloc((size_t)count * sizeof(int));
+        kernel->capacity = count;
+        if (kernel->times == NULL || kernel->reach == NULL || kernel->mover == NULL || kernel->area == NULL
+            || kernel->next == NULL || kernel->prev == NULL)
+        {
+            AAS_RouteKernelFree(kernel);
+            return false;
+        }
     }
 
-    return (int)var->value;
+    if (numBuckets > kernel->numBuckets)
+    {
+        free(kernel->buckets);
+        kernel->buckets = (int *)malloc((size_t)numBuckets * sizeof(int));
+        kernel->numBuckets = numBuckets;
+        if (kernel->buckets == NULL)
+        {
+            AAS_RouteKernelFree(kernel);
+            return false;
+        }
+    }
+
+    return true;
 }
 
-static bool AAS_LibVarEnabled(libvar_t *var)
+static void AAS_RouteKernelLink(aas_route_kernel_t *kernel, int index, int bucket)
 {
-    if (var == NULL)
+    int head = kernel->buckets[bucket];
+    kernel->next[index] = head;
+    kernel->prev[index] = -1;
+    if (head >= 0)
     {
-        return false;
+        kernel->prev[head] = index;
     }
+    kernel->buckets[bucket] = index;
+}
 
-    return var->value != 0.0f;
+static void AAS_RouteKernelUnlink(aas_route_kernel_t *kernel, int index, int bucket)
+{
+    int next = kernel->next[index];
+    int prev = kernel->prev[index];
+    if (prev >= 0)
+    {
+        kernel->next[prev] = next;
+    }
+    else
+    {
+        kernel->buckets[bucket] = next;
+    }
+    if (next >= 0)
+    {
+        kernel->prev[next] = prev;
+    }
 }
 
-void AAS_RouteFrameUpdate(void)
+/*
+ * Dial's algorithm over the reversed edges.  Every edge costs at most
+ * maxReverseEdgeCost, so all queued times fall within that many units of the
+ * current one and a circular array of maxcost + 1 buckets orders them with
+ * O(1) insert, decrease and pop.  Cluster 0 searches the whole map indexed by
+ * area number; otherwise the search stays inside the cluster and indexes by
+ * cluster area number.  All search state lives in the kernel, so a search
+ * can pause between two settled areas and resume later.  When an area
+ * settles over a mover reachability, the mover's bit goes into the cache, so
+ * a moving brush model only drops the caches whose routes ride it.
+ */
+static bool AAS_RouteSearchBegin(aas_route_kernel_t *kernel, aas_routingcache_t *cache, int goalIndex)
 {
-    int budget = AAS_ReadIntLibVar(Bridge_FrameReachability());
-    g_route_frame_state.last_budget = budget;
-    g_route_frame_state.forcewrite_active = AAS_LibVarEnabled(Bridge_ForceWrite());
+    int count = cache->numTraveltimes;
+    int numBuckets = (int)aasworld.maxReverseEdgeCost + 1;
+    if (!AAS_RouteKernelReserve(kernel, count, numBuckets))
+    {
+        return false;
+    }
 
-    if (budget <= 0)
+    for (int index = 0; index < count; ++index)
     {
-        g_route_frame_state.frames_skipped += 1;
-        return;
+        kernel->times[index] = ROUTE_UNSEEN;
+    }
+    for (int bucket = 0; bucket < kernel->numBuckets; ++bucket)
+    {
+        kernel->buckets[bucket] = -1;
     }
 
-    g_route_frame_state.frames_with_work += 1;
+    kernel->times[goalIndex] = 0;
+    kernel->reach[goalIndex] = (unsigned char)ROUTE_NO_REACH;
+    kernel->mover[goalIndex] = (unsigned char)AAS_REVERSEEDGE_NONE;
+    kernel->area[goalIndex] = cache->goalArea;
+    AAS_RouteKernelLink(kernel, goalIndex, 0);
+    kernel->time = 0U;
+    kernel->queued = 1;
+    return true;
+}
 
-    /* Ensure the routing cache table exists as part of the maintenance pass. */
-    (void)RouteCache_EnsureTable();
+static bool AAS_RouteSearchDone(const aas_route_kernel_t *kernel)
+{
+    return kernel->queued <= 0 || kernel->time >= ROUTE_INVALID_TIME;
 }
 
-int AAS_RouteFrameWorkCounter(void)
+/*
+ * Settles up to budget areas (all of them when budget is negative) and
+ * returns how many it settled.  The search pauses between two settles, so
+ * calling again with the same kernel picks up where it stopped.
+ */
+static int AAS_RouteSearchRun(aas_route_kernel_t *kernel, aas_routingcache_t *cache, int budget)
 {
-    return g_route_frame_state.frames_with_work;
+    const int *offsets = aasworld.reverseEdgeOffsets;
+    const aas_reverseedge_t *edges = aasworld.reverseEdges;
+    int numAreas = aasworld.numAreas;
+    int count = cache->numTraveltimes;
+    int cluster = cache->cluster;
+    unsigned int numBuckets = (unsigned int)kernel->numBuckets;
+    int settled = 0;
+
+    for (; !AAS_RouteSearchDone(kernel); ++kernel->time)
+    {
+        unsigned int time = kernel->time;
+        int bucket = (int)(time % numBuckets);
+        while (kernel->buckets[bucket] >= 0)
+        {
+            if (budget >= 0 && settled >= budget)
+            {
+                return settled;
+            }
+
+            int index = kernel->buckets[bucket];
+            AAS_RouteKernelUnlink(kernel, index, bucket);
+            kernel->queued -= 1;
+            settled += 1;
+
+            cache->traveltimes[index] = (unsigned short)time;
+            cache->reachabilities[index] = kernel->reach[index];
+            if (kernel->mover[index] != AAS_REVERSEEDGE_NONE)
+            {
+                cache->moverModels |= (uint64_t)1U << kernel->mover[index];
+            }
+
+            int area = kernel->area[index];
+            for (int edgeIndex = offsets[area]; edgeIndex < offsets[area + 1]; ++edgeIndex)
+            {
+                const aas_reverseedge_t *edge = &edges[edgeIndex];
+                if ((edge->travelflags & cache->travelflags) != edge->travelflags)
+                {
+                    continue;
+                }
+
+                int startIndex = edge->startArea;
+                if (cluster > 0)
+                {
+                    startIndex = AAS_ClusterAreaNum(cluster, edge->startArea);
+                }
+                if (startIndex < 0 || startIndex >= count || edge->startArea > numAreas)
+                {
+                    continue;
+                }
+
+                unsigned int cost = time + edge->cost;
+                if (cache->traveltimes[startIndex] != ROUTE_INVALID_TIME || cost >= ROUTE_INVALID_TIME
+                    || cost >= kernel->times[startIndex])
+                {
+                    continue;
+                }
+
+                if (kernel->times[startIndex] != ROUTE_UNSEEN)
+                {
+                    int previous = (int)(kernel->times[startIndex] % numBuckets);
+                    AAS_RouteKernelUnlink(kernel, startIndex, previous);
+                    kernel->queued -= 1;
+                }
+
+                kernel->times[startIndex] = cost;
+                kernel->reach[startIndex] = edge->reachOffset;
+                kernel->mover[startIndex] = edge->moverBit;
+                kernel->area[startIndex] = edge->startArea;
+                AAS_RouteKernelLink(kernel, startIndex, (int)(cost % numBuckets));
+                kernel->queued += 1;
+            }
+        }
+    }
+
+    return settled;
 }
 
-int AAS_RouteFrameSkipCounter(void)
+static int AAS_RouteCacheReach(const aas_routingcache_t *cache, int index, int areanum)
 {
-    return g_route_frame_state.frames_skipped;
+    if (cache->type == AAS_ROUTECACHE_PORTAL || index < 0 || index >= cache->numTraveltimes)
+    {
+        return 0;
+    }
+
+    unsigned char offset = RouteCache_EntryReach(cache, index);
+    if (offset == ROUTE_NO_REACH)
+    {
+        return 0;
+    }
+
+    return aasworld.areasettings[areanum].firstreachablearea + offset;
 }
 
-int AAS_RouteFrameLastBudget(void)
+static int AAS_AreaCluster(int areanum)
 {
-    return g_route_frame_state.last_budget;
+    if (aasworld.areasettings == NULL || areanum <= 0 || areanum >= aasworld.numAreaSettings)
+    {
+        return 0;
+    }
+
+    return aasworld.areasettings[areanum].cluster;
 }
 
-bool AAS_RouteFrameForceWriteActive(void)
+int AAS_ClusterAreaNum(int cluster, int areanum)
 {
-    return g_route_frame_state.forcewrite_active;
+    if (!aasworld.clusterRouting || cluster <= 0 || cluster >= aasworld.numClusters)
+    {
+        return -1;
+    }
+
+    int areaCluster = AAS_AreaCluster(areanum);
+    if (areaCluster > 0)
+    {
+        return (areaCluster == cluster) ? aasworld.areasettings[areanum].clusterareanum : -1;
+    }
+
+    if (areaCluster < 0)
+    {
+        const aas_portal_t *portal = &aasworld.portals[-areaCluster];
+        if (portal->frontcluster == cluster)
+        {
+            return portal->clusterareanum[0];
+        }
+        if (portal->backcluster == cluster)
+        {
+            return portal->clusterareanum[1];
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Readies a world or cluster cache for its search and returns the index of
+ * the goal, or -1 when there is nothing to search.  Cluster caches hold the
+ * travel time from every area of one cluster (its bounding portals included)
+ * to a goal area inside that cluster.  That search never leaves the cluster,
+ * so the cache is indexed by cluster area number and is shared by every goal
+ * that routes through the same portal.
+ */
+static int AAS_RouteCacheGoalIndex(aas_routingcache_t *cache)
+{
+    if (aasworld.reverseEdgeOffsets == NULL)
+    {
+        return -1;
+    }
+
+    if (cache->type == AAS_ROUTECACHE_CLUSTER)
+    {
+        int goalIndex = AAS_ClusterAreaNum(cache->cluster, cache->goalArea);
+        return (goalIndex >= 0 && goalIndex < cache->numTraveltimes) ? goalIndex : -1;
+    }
+
+    int numAreas = aasworld.numAreas;
+    if (numAreas <= 0 || cache->numTraveltimes <= numAreas)
+    {
+        return -1;
+    }
+
+    for (int area = 0; area <= numAreas; ++area)
+    {
+        cache->traveltimes[area] = (unsigned short)ROUTE_INVALID_TIME;
+    }
+
+    return (cache->goalArea > 0 && cache->goalArea <= numAreas) ? cache->goalArea : -1;
+}
+
+/* Runs the whole search of a world or cluster cache. */
+static void AAS_PopulateRouteCache(aas_route_kernel_t *kernel, aas_routingcache_t *cache)
+{
+    int goalIndex = AAS_RouteCacheGoalIndex(cache);
+    if (goalIndex >= 0 && AAS_RouteSearchBegin(kernel, cache, goalIndex))
+    {
+        (void)AAS_RouteSearchRun(kernel, cache, -1);
+    }
+}
+
+static aas_routingcache_t *RouteCache_Get(int type, int cluster, int goalArea, int travelflags, bool *pending);
+static void RouteCache_ContinueWithinBudget(aas_routingcache_t *cache);
+
+/* Mover bits along the stored route from areanum to the goal of a cluster cache. */
+static uint64_t AAS_ClusterRouteMovers(const aas_routingcache_t *cache, int areanum)
+{
+    uint64_t movers = 0U;
+    int area = areanum;
+    for (int steps = 0; steps < cache->numTraveltimes && area != cache->goalArea; ++steps)
+    {
+        int index = AAS_ClusterAreaNum(cache->cluster, area);
+        int reachnum = AAS_RouteCacheReach(cache, index, area);
+        if (reachnum <= 0)
+        {
+            break;
+        }
+
+        const aas_reachability_t *reach = &aasworld.reachability[reachnum];
+        int traveltype = reach->traveltype & TRAVELTYPE_MASK;
+        if (traveltype == TRAVEL_ELEVATOR || traveltype == TRAVEL_FUNCBOB)
+        {
+            movers |= AAS_MoverModelBit(reach->facenum & 0x0000FFFF);
+        }
+        area = reach->areanum;
+    }
+
+    return movers;
+}
+
+/*
+ * Travel time inside cluster from areanum to goalArea.  outMovers is for
+ * callers that keep the result: they only take finished legs, so a pending
+ * leg spends this frame's budget and reports ROUTE_PENDING_TIME until done.
+ * The mover bits of a finished leg are reported.
+ */
+static unsigned int AAS_ClusterTravelTime(int cluster,
+                                          int areanum,
+                                          int goalArea,
+                                          int travelflags,
+                                          uint64_t *outMovers,
+                                          int *outReach)
+{
+    int index = AAS_ClusterAreaNum(cluster, areanum);
+    if (index < 0)
+    {
+        return ROUTE_INVALID_TIME;
+    }
+
+    aas_routingcache_t *cache = RouteCache_Get(AAS_ROUTECACHE_CLUSTER, cluster, goalArea, travelflags, NULL);
+    if (cache == NULL || index >= cache->numTraveltimes)
+    {
+        return ROUTE_INVALID_TIME;
+    }
+
+    if (outMovers != NULL)
+    {
+        if (cache->frontier != NULL)
+        {
+            RouteCache_ContinueWithinBudget(cache);
+            if (cache->frontier != NULL)
+            {
+                return ROUTE_PENDING_TIME;
+            }
+        }
+        *outMovers = (cache->moverModels != 0U) ? AAS_ClusterRouteMovers(cache, areanum) : 0U;
+    }
+
+    if (outReach != NULL)
+    {
+        *outReach = AAS_RouteCacheReach(cache, index, areanum);
+    }
+
+    return RouteCache_EntryTime(cache, index);
+}
+
+/*
+ * Queues the portals of cluster reachable from fromArea; false when the heap
+ * cannot grow.  pending is set when a leg is still being searched.
+ */
+static bool AAS_RelaxClusterPortals(routing_minheap_t *heap,
+                                    aas_routingcache_t *portalCache,
+                                    int cluster,
+                                    int fromArea,
+                                    unsigned int baseTime,
+                                    bool *pending)
+{
+    const aas_cluster_t *info = &aasworld.clusters[cluster];
+    for (int index = 0; index < info->numportals; ++index)
+    {
+        int portalnum = aasworld.portalIndex[info->firstportal + index];
+        int portalArea = aasworld.portals[portalnum].areanum;
+        if (portalArea == fromArea)
+        {
+            continue;
+        }
+
+        uint64_t legMovers = 0U;
+        unsigned int leg =
+            AAS_ClusterTravelTime(cluster, portalArea, fromArea, portalCache->travelflags, &legMovers, NULL);
+        if (leg == ROUTE_PENDING_TIME)
+        {
+            *pending = true;
+            continue;
+        }
+        if (leg == ROUTE_INVALID_TIME)
+        {
+            continue;
+        }
+
+        unsigned int cost = baseTime + leg;
+        if (cost >= portalCache->traveltimes[portalnum])
+        {
+            continue;
+        }
+
+        if (!Heap_Push(heap, portalnum, cost, legMovers))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Portal caches store the travel time from every cluster portal to the goal
+ * area.  The search runs over portals only, using the cluster caches of the
+ * portal areas as edge weights, so its size is independent of the area count.
+ * Returns false when the search ran out of memory.  pending is set when a
+ * cluster leg has not finished within this frame's budget.  Either way the
+ * times are partial and the cache must not be kept.
+ */
+static bool AAS_PopulatePortalRouteCache(aas_routingcache_t *cache, bool *pending)
+{
+    if (cache == NULL || cache->numTraveltimes < aasworld.numPortals)
+    {
+        return true;
+    }
+
+    routing_minheap_t heap;
+    if (!Heap_Init(&heap, 32))
+    {
+        return false;
+    }
+
+    bool ok = true;
+    int goalCluster = AAS_AreaCluster(cache->goalArea);
+    if (goalCluster < 0)
+    {
+        ok = Heap_Push(&heap, -goalCluster, 0, 0U) != 0;
+    }
+    else if (goalCluster > 0)
+    {
+        ok = AAS_RelaxClusterPortals(&heap, cache, goalCluster, cache->goalArea, 0, pending);
+    }
+
+    while (ok && heap.size > 0)
+    {
+        routing_heap_node_t node = Heap_Pop(&heap);
+        int portalnum = node.area;
+        if (portalnum <= 0 || portalnum >= aasworld.numPortals)
+        {
+            continue;
+        }
+
+        if (node.time >= cache->traveltimes[portalnum])
+        {
+            continue;
+        }
+
+        cache->traveltimes[portalnum] = (unsigned short)node.time;
+        cache->moverModels |= node.movers;
+
+        const aas_portal_t *portal = &aasworld.portals[portalnum];
+        ok = AAS_RelaxClusterPortals(&heap, cache, portal->frontcluster, portal->areanum, node.time, pending);
+        if (ok && portal->backcluster != portal->frontcluster)
+        {
+            ok = AAS_RelaxClusterPortals(&heap, cache, portal->backcluster, portal->areanum, node.time, pending);
+        }
+    }
+
+    Heap_Destroy(&heap);
+    return ok;
+}
+
+static int RouteCache_EntryCount(int type, int cluster)
+{
+    if (type == AAS_ROUTECACHE_CLUSTER)
+    {
+        return aasworld.clusters[cluster].numareas;
+    }
+    if (type == AAS_ROUTECACHE_PORTAL)
+    {
+        return aasworld.numPortals;
+    }
+    return aasworld.numAreas + 1;
+}
+
+void AAS_RegisterRouteGoalArea(int areanum)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+    if (!aasworld.loaded || pre->started || areanum <= 0 || areanum > aasworld.numAreas)
+    {
+        return;
+    }
+
+    for (int index = 0; index < pre->numGoalAreas; ++index)
+    {
+        if (pre->goalAreas[index] == areanum)
+        {
+            return;
+        }
+    }
+
+    if (pre->numGoalAreas >= pre->maxGoalAreas)
+    {
+        int capacity = (pre->maxGoalAreas > 0) ? pre->maxGoalAreas * 2 : 64;
+        int *areas = (int *)realloc(pre->goalAreas, (size_t)capacity * sizeof(int));
+        if (areas == NULL)
+        {
+            return;
+        }
+        pre->goalAreas = areas;
+        pre->maxGoalAreas = capacity;
+    }
+
+    pre->goalAreas[pre->numGoalAreas++] = areanum;
+}
+
+void AAS_ShutdownRoutePrecompute(void)
+{
+    AAS_RoutePrecomputeStop();
+
+    free(g_route_precompute.goalAreas);
+    g_route_precompute.goalAreas = NULL;
+    g_route_precompute.numGoalAreas = 0;
+    g_route_precompute.maxGoalAreas = 0;
+    g_route_precompute.started = false;
+}
+
+#ifndef _WIN32
+
+static aas_route_job_t *AAS_RoutePrecomputeFindJob(int type, int cluster, int goalArea, int travelflags)
+{
+    travelflags = RouteCache_KeyTravelFlags(travelflags);
+    for (int index = 0; index < g_route_precompute.numJobs; ++index)
+    {
+        aas_route_job_t *job = &g_route_precompute.jobs[index];
+        const aas_routingcache_t *cache = job->cache;
+        if (job->state != ROUTE_JOB_RETIRED && cache->goalArea == goalArea
+            && cache->travelflags == travelflags && cache->type == type && cache->cluster == cluster)
+        {
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+/* Queues one search unless its cache already exists; false once the budget is spent. */
+static bool AAS_RoutePrecomputeAddJob(int type, int cluster, int goalArea, int travelflags, size_t *bytes)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+    if (RouteCache_Find(type, cluster, goalArea, travelflags) != NULL
+        || AAS_RoutePrecomputeFindJob(type, cluster, goalArea, travelflags) != NULL)
+    {
+        return true;
+    }
+
+    int numTraveltimes = RouteCache_EntryCount(type, cluster);
+    size_t size = sizeof(aas_routingcache_t) + (size_t)numTraveltimes * RouteCache_EntryBytes(type);
+    size_t budget = RouteCache_Budget();
+    if (budget != 0U && aasworld.routingCacheBytes + *bytes + size > budget)
+    {
+        return false;
+    }
+
+    if (pre->numJobs >= pre->maxJobs)
+    {
+        int capacity = (pre->maxJobs > 0) ? pre->maxJobs * 2 : 64;
+        aas_route_job_t *jobs = (aas_route_job_t *)realloc(pre->jobs, (size_t)capacity * sizeof(aas_route_job_t));
+        if (jobs == NULL)
+        {
+            return false;
+        }
+        pre->jobs = jobs;
+        pre->maxJobs = capacity;
+    }
+
+    aas_routingcache_t *cache = RouteCache_Alloc(type, cluster, goalArea, travelflags, numTraveltimes);
+    if (cache == NULL)
+    {
+        return false;
+    }
+
+    pre->jobs[pre->numJobs].cache = cache;
+    pre->jobs[pre->numJobs].state = ROUTE_JOB_QUEUED;
+    pre->numJobs += 1;
+    pre->pending += 1;
+    *bytes += size;
+    return true;
+}
+
+/* Cluster caches towards goalArea from each cluster it belongs to. */
+static bool AAS_RoutePrecomputeAddClusterJobs(int goalArea, int travelflags, size_t *bytes)
+{
+    int cluster = AAS_AreaCluster(goalArea);
+    if (cluster > 0)
+    {
+        return AAS_RoutePrecomputeAddJob(AAS_ROUTECACHE_CLUSTER, cluster, goalArea, travelflags, bytes);
+    }
+
+    if (cluster < 0)
+    {
+        const aas_portal_t *portal = &aasworld.portals[-cluster];
+        if (!AAS_RoutePrecomputeAddJob(AAS_ROUTECACHE_CLUSTER, portal->frontcluster, goalArea, travelflags, bytes))
+        {
+            return false;
+        }
+        if (portal->backcluster != portal->frontcluster)
+        {
+            return AAS_RoutePrecomputeAddJob(AAS_ROUTECACHE_CLUSTER, portal->backcluster, goalArea, travelflags, bytes);
+        }
+    }
+
+    return true;
+}
+
+/*
+ * With cluster routing the item goals need their own cluster caches plus the
+ * portal-to-portal legs every portal search reads; the portal searches
+ * themselves stay on the main thread and only hit cached legs.
+ */
+static void AAS_RoutePrecomputeQueue(int travelflags, size_t *bytes)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+
+    if (!aasworld.clusterRouting)
+    {
+        for (int index = 0; index < pre->numGoalAreas; ++index)
+        {
+            if (!AAS_RoutePrecomputeAddJob(AAS_ROUTECACHE_WORLD, 0, pre->goalAreas[index], travelflags, bytes))
+            {
+                return;
+            }
+        }
+        return;
+    }
+
+    for (int index = 0; index < pre->numGoalAreas; ++index)
+    {
+        if (!AAS_RoutePrecomputeAddClusterJobs(pre->goalAreas[index], travelflags, bytes))
+        {
+            return;
+        }
+    }
+
+    for (int portalnum = 1; portalnum < aasworld.numPortals; ++portalnum)
+    {
+        if (!AAS_RoutePrecomputeAddClusterJobs(aasworld.portals[portalnum].areanum, travelflags, bytes))
+        {
+            return;
+        }
+    }
+}
+
+static void *AAS_RoutePrecomputeWorker(void *arg)
+{
+    aas_route_precompute_t *pre = (aas_route_precompute_t *)arg;
+    aas_route_kernel_t kernel;
+    memset(&kernel, 0, sizeof(kernel));
+
+    pthread_mutex_lock(&pre->lock);
+    while (!pre->cancel && pre->nextJob < pre->numJobs)
+    {
+        aas_route_job_t *job = &pre->jobs[pre->nextJob++];
+        if (job->state != ROUTE_JOB_QUEUED)
+        {
+            continue;
+        }
+
+        job->state = ROUTE_JOB_RUNNING;
+        pthread_mutex_unlock(&pre->lock);
+
+        AAS_PopulateRouteCache(&kernel, job->cache);
+        if (pre->compact)
+        {
+            RouteCache_Compact(job->cache);
+        }
+
+        pthread_mutex_lock(&pre->lock);
+        job->state = ROUTE_JOB_DONE;
+        pthread_cond_broadcast(&pre->finished);
+    }
+    pthread_mutex_unlock(&pre->lock);
+
+    AAS_RouteKernelFree(&kernel);
+    return NULL;
+}
+
+/* Main thread only, with the lock held: move a finished cache into the table. */
+static aas_routingcache_t *AAS_RoutePrecomputeRetire(aas_route_job_t *job)
+{
+    aas_routingcache_t *cache = job->cache;
+    bool publish = (job->state == ROUTE_JOB_DONE)
+                   && (cache->moverModels & g_route_precompute.invalidatedModels) == 0U;
+
+    job->state = ROUTE_JOB_RETIRED;
+    g_route_precompute.pending -= 1;
+
+    if (!publish)
+    {
+        RouteCache_Destroy(cache);
+        return NULL;
+    }
+
+    RouteCache_EvictForBudget(cache->size);
+    RouteCache_Insert(cache);
+    return cache;
+}
+
+static void AAS_RoutePrecomputeStart(void)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+    if (pre->started || pre->numGoalAreas <= 0 || !AAS_RouteGraphReady())
+    {
+        return;
+    }
+
+    int threads = AAS_ReadIntLibVar(Bridge_RoutePrecompute());
+    if (threads <= 0)
+    {
+        return;
+    }
+    if (threads > ROUTE_PRECOMPUTE_MAX_THREADS)
+    {
+        threads = ROUTE_PRECOMPUTE_MAX_THREADS;
+    }
+
+    pre->started = true;
+    pre->compact = RouteCache_CompactEnabled();
+    if (!RouteCache_EnsureTable())
+    {
+        return;
+    }
+
+    size_t bytes = 0U;
+    AAS_RoutePrecomputeQueue(TFL_DEFAULT, &bytes);
+    if (AAS_LibVarEnabled(Bridge_RocketJump()))
+    {
+        AAS_RoutePrecomputeQueue(TFL_DEFAULT | TFL_ROCKETJUMP, &bytes);
+    }
+
+    if (pre->numJobs == 0)
+    {
+        AAS_RoutePrecomputeStop();
+        return;
+    }
+
+    if (threads > pre->numJobs)
+    {
+        threads = pre->numJobs;
+    }
+
+    for (int index = 0; index < threads; ++index)
+    {
+        if (pthread_create(&pre->threads[pre->numThreads], NULL, AAS_RoutePrecomputeWorker, pre) != 0)
+        {
+            break;
+        }
+        pre->numThreads += 1;
+    }
+
+    if (pre->numThreads == 0)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_RoutePrecompute: could not start worker threads\n");
+        AAS_RoutePrecomputeStop();
+        return;
+    }
+
+    BotLib_Print(PRT_MESSAGE,
+                 "AAS: precomputing %d route caches on %d threads\n",
+                 pre->numJobs,
+                 pre->numThreads);
+}
+
+static void AAS_RoutePrecomputePublish(void)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+    if (pre->numJobs == 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pre->lock);
+    for (int index = 0; index < pre->numJobs; ++index)
+    {
+        if (pre->jobs[index].state == ROUTE_JOB_DONE)
+        {
+            (void)AAS_RoutePrecomputeRetire(&pre->jobs[index]);
+        }
+    }
+    bool complete = (pre->pending == 0);
+    pthread_mutex_unlock(&pre->lock);
+
+    if (complete)
+    {
+        AAS_RoutePrecomputeStop();
+    }
+}
+
+/*
+ * Called on a cache miss.  A finished or running job is published (waiting
+ * for it if needed); a job no worker has picked up yet is dropped so the
+ * caller can run the search itself without waiting.
+ */
+static aas_routingcache_t *AAS_RoutePrecomputeClaim(int type, int cluster, int goalArea, int travelflags)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+    if (pre->numJobs == 0)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pre->lock);
+    aas_route_job_t *job = AAS_RoutePrecomputeFindJob(type, cluster, goalArea, travelflags);
+    if (job == NULL)
+    {
+        pthread_mutex_unlock(&pre->lock);
+        return NULL;
+    }
+
+    while (job->state == ROUTE_JOB_RUNNING)
+    {
+        pthread_cond_wait(&pre->finished, &pre->lock);
+    }
+
+    aas_routingcache_t *cache = AAS_RoutePrecomputeRetire(job);
+    pthread_mutex_unlock(&pre->lock);
+    return cache;
+}
+
+/* True once a worker has picked the search up, so claiming it beats searching again. */
+static bool AAS_RoutePrecomputeHasCache(int type, int cluster, int goalArea, int travelflags)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+    if (pre->numJobs == 0)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&pre->lock);
+    const aas_route_job_t *job = AAS_RoutePrecomputeFindJob(type, cluster, goalArea, travelflags);
+    bool started = job != NULL && job->state != ROUTE_JOB_QUEUED;
+    pthread_mutex_unlock(&pre->lock);
+    return started;
+}
+
+static void AAS_RoutePrecomputeStop(void)
+{
+    aas_route_precompute_t *pre = &g_route_precompute;
+
+    pthread_mutex_lock(&pre->lock);
+    pre->cancel = true;
+    pthread_mutex_unlock(&pre->lock);
+
+    for (int index = 0; index < pre->numThreads; ++index)
+    {
+        pthread_join(pre->threads[index], NULL);
+    }
+    pre->numThreads = 0;
+
+    for (int index = 0; index < pre->numJobs; ++index)
+    {
+        if (pre->jobs[index].state != ROUTE_JOB_RETIRED)
+        {
+            RouteCache_Destroy(pre->jobs[index].cache);
+        }
+    }
+
+    free(pre->jobs);
+    pre->jobs = NULL;
+    pre->numJobs = 0;
+    pre->maxJobs = 0;
+    pre->nextJob = 0;
+    pre->pending = 0;
+    pre->cancel = false;
+    pre->invalidatedModels = 0U;
+}
+
+#else
+
+/* No worker threads on this platform; every cache is built on demand. */
+static void AAS_RoutePrecomputeStart(void)
+{
+}
+
+static void AAS_RoutePrecomputePublish(void)
+{
+}
+
+static aas_routingcache_t *AAS_RoutePrecomputeClaim(int type, int cluster, int goalArea, int travelflags)
+{
+    (void)type;
+    (void)cluster;
+    (void)goalArea;
+    (void)travelflags;
+    return NULL;
+}
+
+static bool AAS_RoutePrecomputeHasCache(int type, int cluster, int goalArea, int travelflags)
+{
+    (void)type;
+    (void)cluster;
+    (void)goalArea;
+    (void)travelflags;
+    return false;
+}
+
+static void AAS_RoutePrecomputeStop(void)
+{
+}
+
+#endif
+
+/* Compacts a finished cache when routecompact is set, keeping the byte count in step. */
+static void RouteCache_CompactCharged(aas_routingcache_t *cache)
+{
+    if (cache->type == AAS_ROUTECACHE_PORTAL || !RouteCache_CompactEnabled())
+    {
+        return;
+    }
+
+    size_t flatSize = cache->size;
+    RouteCache_Compact(cache);
+    aasworld.routingCacheBytes -= flatSize - cache->size;
+}
+
+static size_t RouteCache_FrontierBytes(const aas_route_kernel_t *kernel)
+{
+    size_t perEntry = sizeof(unsigned int) + sizeof(unsigned char) + 3U * sizeof(int);
+    return sizeof(*kernel) + (size_t)kernel->capacity * perEntry + (size_t)kernel->numBuckets * sizeof(int);
+}
+
+static void RouteCache_FinishPending(aas_routingcache_t *cache)
+{
+    size_t bytes = RouteCache_FrontierBytes(cache->frontier);
+    AAS_RouteKernelFree(cache->frontier);
+    free(cache->frontier);
+    cache->frontier = NULL;
+
+    cache->size -= bytes;
+    aasworld.routingCacheBytes -= bytes;
+    RouteCache_CompactCharged(cache);
+}
+
+/* Resumes the search of a pending cache for up to budget settles, all when negative. */
+static int RouteCache_ContinuePending(aas_routingcache_t *cache, int budget)
+{
+    int settled = AAS_RouteSearchRun(cache->frontier, cache, budget);
+    if (AAS_RouteSearchDone(cache->frontier))
+    {
+        RouteCache_FinishPending(cache);
+    }
+    return settled;
+}
+
+/* Resumes a pending cache with what is left of this frame's budget, or to the end without one. */
+static void RouteCache_ContinueWithinBudget(aas_routingcache_t *cache)
+{
+    if (AAS_ReadIntLibVar(Bridge_FrameReachability()) <= 0)
+    {
+        (void)RouteCache_ContinuePending(cache, -1);
+        return;
+    }
+
+    g_route_frame_state.remaining -= RouteCache_ContinuePending(cache, g_route_frame_state.remaining);
+}
+
+/*
+ * With framereachability set, a new world or cluster cache only spends what
+ * is left of this frame's budget; AAS_RouteFrameUpdate resumes it on later
+ * frames.  Returns false when the search has to run to completion now.
+ */
+static bool RouteCache_BeginPending(aas_routingcache_t *cache)
+{
+    if (AAS_ReadIntLibVar(Bridge_FrameReachability()) <= 0)
+    {
+        return false;
+    }
+
+    int goalIndex = AAS_RouteCacheGoalIndex(cache);
+    if (goalIndex < 0)
+    {
+        return false;
+    }
+
+    aas_route_kernel_t *kernel = (aas_route_kernel_t *)calloc(1, sizeof(aas_route_kernel_t));
+    if (kernel == NULL)
+    {
+        return false;
+    }
+    if (!AAS_RouteSearchBegin(kernel, cache, goalIndex))
+    {
+        free(kernel);
+        return false;
+    }
+
+    size_t bytes = RouteCache_FrontierBytes(kernel);
+    cache->frontier = kernel;
+    cache->size += bytes;
+    aasworld.routingCacheBytes += bytes;
+
+    g_route_frame_state.remaining -= RouteCache_ContinuePending(cache, g_route_frame_state.remaining);
+    return true;
+}
+
+/*
+ * Finds or builds a cache.  Portal caches are only kept complete: when one of
+ * their cluster legs is still pending the cache is dropped again, pending is
+ * set and NULL returned, and a later call retries once the legs have moved on.
+ */
+static aas_routingcache_t *RouteCache_Get(int type, int cluster, int goalArea, int travelflags, bool *pending)
+{
+    if (pending != NULL)
+    {
+        *pending = false;
+    }
+
+    aas_routingcache_t *cache = RouteCache_Find(type, cluster, goalArea, travelflags);
+    if (cache == NULL)
+    {
+        cache = AAS_RoutePrecomputeClaim(type, cluster, goalArea, travelflags);
+    }
+    if (cache != NULL)
+    {
+        g_route_cache_stats.hits += 1;
+        return cache;
+    }
+
+    g_route_cache_stats.misses += 1;
+
+    int numTraveltimes = RouteCache_EntryCount(type, cluster);
+
+    size_t incoming = sizeof(aas_routingcache_t) + (size_t)numTraveltimes * RouteCache_EntryBytes(type);
+    RouteCache_EvictForBudget(incoming);
+
+    cache = RouteCache_Alloc(type, cluster, goalArea, travelflags, numTraveltimes);
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    /*
+     * Insert before populating: portal searches fetch cluster caches while
+     * they run and must never see this entry half-linked.  The pin keeps the
+     * nested lookups from evicting it.
+     */
+    RouteCache_Insert(cache);
+    cache->pinned += 1;
+
+    if (type == AAS_ROUTECACHE_PORTAL)
+    {
+        bool legsPending = false;
+        bool ok = AAS_PopulatePortalRouteCache(cache, &legsPending);
+        if (!ok || legsPending)
+        {
+            if (!ok)
+            {
+                BotLib_Print(PRT_ERROR, "RouteCache_Get: out of memory routing to area %d\n", goalArea);
+            }
+            else if (pending != NULL)
+            {
+                *pending = true;
+            }
+            cache->pinned -= 1;
+            RouteCache_Free(cache);
+            return NULL;
+        }
+    }
+    else if (!RouteCache_BeginPending(cache))
+    {
+        AAS_PopulateRouteCache(&g_route_kernel, cache);
+        RouteCache_CompactCharged(cache);
+    }
+
+    cache->pinned -= 1;
+    return cache;
+}
+
+static int AAS_AreaSharesCluster(int areaCluster, int cluster)
+{
+    if (areaCluster > 0)
+    {
+        return areaCluster == cluster;
+    }
+
+    if (areaCluster < 0)
+    {
+        const aas_portal_t *portal = &aasworld.portals[-areaCluster];
+        return portal->frontcluster == cluster || portal->backcluster == cluster;
+    }
+
+    return 0;
+}
+
+static int AAS_CommonCluster(int areanum, int goalareanum)
+{
+    int areaCluster = AAS_AreaCluster(areanum);
+    int goalCluster = AAS_AreaCluster(goalareanum);
+
+    if (areaCluster > 0)
+    {
+        return AAS_AreaSharesCluster(goalCluster, areaCluster) ? areaCluster : 0;
+    }
+
+    if (areaCluster < 0)
+    {
+        const aas_portal_t *portal = &aasworld.portals[-areaCluster];
+        if (AAS_AreaSharesCluster(goalCluster, portal->frontcluster))
+        {
+            return portal->frontcluster;
+        }
+        if (AAS_AreaSharesCluster(goalCluster, portal->backcluster))
+        {
+            return portal->backcluster;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Best route from areanum through one of the portals bounding cluster, using
+ * the portal cache for the remainder.  The area's own portal is skipped: its
+ * portal cache entry is itself the minimum over these same legs.
+ */
+static unsigned int AAS_RouteThroughClusterPortals(int cluster,
+                                                   int areanum,
+                                                   const aas_routingcache_t *portalCache,
+                                                   int travelflags,
+                                                   int *outReach)
+{
+    unsigned int best = ROUTE_INVALID_TIME;
+    bool pending = false;
+    const aas_cluster_t *info = &aasworld.clusters[cluster];
+    for (int index = 0; index < info->numportals; ++index)
+    {
+        int portalnum = aasworld.portalIndex[info->firstportal + index];
+        int portalArea = aasworld.portals[portalnum].areanum;
+        unsigned int remaining = portalCache->traveltimes[portalnum];
+        if (portalArea == areanum || remaining == ROUTE_INVALID_TIME)
+        {
+            continue;
+        }
+
+        int reach = 0;
+        unsigned int leg = AAS_ClusterTravelTime(cluster, areanum, portalArea, travelflags, NULL, &reach);
+        if (leg == ROUTE_PENDING_TIME)
+        {
+            pending = true;
+            continue;
+        }
+        if (leg == ROUTE_INVALID_TIME)
+        {
+            continue;
+        }
+
+        if (leg + remaining < best)
+        {
+            best = leg + remaining;
+            if (outReach != NULL)
+            {
+                *outReach = reach;
+            }
+        }
+    }
+
+    return (best == ROUTE_INVALID_TIME && pending) ? ROUTE_PENDING_TIME : best;
+}
+
+/*
+ * Travel time between two areas without the in-area origin offset,
+ * ROUTE_INVALID_TIME when the goal cannot be reached with travelflags, or
+ * ROUTE_PENDING_TIME while a search paused by the frame budget owes it.
+ * outReach receives the first reachability of that route when known.
+ * Like the Quake III router, areas sharing a cluster use the cluster cache
+ * directly even if a shorter detour through another cluster exists.
+ */
+static unsigned int AAS_RouteToGoal(int areanum, int goalareanum, int travelflags, int *outReach)
+{
+    if (outReach != NULL)
+    {
+        *outReach = 0;
+    }
+
+    if (!aasworld.clusterRouting)
+    {
+        aas_routingcache_t *cache = RouteCache_Get(AAS_ROUTECACHE_WORLD, 0, goalareanum, travelflags, NULL);
+        if (cache == NULL)
+        {
+            return ROUTE_INVALID_TIME;
+        }
+
+        if (outReach != NULL)
+        {
+            *outReach = AAS_RouteCacheReach(cache, areanum, areanum);
+        }
+        return RouteCache_EntryTime(cache, areanum);
+    }
+
+    int sharedCluster = AAS_CommonCluster(areanum, goalareanum);
+    if (sharedCluster > 0)
+    {
+        unsigned int direct =
+            AAS_ClusterTravelTime(sharedCluster, areanum, goalareanum, travelflags, NULL, outReach);
+        if (direct != ROUTE_INVALID_TIME)
+        {
+            return direct;
+        }
+    }
+
+    int areaCluster = AAS_AreaCluster(areanum);
+    if (areaCluster == 0)
+    {
+        return ROUTE_INVALID_TIME;
+    }
+
+    bool pending = false;
+    aas_routingcache_t *portalCache =
+        RouteCache_Get(AAS_ROUTECACHE_PORTAL, 0, goalareanum, travelflags, &pending);
+    if (portalCache == NULL)
+    {
+        return pending ? ROUTE_PENDING_TIME : ROUTE_INVALID_TIME;
+    }
+
+    portalCache->pinned += 1;
+    unsigned int best = ROUTE_INVALID_TIME;
+    if (areaCluster > 0)
+    {
+        best = AAS_RouteThroughClusterPortals(areaCluster, areanum, portalCache, travelflags, outReach);
+    }
+    else
+    {
+        const aas_portal_t *portal = &aasworld.portals[-areaCluster];
+        int frontReach = 0;
+        int backReach = 0;
+        best = AAS_RouteThroughClusterPortals(portal->frontcluster, areanum, portalCache, travelflags, &frontReach);
+        unsigned int back =
+            AAS_RouteThroughClusterPortals(portal->backcluster, areanum, portalCache, travelflags, &backReach);
+        if (back < best || (best == ROUTE_INVALID_TIME && back == ROUTE_PENDING_TIME))
+        {
+            best = back;
+            frontReach = backReach;
+        }
+        if (outReach != NULL)
+        {
+            *outReach = frontReach;
+        }
+    }
+    portalCache->pinned -= 1;
+
+    return best;
+}
+
+qboolean AAS_RouteGraphReady(void)
+{
+    if (!aasworld.loaded || aasworld.areasettings == NULL || aasworld.reachability == NULL)
+    {
+        return qfalse;
+    }
+
+    return (aasworld.reverseEdgeOffsets != NULL && aasworld.reachabilityFromArea != NULL) ? qtrue
+                                                                                        : qfalse;
+}
+
+/* Row of the all-pairs matrix towards goalareanum, or NULL when the caches must answer. */
+static const unsigned short *AAS_RouteMatrixRow(int goalareanum, int travelflags)
+{
+    const aas_route_matrix_t *matrix = &g_route_matrix;
+    if (matrix->times == NULL || RouteCache_KeyTravelFlags(travelflags) != matrix->travelflags)
+    {
+        return NULL;
+    }
+
+    return matrix->times + (size_t)goalareanum * (size_t)matrix->stride;
+}
+
+/*
+ * The matrix keeps no next-hop table: the first reachability is the one
+ * whose cost plus the remaining time from its end area matches the route.
+ */
+static int AAS_RouteMatrixReach(const unsigned short *row, int areanum, int travelflags)
+{
+    const aas_areasettings_t *settings = &aasworld.areasettings[areanum];
+    unsigned int best = ROUTE_INVALID_TIME;
+    int bestReach = 0;
+    for (int offset = 0; offset < settings->numreachableareas; ++offset)
+    {
+        int reachnum = settings->firstreachablearea + offset;
+        const aas_reachability_t *reach = &aasworld.reachability[reachnum];
+        int required = AAS_TravelFlagForType(reach->traveltype);
+        if ((required & travelflags) != required || reach->areanum <= 0 || reach->areanum > aasworld.numAreas)
+        {
+            continue;
+        }
+
+        unsigned int remaining = row[reach->areanum];
+        if (remaining != ROUTE_INVALID_TIME && reach->traveltime + remaining < best)
+        {
+            best = reach->traveltime + remaining;
+            bestReach = reachnum;
+        }
+    }
+
+    return bestReach;
+}
+
+int AAS_AreaTravelTimeToGoalArea(int areanum, vec3_t origin, int goalareanum, int travelflags)
+{
+    int traveltime = 0;
+    if (!AAS_AreaRouteToGoalArea(areanum, origin, goalareanum, travelflags, &traveltime, NULL))
+    {
+        return 0;
+    }
+
+    return traveltime;
+}
+
+/* Body of AAS_AreaRouteToGoalArea that also tells unreachable goals from pending ones. */
+static aas_route_status_t AAS_AreaRouteStatus(int areanum,
+                                              const vec3_t origin,
+                                              int goalareanum,
+                                              int travelflags,
+                                              int *traveltime,
+                                              int *reachnum)
+{
+    if (traveltime != NULL)
+    {
+        *traveltime = 0;
+    }
+    if (reachnum != NULL)
+    {
+        *reachnum = 0;
+    }
+
+    if (!aasworld.loaded)
+    {
+        return ROUTE_STATUS_NONE;
+    }
+
+    if (areanum <= 0 || areanum > aasworld.numAreas)
+    {
+        BotLib_Print(PRT_ERROR, "AAS_AreaRouteToGoalArea: areanum %d out of range\n", areanum);
+        return ROUTE_STATUS_NONE;
+    }
+
+    if (goalareanum <= 0 || goalareanum > aasworld.numAreas)
+    {
+        BotLib_Print(PRT_ERROR, "AAS_AreaRouteToGoalArea: goalareanum %d out of range\n", goalareanum);
+        return ROUTE_STATUS_NONE;
+    }
+
+    if (areanum == goalareanum)
+    {
+        if (traveltime != NULL)
+        {
+            *traveltime = (int)AAS_LocalTravelTime(areanum, origin);
+        }
+        return ROUTE_STATUS_FOUND;
+    }
+
+    if (!AAS_RouteGraphReady())
+    {
+        return ROUTE_STATUS_NONE;
+    }
+
+    int reach = 0;
+    unsigned int base;
+    const unsigned short *row = AAS_RouteMatrixRow(goalareanum, travelflags);
+    if (row != NULL)
+    {
+        base = row[areanum];
+        if (reachnum != NULL && base != 0 && base < ROUTE_INVALID_TIME)
+        {
+            reach = AAS_RouteMatrixReach(row, areanum, travelflags);
+        }
+    }
+    else
+    {
+        base = AAS_RouteToGoal(areanum, goalareanum, travelflags, &reach);
+    }
+    if (base == ROUTE_PENDING_TIME)
+    {
+        return ROUTE_STATUS_PENDING;
+    }
+    if (base == 0 || base >= ROUTE_INVALID_TIME)
+    {
+        return ROUTE_STATUS_NONE;
+    }
+
+    unsigned int total = base + (unsigned int)AAS_LocalTravelTime(areanum, origin);
+    if (total > ROUTE_INVALID_TIME)
+    {
+        total = ROUTE_INVALID_TIME;
+    }
+
+    if (traveltime != NULL)
+    {
+        *traveltime = (int)total;
+    }
+    if (reachnum != NULL)
+    {
+        *reachnum = reach;
+    }
+    return ROUTE_STATUS_FOUND;
+}
+
+/*
+ * Mirrors the Quake III routing entry point: reports the travel time from
+ * origin in areanum to goalareanum and the reachability to take first.  The
+ * reachability is read from the cache that produced the time, so movement
+ * needs no search of its own.  reachnum is 0 when already in the goal area.
+ */
+qboolean AAS_AreaRouteToGoalArea(int areanum,
+                                 const vec3_t origin,
+                                 int goalareanum,
+                                 int travelflags,
+                                 int *traveltime,
+                                 int *reachnum)
+{
+    aas_route_status_t status = AAS_AreaRouteStatus(areanum, origin, goalareanum, travelflags, traveltime, reachnum);
+    return (status == ROUTE_STATUS_FOUND) ? qtrue : qfalse;
+}
+
+/*
+ * True when AAS_RouteToGoal can answer for goalareanum without a new
+ * search: the matrix covers it, or its world/portal cache is already built
+ * (on demand, by the precompute workers or from the .rcd file).
+ */
+static bool AAS_RouteGoalCached(int goalareanum, int travelflags)
+{
+    if (AAS_RouteMatrixRow(goalareanum, travelflags) != NULL)
+    {
+        return true;
+    }
+
+    int type = aasworld.clusterRouting ? AAS_ROUTECACHE_PORTAL : AAS_ROUTECACHE_WORLD;
+    return RouteCache_Find(type, 0, goalareanum, travelflags) != NULL
+           || AAS_RoutePrecomputeHasCache(type, 0, goalareanum, travelflags);
+}
+
+/*
+ * Travel times from areanum to several goal areas, 0 for unreachable goals
+ * and AAS_TRAVELTIME_PENDING for goals whose route search the frame budget
+ * has paused.  Goals that share a cluster with areanum, or whose route is
+ * already cached, go through AAS_AreaRouteToGoalArea so they take the same
+ * route a single query would.  The rest are settled by one forward search
+ * that stops once all of them are reached and builds no per-goal routing
+ * cache; outside a shared cluster its times equal the portal route.  The
+ * search is kept for the frame, so later batches from the same start area
+ * resume it rather than searching again.  Under
+ * a frame budget every goal goes through its cache instead, so the budget
+ * covers the whole batch.  Returns the number of goals reached.
+ */
+int AAS_AreaTravelTimesToGoalAreas(int areanum,
+                                   const vec3_t origin,
+                                   const int *goalareas,
+                                   int numgoals,
+                                   int travelflags,
+                                   int *traveltimes)
+{
+    if (goalareas == NULL || traveltimes == NULL || numgoals <= 0)
+    {
+        return 0;
+    }
+
+    memset(traveltimes, 0, (size_t)numgoals * sizeof(int));
+
+    if (!aasworld.loaded)
+    {
+        return 0;
+    }
+
+    int numAreas = aasworld.numAreas;
+    if (areanum <= 0 || areanum > numAreas)
+    {
+        BotLib_Print(PRT_ERROR, "AAS_AreaTravelTimesToGoalAreas: areanum %d out of range\n", areanum);
+        return 0;
+    }
+
+    if (!AAS_RouteGraphReady())
+    {
+        return 0;
+    }
+
+    /* Answer single-query goals first; the rest are marked for the search. */
+    bool budgeted = AAS_ReadIntLibVar(Bridge_FrameReachability()) > 0;
+    int reached = 0;
+    int searched = 0;
+    for (int index = 0; index < numgoals; ++index)
+    {
+        int goal = goalareas[index];
+        if (goal <= 0 || goal > numAreas)
+        {
+            continue;
+        }
+
+        if (budgeted || goal == areanum || (aasworld.clusterRouting && AAS_CommonCluster(areanum, goal) > 0)
+            || AAS_RouteGoalCached(goal, travelflags))
+        {
+            aas_route_status_t status =
+                AAS_AreaRouteStatus(areanum, origin, goal, travelflags, &traveltimes[index], NULL);
+            if (status == ROUTE_STATUS_FOUND)
+            {
+                reached += 1;
+            }
+            else if (status == ROUTE_STATUS_PENDING)
+            {
+                traveltimes[index] = AAS_TRAVELTIME_PENDING;
+            }
+            continue;
+        }
+
+        traveltimes[index] = ROUTE_BATCH_SEARCH;
+        searched += 1;
+    }
+
+    if (searched == 0)
+    {
+        return reached;
+    }
+
+    aas_route_forward_search_t *search = AAS_ForwardSearchFor(areanum, travelflags);
+    bool searchFailed = (search == NULL);
+    for (int index = 0; index < numgoals && !searchFailed; ++index)
+    {
+        if (traveltimes[index] == ROUTE_BATCH_SEARCH)
+        {
+            searchFailed = !AAS_ForwardSearchSettle(search, goalareas[index]);
+        }
+    }
+
+    /* A search that ran out of memory settles nothing; ask per goal instead. */
+    if (searchFailed)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_AreaTravelTimesToGoalAreas: out of memory, routing goals one by one\n");
+    }
+
+    unsigned int local = (unsigned int)AAS_LocalTravelTime(areanum, origin);
+    for (int index = 0; index < numgoals; ++index)
+    {
+        if (traveltimes[index] != ROUTE_BATCH_SEARCH)
+        {
+            continue;
+        }
+
+        int goal = goalareas[index];
+        if (searchFailed)
+        {
+            if (AAS_AreaRouteToGoalArea(areanum, origin, goal, travelflags, &traveltimes[index], NULL))
+            {
+                reached += 1;
+            }
+            continue;
+        }
+
+        traveltimes[index] = 0;
+        if (search->times[goal] >= ROUTE_INVALID_TIME)
+        {
+            continue;
+        }
+
+        unsigned int total = local + search->times[goal];
+        if (total > ROUTE_INVALID_TIME)
+        {
+            total = ROUTE_INVALID_TIME;
+        }
+
+        traveltimes[index] = (int)total;
+        reached += 1;
+    }
+
+    return reached;
+}
+
+void AAS_InitClusterRouting(void)
+{
+    aasworld.clusterRouting = qfalse;
+
+    if (aasworld.portals == NULL || aasworld.portalIndex == NULL || aasworld.clusters == NULL
+        || aasworld.numPortals <= 1 || aasworld.numClusters <= 1)
+    {
+        return;
+    }
+
+    for (int clusternum = 1; clusternum < aasworld.numClusters; ++clusternum)
+    {
+        const aas_cluster_t *cluster = &aasworld.clusters[clusternum];
+        if (cluster->numareas <= 0 || cluster->numportals < 0 || cluster->firstportal < 0
+            || cluster->firstportal + cluster->numportals > aasworld.numPortalIndex)
+        {
+            BotLib_Print(PRT_WARNING,
+                         "AAS_InitClusterRouting: cluster %d is malformed, using whole-map routing\n",
+                         clusternum);
+            return;
+        }
+
+        for (int index = 0; index < cluster->numportals; ++index)
+        {
+            int portalnum = aasworld.portalIndex[cluster->firstportal + index];
+            if (portalnum <= 0 || portalnum >= aasworld.numPortals)
+            {
+                BotLib_Print(PRT_WARNING,
+                             "AAS_InitClusterRouting: cluster %d references portal %d out of range\n",
+                             clusternum,
+                             portalnum);
+                return;
+            }
+        }
+    }
+
+    for (int portalnum = 1; portalnum < aasworld.numPortals; ++portalnum)
+    {
+        const aas_portal_t *portal = &aasworld.portals[portalnum];
+        if (portal->areanum <= 0 || portal->areanum > aasworld.numAreas
+            || portal->areanum >= aasworld.numAreaSettings
+            || aasworld.areasettings[portal->areanum].cluster != -portalnum
+            || portal->frontcluster <= 0 || portal->frontcluster >= aasworld.numClusters
+            || portal->backcluster <= 0 || portal->backcluster >= aasworld.numClusters
+            || portal->clusterareanum[0] < 0
+            || portal->clusterareanum[0] >= aasworld.clusters[portal->frontcluster].numareas
+            || portal->clusterareanum[1] < 0
+            || portal->clusterareanum[1] >= aasworld.clusters[portal->backcluster].numareas)
+        {
+            BotLib_Print(PRT_WARNING,
+                         "AAS_InitClusterRouting: portal %d is malformed, using whole-map routing\n",
+                         portalnum);
+            return;
+        }
+    }
+
+    for (int areanum = 1; areanum <= aasworld.numAreas && areanum < aasworld.numAreaSettings; ++areanum)
+    {
+        const aas_areasettings_t *settings = &aasworld.areasettings[areanum];
+        if (settings->cluster < 0)
+        {
+            if (-settings->cluster >= aasworld.numPortals)
+            {
+                BotLib_Print(PRT_WARNING,
+                             "AAS_InitClusterRouting: area %d references portal %d out of range\n",
+                             areanum,
+                             -settings->cluster);
+                return;
+            }
+            continue;
+        }
+
+        if (settings->cluster == 0 || settings->cluster >= aasworld.numClusters
+            || settings->clusterareanum < 0
+            || settings->clusterareanum >= aasworld.clusters[settings->cluster].numareas)
+        {
+            BotLib_Print(PRT_WARNING,
+                         "AAS_InitClusterRouting: area %d has invalid cluster %d, using whole-map routing\n",
+                         areanum,
+                         settings->cluster);
+            return;
+        }
+    }
+
+    aasworld.clusterRouting = qtrue;
+}
+
+void AAS_RouteFrameResetDiagnostics(void)
+{
+    memset(&g_route_frame_state, 0, sizeof(g_route_frame_state));
+}
+
+static int AAS_ReadIntLibVar(libvar_t *var)
+{
+    if (var == NULL)
+    {
+        return 0;
+    }
+
+    return (int)var->value;
+}
+
+static bool AAS_LibVarEnabled(libvar_t *var)
+{
+    if (var == NULL)
+    {
+        return false;
+    }
+
+    return var->value != 0.0f;
+}
+
+void AAS_RouteFrameUpdate(void)
+{
+    AAS_RoutePrecomputeStart();
+    AAS_RoutePrecomputePublish();
+
+    int budget = AAS_ReadIntLibVar(Bridge_FrameReachability());
+    g_route_frame_state.last_budget = budget;
+    g_route_frame_state.forcewrite_active = AAS_LibVarEnabled(Bridge_ForceWrite());
+
+    g_route_frame_state.remaining = (budget > 0) ? budget : 0;
+
+    if (budget <= 0)
+    {
+        g_route_frame_state.frames_skipped += 1;
+
+        /* Searches paused under an earlier budget finish once it is lifted. */
+        for (aas_routingcache_t *cache = aasworld.routingCacheHead; cache != NULL; cache = cache->next)
+        {
+            if (cache->frontier != NULL)
+            {
+                (void)RouteCache_ContinuePending(cache, -1);
+            }
+        }
+        return;
+    }
+
+    g_route_frame_state.frames_with_work += 1;
+
+    /* Ensure the routing cache table exists as part of the maintenance pass. */
+    (void)RouteCache_EnsureTable();
+
+    /* Most recently used caches first: their callers are waiting on them. */
+    for (aas_routingcache_t *cache = aasworld.routingCacheTail;
+         cache != NULL && g_route_frame_state.remaining > 0;
+         cache = cache->prev)
+    {
+        if (cache->frontier != NULL)
+        {
+            g_route_frame_state.remaining -= RouteCache_ContinuePending(cache, g_route_frame_state.remaining);
+        }
+    }
+}
+
+void AAS_RouteCacheResetDiagnostics(void)
+{
+    memset(&g_route_cache_stats, 0, sizeof(g_route_cache_stats));
+}
+
+int AAS_RouteCacheHitCounter(void)
+{
+    return g_route_cache_stats.hits;
+}
+
+int AAS_RouteCacheMissCounter(void)
+{
+    return g_route_cache_stats.misses;
+}
+
+int AAS_RouteCacheEvictionCounter(void)
+{
+    return g_route_cache_stats.evictions;
+}
+
+int AAS_RouteCacheMoverInvalidationCounter(void)
+{
+    return g_route_cache_stats.mover_invalidations;
+}
+
+int AAS_RouteForwardSearchCounter(void)
+{
+    return g_route_cache_stats.forward_searches;
+}
+
+/* Precompute jobs not yet published, discarded or taken over. */
+int AAS_RoutePrecomputePendingCounter(void)
+{
+    return g_route_precompute.pending;
+}
+
+size_t AAS_RouteCacheBytesInUse(void)
+{
+    return aasworld.routingCacheBytes;
+}
+
+int AAS_RouteFrameWorkCounter(void)
+{
+    return g_route_frame_state.frames_with_work;
+}
+
+int AAS_RouteFrameSkipCounter(void)
+{
+    return g_route_frame_state.frames_skipped;
+}
+
+int AAS_RouteFrameLastBudget(void)
+{
+    return g_route_frame_state.last_budget;
+}
+
+bool AAS_RouteFrameForceWriteActive(void)
+{
+    return g_route_frame_state.forcewrite_active;
+}
+
+/* Path of a routing sidecar: the .aas path with its extension replaced. */
+static bool AAS_RouteCacheFilePath(char *buffer, size_t size, const char *extension)
+{
+    const char *aasPath = aasworld.aasFilePath;
+    size_t length = strlen(aasPath);
+    if (length == 0U || length + strlen(extension) + 1U > size)
+    {
+        return false;
+    }
+
+    memcpy(buffer, aasPath, length + 1U);
+    char *dot = strrchr(buffer, '.');
+    char *separator = strrchr(buffer, '/');
+    if (dot != NULL && (separator == NULL || dot > separator))
+    {
+        *dot = '\0';
+    }
+
+    strcat(buffer, extension);
+    return true;
+}
+
+static void AAS_RouteCacheFileHeader(aas_routecache_file_header_t *header, int numCaches)
+{
+    memset(header, 0, sizeof(*header));
+    header->ident = ROUTECACHE_FILE_IDENT;
+    header->version = ROUTECACHE_FILE_VERSION;
+    header->aasChecksum = aasworld.aasChecksum;
+    header->bspChecksum = aasworld.bspChecksum;
+    header->numAreas = aasworld.numAreas;
+    header->numReachability = aasworld.numReachability;
+    header->numClusters = aasworld.clusterRouting ? aasworld.numClusters : 0;
+    header->numPortals = aasworld.clusterRouting ? aasworld.numPortals : 0;
+    header->areaOrder = aasworld.areaOrder;
+    header->numCaches = numCaches;
+}
+
+/* The sidecar always stores the flat arrays; compact caches are expanded. */
+static bool AAS_WriteRouteCacheEntries(FILE *file, const aas_routingcache_t *cache)
+{
+    size_t count = (size_t)cache->numTraveltimes;
+    if (cache->blocks == NULL)
+    {
+        return fwrite(cache->traveltimes, sizeof(unsigned short), count, file) == count
+               && (cache->reachabilities == NULL
+                   || fwrite(cache->reachabilities, sizeof(unsigned char), count, file) == count);
+    }
+
+    unsigned short *times = (unsigned short *)malloc(count * sizeof(unsigned short));
+    unsigned char *reach = (unsigned char *)malloc(count * sizeof(unsigned char));
+    bool ok = times != NULL && reach != NULL;
+    for (size_t index = 0; ok && index < count; ++index)
+    {
+        times[index] = (unsigned short)RouteCache_EntryTime(cache, (int)index);
+        reach[index] = RouteCache_EntryReach(cache, (int)index);
+    }
+
+    ok = ok && fwrite(times, sizeof(unsigned short), count, file) == count
+         && fwrite(reach, sizeof(unsigned char), count, file) == count;
+    free(times);
+    free(reach);
+    return ok;
+}
+
+/*
+ * Saves every routing cache to the .rcd sidecar so the next load of the same
+ * map starts warm.  Caches are written least recently used first, which lets
+ * AAS_ReadRouteCache rebuild the LRU order by appending.
+ */
+int AAS_WriteRouteCache(void)
+{
+    char path[MAX_FILEPATH];
+    if (!aasworld.loaded || !AAS_RouteCacheFilePath(path, sizeof(path), ".rcd"))
+    {
+        return 0;
+    }
+
+    int numCaches = 0;
+    for (aas_routingcache_t *cache = aasworld.routingCacheHead; cache != NULL; cache = cache->next)
+    {
+        numCaches += (cache->frontier == NULL) ? 1 : 0;
+    }
+
+    /* Never replace a warm sidecar with the empty table of a failed load. */
+    if (numCaches == 0)
+    {
+        return 0;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_WriteRouteCache: unable to open %s\n", path);
+        return 0;
+    }
+
+    aas_routecache_file_header_t header;
+    AAS_RouteCacheFileHeader(&header, numCaches);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (aas_routingcache_t *cache = aasworld.routingCacheHead; ok && cache != NULL; cache = cache->next)
+    {
+        if (cache->frontier != NULL)
+        {
+            continue;
+        }
+
+        aas_routecache_file_record_t record;
+        memset(&record, 0, sizeof(record));
+        record.type = cache->type;
+        record.cluster = cache->cluster;
+        record.goalArea = cache->goalArea;
+        record.travelflags = cache->travelflags;
+        record.numTraveltimes = cache->numTraveltimes;
+        record.moverModels = cache->moverModels;
+
+        ok = fwrite(&record, sizeof(record), 1, file) == 1 && AAS_WriteRouteCacheEntries(file, cache);
+    }
+
+    if (fclose(file) != 0)
+    {
+        ok = false;
+    }
+
+    if (!ok)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_WriteRouteCache: failed writing %s\n", path);
+        remove(path);
+        return 0;
+    }
+
+    BotLib_Print(PRT_MESSAGE, "AAS_WriteRouteCache: wrote %d routing caches to %s\n", numCaches, path);
+    return numCaches;
+}
+
+void AAS_SaveRouteCache(void)
+{
+    if (!aasworld.loaded || !AAS_LibVarEnabled(Bridge_ForceWrite()))
+    {
+        return;
+    }
+
+    (void)AAS_WriteRouteCache();
+}
+
+static bool AAS_RouteCacheRecordValid(const aas_routecache_file_record_t *record)
+{
+    switch (record->type)
+    {
+        case AAS_ROUTECACHE_WORLD:
+        case AAS_ROUTECACHE_PORTAL:
+            if (record->cluster != 0)
+            {
+                return false;
+            }
+            break;
+        case AAS_ROUTECACHE_CLUSTER:
+            if (!aasworld.clusterRouting || record->cluster <= 0 || record->cluster >= aasworld.numClusters)
+            {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    if (record->type != AAS_ROUTECACHE_WORLD && !aasworld.clusterRouting)
+    {
+        return false;
+    }
+
+    if (record->goalArea <= 0 || record->goalArea > aasworld.numAreas)
+    {
+        return false;
+    }
+
+    return record->numTraveltimes == RouteCache_EntryCount(record->type, record->cluster);
+}
+
+/*
+ * Seeds the routing cache table from the .rcd sidecar.  The file is only
+ * trusted when it was written for the same .aas and .bsp checksums; any
+ * malformed record discards everything read so far.  Returns the number of
+ * caches loaded.
+ */
+int AAS_ReadRouteCache(void)
+{
+    char path[MAX_FILEPATH];
+    if (!aasworld.loaded || !AAS_RouteCacheFilePath(path, sizeof(path), ".rcd"))
+    {
+        return 0;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return 0;
+    }
+
+    aas_routecache_file_header_t header;
+    aas_routecache_file_header_t expected;
+    AAS_RouteCacheFileHeader(&expected, 0);
+    if (fread(&header, sizeof(header), 1, file) != 1)
+    {
+        fclose(file);
+        return 0;
+    }
+
+    expected.numCaches = header.numCaches;
+    if (memcmp(&header, &expected, sizeof(header)) != 0 || header.numCaches < 0)
+    {
+        BotLib_Print(PRT_MESSAGE, "AAS_ReadRouteCache: %s is out of date, ignoring\n", path);
+        fclose(file);
+        return 0;
+    }
+
+    int loaded = 0;
+    bool ok = true;
+    bool compact = RouteCache_CompactEnabled();
+    for (int index = 0; index < header.numCaches; ++index)
+    {
+        aas_routecache_file_record_t record;
+        if (fread(&record, sizeof(record), 1, file) != 1 || !AAS_RouteCacheRecordValid(&record))
+        {
+            ok = false;
+            break;
+        }
+
+        aas_routingcache_t *cache = RouteCache_Alloc(record.type,
+                                                     record.cluster,
+                                                     record.goalArea,
+                                                     record.travelflags,
+                                                     record.numTraveltimes);
+        if (cache == NULL)
+        {
+            ok = false;
+            break;
+        }
+
+        size_t count = (size_t)record.numTraveltimes;
+        cache->moverModels = record.moverModels;
+        if (fread(cache->traveltimes, sizeof(unsigned short), count, file) != count
+            || (cache->reachabilities != NULL
+                && fread(cache->reachabilities, sizeof(unsigned char), count, file) != count))
+        {
+            RouteCache_Destroy(cache);
+            ok = false;
+            break;
+        }
+
+        if (RouteCache_Find(record.type, record.cluster, record.goalArea, record.travelflags) != NULL)
+        {
+            RouteCache_Destroy(cache);
+            ok = false;
+            break;
+        }
+
+        if (compact)
+        {
+            RouteCache_Compact(cache);
+        }
+
+        /* Later records are more recently used; older ones give way first. */
+        RouteCache_EvictForBudget(cache->size);
+        RouteCache_Insert(cache);
+        ++loaded;
+    }
+
+    fclose(file);
+
+    if (!ok)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_ReadRouteCache: %s is corrupt, discarding\n", path);
+        AAS_FreeAllRoutingCaches();
+        return 0;
+    }
+
+    BotLib_Print(PRT_MESSAGE, "AAS_ReadRouteCache: loaded %d routing caches from %s\n", loaded, path);
+    return loaded;
+}
+
+#define ROUTE_MATRIX_MAX_AREAS 8192
+
+static void AAS_RouteMatrixFileHeader(aas_routematrix_file_header_t *header, int travelflags)
+{
+    memset(header, 0, sizeof(*header));
+    header->ident = ROUTEMATRIX_FILE_IDENT;
+    header->version = ROUTEMATRIX_FILE_VERSION;
+    header->aasChecksum = aasworld.aasChecksum;
+    header->bspChecksum = aasworld.bspChecksum;
+    header->numAreas = aasworld.numAreas;
+    header->numReachability = aasworld.numReachability;
+    header->travelflags = travelflags;
+    header->areaOrder = aasworld.areaOrder;
+}
+
+static size_t AAS_RouteMatrixFileSize(size_t stride)
+{
+    return sizeof(aas_routematrix_file_header_t) + stride * stride * sizeof(unsigned short);
+}
+
+void AAS_FreeRouteMatrix(void)
+{
+    AAS_CloseFileImage(&g_route_matrix.image);
+    free(g_route_matrix.owned);
+    memset(&g_route_matrix, 0, sizeof(g_route_matrix));
+}
+
+/* Maps a sidecar written for this exact map and travel-flag set. */
+static bool AAS_LoadRouteMatrixFile(const char *path, int travelflags)
+{
+    aas_route_matrix_t *matrix = &g_route_matrix;
+    if (!AAS_OpenFileImage(path, &matrix->image))
+    {
+        return false;
+    }
+
+    aas_routematrix_file_header_t expected;
+    AAS_RouteMatrixFileHeader(&expected, travelflags);
+    size_t stride = (size_t)aasworld.numAreas + 1U;
+    if (matrix->image.size != AAS_RouteMatrixFileSize(stride)
+        || memcmp(matrix->image.data, &expected, sizeof(expected)) != 0)
+    {
+        BotLib_Print(PRT_MESSAGE, "AAS_InitRouteMatrix: %s is out of date, rebuilding\n", path);
+        AAS_CloseFileImage(&matrix->image);
+        return false;
+    }
+
+    matrix->times = (const unsigned short *)(matrix->image.data + sizeof(expected));
+    return true;
+}
+
+typedef struct
+{
+    int firstGoal;
+    int step;
+    int travelflags;
+    bool failed;
+} aas_route_matrix_job_t;
+
+/* Fills every step-th goal row, each one a world cache search. */
+static void *AAS_RouteMatrixWorker(void *arg)
+{
+    aas_route_matrix_job_t *job = (aas_route_matrix_job_t *)arg;
+    aas_route_matrix_t *matrix = &g_route_matrix;
+    size_t stride = (size_t)matrix->stride;
+    aas_route_kernel_t kernel;
+    memset(&kernel, 0, sizeof(kernel));
+
+    unsigned char *reach = (unsigned char *)malloc(stride);
+    if (reach == NULL)
+    {
+        job->failed = true;
+        return NULL;
+    }
+
+    for (int goal = job->firstGoal; goal < matrix->stride; goal += job->step)
+    {
+        aas_routingcache_t cache;
+        memset(&cache, 0, sizeof(cache));
+        cache.type = AAS_ROUTECACHE_WORLD;
+        cache.goalArea = goal;
+        cache.travelflags = job->travelflags;
+        cache.numTraveltimes = matrix->stride;
+        cache.traveltimes = matrix->owned + (size_t)goal * stride;
+        cache.reachabilities = reach;
+        AAS_PopulateRouteCache(&kernel, &cache);
+
+        /* A finished search always reaches its own goal. */
+        if (goal > 0 && cache.traveltimes[goal] != 0)
+        {
+            job->failed = true;
+            break;
+        }
+    }
+
+    free(reach);
+    AAS_RouteKernelFree(&kernel);
+    return NULL;
+}
+
+static int AAS_RouteMatrixThreads(void)
+{
+#ifndef _WIN32
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online > ROUTE_PRECOMPUTE_MAX_THREADS)
+    {
+        return ROUTE_PRECOMPUTE_MAX_THREADS;
+    }
+    return (online > 1) ? (int)online : 1;
+#else
+    return 1;
+#endif
+}
+
+static bool AAS_BuildRouteMatrix(int travelflags)
+{
+    aas_route_matrix_t *matrix = &g_route_matrix;
+    size_t stride = (size_t)aasworld.numAreas + 1U;
+    matrix->owned = (unsigned short *)malloc(stride * stride * sizeof(unsigned short));
+    if (matrix->owned == NULL)
+    {
+        AAS_FreeRouteMatrix();
+        return false;
+    }
+    matrix->stride = (int)stride;
+
+    int threads = AAS_RouteMatrixThreads();
+    aas_route_matrix_job_t jobs[ROUTE_PRECOMPUTE_MAX_THREADS];
+    for (int index = 0; index < threads; ++index)
+    {
+        jobs[index].firstGoal = index;
+        jobs[index].step = threads;
+        jobs[index].travelflags = travelflags;
+        jobs[index].failed = false;
+    }
+
+#ifndef _WIN32
+    pthread_t workers[ROUTE_PRECOMPUTE_MAX_THREADS];
+    bool started[ROUTE_PRECOMPUTE_MAX_THREADS] = {false};
+    for (int index = 1; index < threads; ++index)
+    {
+        started[index] = pthread_create(&workers[index], NULL, AAS_RouteMatrixWorker, &jobs[index]) == 0;
+    }
+    (void)AAS_RouteMatrixWorker(&jobs[0]);
+    for (int index = 1; index < threads; ++index)
+    {
+        if (started[index])
+        {
+            pthread_join(workers[index], NULL);
+        }
+        else
+        {
+            (void)AAS_RouteMatrixWorker(&jobs[index]);
+        }
+    }
+#else
+    (void)AAS_RouteMatrixWorker(&jobs[0]);
+#endif
+
+    for (int index = 0; index < threads; ++index)
+    {
+        if (jobs[index].failed)
+        {
+            AAS_FreeRouteMatrix();
+            return false;
+        }
+    }
+
+    matrix->times = matrix->owned;
+    return true;
+}
+
+static void AAS_WriteRouteMatrix(const char *path, int travelflags)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_InitRouteMatrix: unable to open %s\n", path);
+        return;
+    }
+
+    const aas_route_matrix_t *matrix = &g_route_matrix;
+    size_t stride = (size_t)matrix->stride;
+    aas_routematrix_file_header_t header;
+    AAS_RouteMatrixFileHeader(&header, travelflags);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+              && fwrite(matrix->times, sizeof(unsigned short), stride * stride, file) == stride * stride;
+
+    if (fclose(file) != 0 || !ok)
+    {
+        BotLib_Print(PRT_WARNING, "AAS_InitRouteMatrix: failed writing %s\n", path);
+        remove(path);
+    }
+}
+
+/*
+ * Loads or builds the all-pairs matrix when the map has at most routematrix
+ * areas.  The matrix answers the travel flags bots route with by default,
+ * reduced to those the map uses.  A matching .rtm sidecar is mapped in place;
+ * otherwise the rows are computed in parallel and the sidecar is written for
+ * the next load.  Returns whether a matrix is active.
+ */
+qboolean AAS_InitRouteMatrix(void)
+{
+    AAS_FreeRouteMatrix();
+
+    int limit = AAS_ReadIntLibVar(Bridge_RouteMatrix());
+    if (limit > ROUTE_MATRIX_MAX_AREAS)
+    {
+        limit = ROUTE_MATRIX_MAX_AREAS;
+    }
+    if (!aasworld.loaded || aasworld.numAreas <= 0 || aasworld.numAreas > limit || !AAS_RouteGraphReady())
+    {
+        return qfalse;
+    }
+
+    int travelflags = TFL_DEFAULT;
+    if (AAS_LibVarEnabled(Bridge_RocketJump()))
+    {
+        travelflags |= TFL_ROCKETJUMP;
+    }
+    travelflags = RouteCache_KeyTravelFlags(travelflags);
+
+    char path[MAX_FILEPATH];
+    bool havePath = AAS_RouteCacheFilePath(path, sizeof(path), ".rtm");
+    if (havePath && AAS_LoadRouteMatrixFile(path, travelflags))
+    {
+        g_route_matrix.stride = aasworld.numAreas + 1;
+        g_route_matrix.travelflags = travelflags;
+        BotLib_Print(PRT_MESSAGE, "AAS_InitRouteMatrix: mapped %s\n", path);
+        return qtrue;
+    }
+
+    if (!AAS_BuildRouteMatrix(travelflags))
+    {
+        BotLib_Print(PRT_WARNING, "AAS_InitRouteMatrix: could not build the travel time matrix\n");
+        return qfalse;
+    }
+    g_route_matrix.travelflags = travelflags;
+
+    if (havePath)
+    {
+        AAS_WriteRouteMatrix(path, travelflags);
+    }
+    return qtrue;
 }
 
 int AAS_NextModelReachability(int startIndex, int modelnum)
@@ -0,0 +1,498 @@
+#include "aas_local.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "botlib/common/l_log.h"
+
+/*
+ * Point sampling and link helpers mirroring be_aas_sample.c. The AAS BSP
+ * tree resolves a point in O(depth); worlds without a node/plane lump
+ * (synthetic fixtures, truncated files) fall back to scanning area bounds.
+ */
+
+qboolean AAS_NodeTreeValid(void)
+{
+    if (aasworld.nodes == NULL || aasworld.numNodes <= 1)
+    {
+        return qfalse;
+    }
+
+    return (aasworld.planes != NULL && aasworld.numPlanes > 0) ? qtrue : qfalse;
+}
+
+/* Returns 1 when the box is in front of the plane, 2 behind, 3 spanning. */
+int AAS_BoxOnPlaneSide2(const vec3_t absmins, const vec3_t absmaxs, const aas_plane_t *plane)
+{
+    vec3_t corners[2];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (plane->normal[axis] < 0.0f)
+        {
+            corners[0][axis] = absmins[axis];
+            corners[1][axis] = absmaxs[axis];
+        }
+        else
+        {
+            corners[1][axis] = absmins[axis];
+            corners[0][axis] = absmaxs[axis];
+        }
+    }
+
+    float dist1 = DotProduct(plane->normal, corners[0]) - plane->dist;
+    float dist2 = DotProduct(plane->normal, corners[1]) - plane->dist;
+    int side = 0;
+    if (dist1 >= 0.0f)
+    {
+        side = 1;
+    }
+    if (dist2 < 0.0f)
+    {
+        side |= 2;
+    }
+    return side;
+}
+
+aas_link_t *AAS_AllocAASLink(void)
+{
+    if (aasworld.freeLinks == NULL)
+    {
+        aas_linkblock_t *block = (aas_linkblock_t *)malloc(sizeof(aas_linkblock_t));
+        if (block == NULL)
+        {
+            BotLib_Print(PRT_ERROR, "AAS_AllocAASLink: out of memory\n");
+            return NULL;
+        }
+
+        block->next = aasworld.linkBlocks;
+        aasworld.linkBlocks = block;
+        for (int index = AAS_LINK_BLOCK_SIZE - 1; index >= 0; --index)
+        {
+            block->links[index].next_ent = aasworld.freeLinks;
+            aasworld.freeLinks = &block->links[index];
+        }
+    }
+
+    aas_link_t *link = aasworld.freeLinks;
+    aasworld.freeLinks = link->next_ent;
+    memset(link, 0, sizeof(*link));
+    return link;
+}
+
+void AAS_DeAllocAASLink(aas_link_t *link)
+{
+    if (link == NULL)
+    {
+        return;
+    }
+
+    link->prev_ent = NULL;
+    link->next_area = NULL;
+    link->prev_area = NULL;
+    link->next_ent = aasworld.freeLinks;
+    aasworld.freeLinks = link;
+}
+
+void AAS_FreeAASLinkHeap(void)
+{
+    aas_linkblock_t *block = aasworld.linkBlocks;
+    while (block != NULL)
+    {
+        aas_linkblock_t *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    aasworld.linkBlocks = NULL;
+    aasworld.freeLinks = NULL;
+}
+
+static int AAS_PointAreaNumLinear(const vec3_t point)
+{
+    if (aasworld.areas == NULL || aasworld.numAreas <= 0)
+    {
+        return 0;
+    }
+
+    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
+    {
+        const aas_area_t *area = &aasworld.areas[areanum];
+        if (point[0] < area->mins[0] || point[0] > area->maxs[0])
+        {
+            continue;
+        }
+        if (point[1] < area->mins[1] || point[1] > area->maxs[1])
+        {
+            continue;
+        }
+        if (point[2] < area->mins[2] || point[2] > area->maxs[2])
+        {
+            continue;
+        }
+        return areanum;
+    }
+
+    return 0;
+}
+
+int AAS_PointAreaNum(const vec3_t point)
+{
+    if (point == NULL || !aasworld.loaded)
+    {
+        return 0;
+    }
+
+    if (!AAS_NodeTreeValid())
+    {
+        return AAS_PointAreaNumLinear(point);
+    }
+
+    /* node 0 is the solid leaf, the tree starts at node 1 */
+    int nodenum = 1;
+    for (int depth = 0; nodenum > 0; ++depth)
+    {
+        if (nodenum >= aasworld.numNodes || depth >= aasworld.numNodes)
+        {
+            BotLib_Print(PRT_ERROR, "AAS_PointAreaNum: corrupt node tree at %d\n", nodenum);
+            return 0;
+        }
+
+        const aas_node_t *node = &aasworld.nodes[nodenum];
+        if (node->planenum < 0 || node->planenum >= aasworld.numPlanes)
+        {
+            BotLib_Print(PRT_ERROR,
+                         "AAS_PointAreaNum: node %d references invalid plane %d\n",
+                         nodenum,
+                         node->planenum);
+            return 0;
+        }
+
+        const aas_plane_t *plane = &aasworld.planes[node->planenum];
+        float dist = DotProduct(point, plane->normal) - plane->dist;
+        nodenum = (dist > 0.0f) ? node->children[0] : node->children[1];
+    }
+
+    int areanum = -nodenum;
+    if (areanum <= 0 || areanum > aasworld.numAreas)
+    {
+        return 0;
+    }
+
+    return areanum;
+}
+
+#define AAS_QUERY_STACK_SIZE 128
+
+static qboolean AAS_BoxTouchesArea(const vec3_t absmins, const vec3_t absmaxs, const aas_area_t *area)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (absmaxs[axis] < area->mins[axis] || absmins[axis] > area->maxs[axis])
+        {
+            return qfalse;
+        }
+    }
+
+    return qtrue;
+}
+
+static qboolean AAS_AreaListed(const int *areas, int numareas, int areanum)
+{
+    for (int index = 0; index < numareas; ++index)
+    {
+        if (areas[index] == areanum)
+        {
+            return qtrue;
+        }
+    }
+
+    return qfalse;
+}
+
+/*
+ * Fills areas with every area the box touches and returns how many were
+ * written, at most maxareas.  Like the entity linker, leaves reached through
+ * the tree are also checked against the area bounds.
+ */
+int AAS_BBoxAreas(const vec3_t absmins, const vec3_t absmaxs, int *areas, int maxareas)
+{
+    if (absmins == NULL || absmaxs == NULL || areas == NULL || maxareas <= 0
+        || !aasworld.loaded || aasworld.areas == NULL)
+    {
+        return 0;
+    }
+
+    int numareas = 0;
+    if (!AAS_NodeTreeValid())
+    {
+        for (int areanum = 1; areanum <= aasworld.numAreas && numareas < maxareas; ++areanum)
+        {
+            if (AAS_BoxTouchesArea(absmins, absmaxs, &aasworld.areas[areanum]))
+            {
+                areas[numareas++] = areanum;
+            }
+        }
+        return numareas;
+    }
+
+    int stack[AAS_QUERY_STACK_SIZE];
+    int depth = 0;
+    stack[depth++] = 1;
+
+    while (depth > 0 && numareas < maxareas)
+    {
+        int nodenum = stack[--depth];
+        if (nodenum < 0)
+        {
+            int areanum = -nodenum;
+            if (areanum <= aasworld.numAreas && !AAS_AreaListed(areas, numareas, areanum)
+                && AAS_BoxTouchesArea(absmins, absmaxs, &aasworld.areas[areanum]))
+            {
+                areas[numareas++] = areanum;
+            }
+            continue;
+        }
+
+        if (nodenum == 0 || nodenum >= aasworld.numNodes)
+        {
+            continue;
+        }
+
+        const aas_node_t *node = &aasworld.nodes[nodenum];
+        if (node->planenum < 0 || node->planenum >= aasworld.numPlanes)
+        {
+            continue;
+        }
+
+        if (depth + 2 > AAS_QUERY_STACK_SIZE)
+        {
+            BotLib_Print(PRT_WARNING, "AAS_BBoxAreas: stack overflow\n");
+            break;
+        }
+
+        int side = AAS_BoxOnPlaneSide2(absmins, absmaxs, &aasworld.planes[node->planenum]);
+        if (side & 1)
+        {
+            stack[depth++] = node->children[0];
+        }
+        if (side & 2)
+        {
+            stack[depth++] = node->children[1];
+        }
+    }
+
+    return numareas;
+}
+
+/* Entry fraction of the segment into the area box, or -1 when it misses. */
+static float AAS_SegmentEnterArea(const vec3_t start, const vec3_t end, const aas_area_t *area)
+{
+    float enter = 0.0f;
+    float leave = 1.0f;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float delta = end[axis] - start[axis];
+        if (delta == 0.0f)
+        {
+            if (start[axis] < area->mins[axis] || start[axis] > area->maxs[axis])
+            {
+                return -1.0f;
+            }
+            continue;
+        }
+
+        float t0 = (area->mins[axis] - start[axis]) / delta;
+        float t1 = (area->maxs[axis] - start[axis]) / delta;
+        if (t0 > t1)
+        {
+            float tmp = t0;
+            t0 = t1;
+            t1 = tmp;
+        }
+        if (t0 > enter)
+        {
+            enter = t0;
+        }
+        if (t1 < leave)
+        {
+            leave = t1;
+        }
+        if (enter > leave)
+        {
+            return -1.0f;
+        }
+    }
+
+    return enter;
+}
+
+static void AAS_SegmentPoint(const vec3_t start, const vec3_t end, float frac, vec3_t point)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        point[axis] = start[axis] + (end[axis] - start[axis]) * frac;
+    }
+}
+
+static int AAS_TraceAreasLinear(const vec3_t start, const vec3_t end, int *areas, vec3_t *points, int maxareas)
+{
+    float fracs[AAS_QUERY_STACK_SIZE];
+    if (maxareas > AAS_QUERY_STACK_SIZE)
+    {
+        maxareas = AAS_QUERY_STACK_SIZE;
+    }
+
+    int numareas = 0;
+    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
+    {
+        float frac = AAS_SegmentEnterArea(start, end, &aasworld.areas[areanum]);
+        if (frac < 0.0f)
+        {
+            continue;
+        }
+
+        /* insertion sort on entry fraction, dropping the furthest when full */
+        int slot = numareas;
+        while (slot > 0 && fracs[slot - 1] > frac)
+        {
+            --slot;
+        }
+        if (slot >= maxareas)
+        {
+            continue;
+        }
+        int last = (numareas < maxareas) ? numareas : maxareas - 1;
+        for (int index = last; index > slot; --index)
+        {
+            fracs[index] = fracs[index - 1];
+            areas[index] = areas[index - 1];
+        }
+        fracs[slot] = frac;
+        areas[slot] = areanum;
+        if (numareas < maxareas)
+        {
+            ++numareas;
+        }
+    }
+
+    if (points != NULL)
+    {
+        for (int index = 0; index < numareas; ++index)
+        {
+            AAS_SegmentPoint(start, end, fracs[index], points[index]);
+        }
+    }
+
+    return numareas;
+}
+
+typedef struct aas_tracestack_s
+{
+    vec3_t start;
+    vec3_t end;
+    int nodenum;
+} aas_tracestack_t;
+
+/*
+ * Fills areas with the areas the line from start to end passes through, in
+ * order from start, and returns how many were written.  When points is not
+ * NULL it receives the point where the line enters each area.  Mirrors
+ * be_aas_sample.c: the segment is split at every node plane it crosses and
+ * the near half is walked first.
+ */
+int AAS_TraceAreas(const vec3_t start, const vec3_t end, int *areas, vec3_t *points, int maxareas)
+{
+    if (start == NULL || end == NULL || areas == NULL || maxareas <= 0
+        || !aasworld.loaded || aasworld.areas == NULL)
+    {
+        return 0;
+    }
+
+    if (!AAS_NodeTreeValid())
+    {
+        return AAS_TraceAreasLinear(start, end, areas, points, maxareas);
+    }
+
+    aas_tracestack_t stack[AAS_QUERY_STACK_SIZE];
+    VectorCopy(start, stack[0].start);
+    VectorCopy(end, stack[0].end);
+    stack[0].nodenum = 1;
+    int depth = 1;
+
+    int numareas = 0;
+    while (depth > 0 && numareas < maxareas)
+    {
+        aas_tracestack_t *top = &stack[--depth];
+        int nodenum = top->nodenum;
+        if (nodenum < 0)
+        {
+            int areanum = -nodenum;
+            if (areanum <= aasworld.numAreas && (numareas == 0 || areas[numareas - 1] != areanum))
+            {
+                areas[numareas] = areanum;
+                if (points != NULL)
+                {
+                    VectorCopy(top->start, points[numareas]);
+                }
+                ++numareas;
+            }
+            continue;
+        }
+
+        if (nodenum == 0 || nodenum >= aasworld.numNodes)
+        {
+            continue;
+        }
+
+        const aas_node_t *node = &aasworld.nodes[nodenum];
+        if (node->planenum < 0 || node->planenum >= aasworld.numPlanes)
+        {
+            continue;
+        }
+
+        const aas_plane_t *plane = &aasworld.planes[node->planenum];
+        float front = DotProduct(top->start, plane->normal) - plane->dist;
+        float back = DotProduct(top->end, plane->normal) - plane->dist;
+        if (front > 0.0f && back > 0.0f)
+        {
+            top->nodenum = node->children[0];
+            ++depth;
+            continue;
+        }
+        if (front <= 0.0f && back <= 0.0f)
+        {
+            top->nodenum = node->children[1];
+            ++depth;
+            continue;
+        }
+
+        if (depth + 2 > AAS_QUERY_STACK_SIZE)
+        {
+            BotLib_Print(PRT_WARNING, "AAS_TraceAreas: stack overflow\n");
+            break;
+        }
+
+        /* start and end straddle the plane: far half below, near half on top */
+        float frac = front / (front - back);
+        vec3_t mid;
+        vec3_t segmentStart;
+        vec3_t segmentEnd;
+        VectorCopy(top->start, segmentStart);
+        VectorCopy(top->end, segmentEnd);
+        AAS_SegmentPoint(segmentStart, segmentEnd, frac, mid);
+        int nearSide = (front > 0.0f) ? 0 : 1;
+
+        aas_tracestack_t *farHalf = &stack[depth++];
+        VectorCopy(mid, farHalf->start);
+        VectorCopy(segmentEnd, farHalf->end);
+        farHalf->nodenum = node->children[nearSide ^ 1];
+
+        aas_tracestack_t *nearHalf = &stack[depth++];
+        VectorCopy(segmentStart, nearHalf->start);
+        VectorCopy(mid, nearHalf->end);
+        nearHalf->nodenum = node->children[nearSide];
+    }
+
+    return numareas;
+}
@@ -14,6 +14,10 @@
 
 #define AI_WEAPON_DEFAULT_CONFIG "weapons.c"
 
+/* Not surfaced through l_precomp.h / l_script.h yet. */
+int PC_CheckTokenString(pc_source_t *source, char *string);
+void StripDoubleQuotes(char *string);
+
 static const bot_weapon_config_t *g_active_weapon_config = NULL;
 
 static const char *AI_Weapon_LogPath(const char *path)
@@ -61,6 +65,10 @@ static void AI_Weapon_CopyTokenString(char *dest, size_t dest_size, const pc_tok
     dest[0] = '\0';
     strncpy(dest, token->string, dest_size - 1);
     dest[dest_size - 1] = '\0';
+    if (token->type == TT_STRING)
+    {
+        StripDoubleQuotes(dest);
+    }
 }
 
 static bool AI_Weapon_ReadVector(pc_source_t *source, vec3_t out)
@@ -78,12 +86,14 @@ static bool AI_Weapon_ReadVector(pc_source_t *source, vec3_t out)
 
     for (int i = 0; i < 3; ++i)
     {
+        /* Offsets such as {24, 8, -8} carry the sign as its own token. */
+        bool negative = PC_CheckTokenString(source, "-") ? true : false;
         pc_token_t value;
         if (!PC_ExpectTokenType(source, TT_NUMBER, 0, &value))
         {
             return false;
         }
-        out[i] = AI_Weapon_TokenToFloat(&value);
+        out[i] = negative ? -AI_Weapon_TokenToFloat(&value) : AI_Weapon_TokenToFloat(&value);
 
         if (i < 2)
         {
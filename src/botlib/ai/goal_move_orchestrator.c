@@ -46,30 +46,7 @@ static void ai_goal_copy_vec(vec3_t dest, const vec3_t src)
 
 static int ai_goal_point_area_num(const vec3_t origin)
 {
-    if (origin == NULL || !aasworld.loaded || aasworld.areas == NULL || aasworld.numAreas <= 0)
-    {
-        return 0;
-    }
-
-    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
-    {
-        const aas_area_t *area = &aasworld.areas[areanum];
-        if (origin[0] < area->mins[0] || origin[0] > area->maxs[0])
-        {
-            continue;
-        }
-        if (origin[1] < area->mins[1] || origin[1] > area->maxs[1])
-        {
-            continue;
-        }
-        if (origin[2] < area->mins[2] || origin[2] > area->maxs[2])
-        {
-            continue;
-        }
-        return areanum;
-    }
-
-    return 0;
+    return AAS_PointAreaNum(origin);
 }
 
 static int ai_goal_state_alloc_temp_index(ai_goal_state_t *state, unsigned int tag)
@@ -582,30 +582,7 @@ static bool BotGoal_IsAvoided(const bot_goalstate_t *gs, int number)
 
 static int BotGoal_PointAreaNum(const vec3_t origin)
 {
-    if (!aasworld.loaded || aasworld.areas == NULL || aasworld.numAreas <= 0)
-    {
-        return 0;
-    }
-
-    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
-    {
-        const aas_area_t *area = &aasworld.areas[areanum];
-        if (origin[0] < area->mins[0] || origin[0] > area->maxs[0])
-        {
-            continue;
-        }
-        if (origin[1] < area->mins[1] || origin[1] > area->maxs[1])
-        {
-            continue;
-        }
-        if (origin[2] < area->mins[2] || origin[2] > area->maxs[2])
-        {
-            continue;
-        }
-        return areanum;
-    }
-
-    return 0;
+    return AAS_PointAreaNum(origin);
 }
 
 static bot_levelitem_t *BotGoal_FindLevelItem(int number)
@@ -727,6 +704,7 @@ int BotGoal_RegisterLevelItem(const bot_levelitem_setup_t *setup)
     {
         slot->goal.areanum = BotGoal_PointAreaNum(slot->goal.origin);
     }
+    AAS_RegisterRouteGoalArea(slot->goal.areanum);
 
     strncpy(slot->classname, setup->classname, sizeof(slot->classname) - 1);
     slot->classname[sizeof(slot->classname) - 1] = '\0';
@@ -768,6 +746,49 @@ void BotGoal_MarkItemTaken(int number, float respawn_delay)
     item->next_respawn_time = BotGoal_CurrentTime() + delay;
 }
 
+static float BotGoal_ScoreWithTravelTime(bot_goalstate_t *gs,
+                                         const bot_levelitem_t *item,
+                                         const int *inventory,
+                                         int travel_time)
+{
+    float weight = BotGoal_EvaluateItemWeight(gs, inventory, item->goal.iteminfo);
+    weight += item->base_weight;
+    if (weight <= 0.0f)
+    {
+        return -FLT_MAX;
+    }
+
+    float score = weight - (float)travel_time * BOT_GOAL_TRAVELTIME_SCALE;
+    return score;
+}
+
+/*
+ * Fills travel_times for the candidate items with a single one-to-many route
+ * query from start_area instead of one goal-area search per item.  Items whose
+ * route the frame budget has not finished get AAS_TRAVELTIME_PENDING.
+ */
+static void BotGoal_CandidateTravelTimes(const bot_levelitem_t **items,
+                                         int count,
+                                         const vec3_t origin,
+                                         int start_area,
+                                         int travelflags,
+                                         int *travel_times)
+{
+    memset(travel_times, 0, (size_t)count * sizeof(int));
+    if (start_area <= 0 || count <= 0)
+    {
+        return;
+    }
+
+    int goal_areas[BOT_GOAL_MAX_LEVELITEMS];
+    for (int i = 0; i < count; ++i)
+    {
+        goal_areas[i] = items[i]->goal.areanum;
+    }
+
+    AAS_AreaTravelTimesToGoalAreas(start_area, origin, goal_areas, count, travelflags, travel_times);
+}
+
 static float BotGoal_LevelItemScore(bot_goalstate_t *gs,
                                     const bot_levelitem_t *item,
                                     const vec3_t origin,
@@ -786,12 +807,13 @@ static float BotGoal_LevelItemScore(bot_goalstate_t *gs,
         return -FLT_MAX;
     }
 
+    /* An item whose route is still being searched is not scored as free. */
     int time = 0;
-    if (start_area > 0 && item->goal.areanum > 0)
+    BotGoal_CandidateTravelTimes(&item, 1, origin, start_area, travelflags, &time);
+    bool pending = (time == AAS_TRAVELTIME_PENDING);
+    if (pending)
     {
-        vec3_t start;
-        VectorCopy(origin, start);
-        time = AAS_AreaTravelTimeToGoalArea(start_area, start, item->goal.areanum, travelflags);
+        time = 0;
     }
 
     if (travel_time != NULL)
@@ -799,15 +821,7 @@ static float BotGoal_LevelItemScore(bot_goalstate_t *gs,
         *travel_time = time;
     }
 
-    float weight = BotGoal_EvaluateItemWeight(gs, inventory, item->goal.iteminfo);
-    weight += item->base_weight;
-    if (weight <= 0.0f)
-    {
-        return -FLT_MAX;
-    }
-
-    float score = weight - (float)time * BOT_GOAL_TRAVELTIME_SCALE;
-    return score;
+    return pending ? -FLT_MAX : BotGoal_ScoreWithTravelTime(gs, item, inventory, time);
 }
 
 int BotChooseLTGItem(int handle, const vec3_t origin, const int *inventory, int travelflags)
@@ -828,6 +842,9 @@ int BotChooseLTGItem(int handle, const vec3_t origin, const int *inventory, int
     float best_score = -FLT_MAX;
     const bot_levelitem_t *best_item = NULL;
     bot_goal_t best_goal = {0};
+    const bot_levelitem_t *candidates[BOT_GOAL_MAX_LEVELITEMS];
+    int travel_times[BOT_GOAL_MAX_LEVELITEMS];
+    int num_candidates = 0;
 
     for (int i = 0; i < g_levelitem_count; ++i)
     {
@@ -847,16 +864,32 @@ int BotChooseLTGItem(int handle, const vec3_t origin, const int *inventory, int
             continue;
         }
 
-        int travel_time = 0;
-        float score = BotGoal_LevelItemScore(gs, item, origin, start_area, inventory, travelflags, &travel_time);
+        if (item->goal.areanum <= 0)
+        {
+            continue;
+        }
+
+        candidates[num_candidates++] = item;
+    }
+
+    BotGoal_CandidateTravelTimes(candidates, num_candidates, origin, start_area, travelflags, travel_times);
+
+    for (int i = 0; i < num_candidates; ++i)
+    {
+        if (travel_times[i] == AAS_TRAVELTIME_PENDING)
+        {
+            continue;
+        }
+
+        float score = BotGoal_ScoreWithTravelTime(gs, candidates[i], inventory, travel_times[i]);
         if (score <= best_score)
         {
             continue;
         }
 
         best_score = score;
-        best_item = item;
-        best_goal = item->goal;
+        best_item = candidates[i];
+        best_goal = candidates[i]->goal;
     }
 
     if (best_item == NULL)
@@ -891,6 +924,9 @@ int BotChooseNBGItem(int handle,
     float best_score = -FLT_MAX;
     const bot_levelitem_t *best_item = NULL;
     bot_goal_t best_goal = {0};
+    const bot_levelitem_t *candidates[BOT_GOAL_MAX_LEVELITEMS];
+    int travel_times[BOT_GOAL_MAX_LEVELITEMS];
+    int num_candidates = 0;
     float max_travel_time = (maxtime > 0.0f) ? (maxtime / BOT_GOAL_TRAVELTIME_SCALE) : 0.0f;
 
     for (int i = 0; i < g_levelitem_count; ++i)
@@ -916,21 +952,37 @@ int BotChooseNBGItem(int handle,
             continue;
         }
 
-        int travel_time = 0;
-        float score = BotGoal_LevelItemScore(gs, item, origin, start_area, inventory, travelflags, &travel_time);
+        if (item->goal.areanum <= 0)
+        {
+            continue;
+        }
+
+        candidates[num_candidates++] = item;
+    }
+
+    BotGoal_CandidateTravelTimes(candidates, num_candidates, origin, start_area, travelflags, travel_times);
+
+    for (int i = 0; i < num_candidates; ++i)
+    {
+        if (travel_times[i] == AAS_TRAVELTIME_PENDING)
+        {
+            continue;
+        }
+
+        float score = BotGoal_ScoreWithTravelTime(gs, candidates[i], inventory, travel_times[i]);
         if (score <= best_score)
         {
             continue;
         }
 
-        if (max_travel_time > 0.0f && (float)travel_time > max_travel_time)
+        if (max_travel_time > 0.0f && (float)travel_times[i] > max_travel_time)
         {
             continue;
         }
 
         best_score = score;
-        best_item = item;
-        best_goal = item->goal;
+        best_item = candidates[i];
+        best_goal = candidates[i]->goal;
     }
 
     if (best_item == NULL)
@@ -521,30 +521,7 @@ static float VectorNormalizeTo(const vec3_t src, vec3_t dst)
 
 static int BotMove_FindAreaForPoint(const vec3_t origin)
 {
-    if (!aasworld.loaded || aasworld.areas == NULL || aasworld.numAreas <= 0)
-    {
-        return 0;
-    }
-
-    for (int areanum = 1; areanum <= aasworld.numAreas; ++areanum)
-    {
-        const aas_area_t *area = &aasworld.areas[areanum];
-        if (origin[0] < area->mins[0] || origin[0] > area->maxs[0])
-        {
-            continue;
-        }
-        if (origin[1] < area->mins[1] || origin[1] > area->maxs[1])
-        {
-            continue;
-        }
-        if (origin[2] < area->mins[2] || origin[2] > area->maxs[2])
-        {
-            continue;
-        }
-        return areanum;
-    }
-
-    return 0;
+    return AAS_PointAreaNum(origin);
 }
 
 static int BotMove_TravelFlagsForType(int traveltype)
@@ -718,41 +695,13 @@ static int BotMove_ReconstructFirstReach(const int *parent_area,
     return reachnum;
 }
 
-static int BotGetReachabilityToGoal(bot_movestate_t *ms,
-                                    const bot_goal_t *goal,
-                                    int travelflags,
-                                    aas_reachability_t *out,
-                                    int *resultFlags)
+/*
+ * Fallback for worlds without the reversed reachability graph the router
+ * needs (hand-built fixtures): an unweighted search over the reachabilities.
+ */
+static int BotMove_BreadthFirstReachToGoal(const bot_movestate_t *ms, int goalArea, int travelflags)
 {
-    if (resultFlags != NULL)
-    {
-        *resultFlags = 0;
-    }
-
-    if (ms == NULL || goal == NULL || out == NULL)
-    {
-        return 0;
-    }
-
-    if (!aasworld.loaded ||
-        aasworld.areasettings == NULL ||
-        aasworld.reachability == NULL ||
-        aasworld.numReachability <= 0)
-    {
-        return 0;
-    }
-
-    if (ms->areanum <= 0 || ms->areanum >= aasworld.numAreaSettings)
-    {
-        return 0;
-    }
-
-    int goalArea = goal->areanum;
-    if (goalArea <= 0 || goalArea >= aasworld.numAreaSettings)
-    {
-        return 0;
-    }
-
+    int startArea = ms->areanum;
     int areaCount = aasworld.numAreaSettings;
     int *queue = (int *)malloc((size_t)areaCount * sizeof(int));
     int *visited = (int *)calloc((size_t)areaCount, sizeof(int));
@@ -770,10 +719,10 @@ static int BotGetReachabilityToGoal(bot_movestate_t *ms,
     int head = 0;
     int tail = 0;
 
-    queue[tail++] = ms->areanum;
-    visited[ms->areanum] = 1;
-    parent_area[ms->areanum] = 0;
-    parent_reach[ms->areanum] = 0;
+    queue[tail++] = startArea;
+    visited[startArea] = 1;
+    parent_area[startArea] = 0;
+    parent_reach[startArea] = 0;
 
     while (head < tail)
     {
@@ -832,7 +781,7 @@ static int BotGetReachabilityToGoal(bot_movestate_t *ms,
     int reachnum = 0;
     if (visited[goalArea])
     {
-        reachnum = BotMove_ReconstructFirstReach(parent_area, parent_reach, ms->areanum, goalArea);
+        reachnum = BotMove_ReconstructFirstReach(parent_area, parent_reach, startArea, goalArea);
     }
 
     free(queue);
@@ -840,6 +789,111 @@ static int BotGetReachabilityToGoal(bot_movestate_t *ms,
     free(parent_area);
     free(parent_reach);
 
+    return reachnum;
+}
+
+/*
+ * Takes the next hop stored in the routing cache.  If the bot is avoiding
+ * that reachability the other exits of the area are ranked by their own
+ * travel time to the goal, as the Quake III BotGetReachabilityToGoal does.
+ */
+static int BotMove_RoutedReachToGoal(const bot_movestate_t *ms, int goalArea, int travelflags)
+{
+    int flags = (travelflags != 0) ? travelflags : TFL_DEFAULT;
+    int traveltime = 0;
+    int reachnum = 0;
+    if (!AAS_AreaRouteToGoalArea(ms->areanum, ms->origin, goalArea, flags, &traveltime, &reachnum))
+    {
+        return 0;
+    }
+
+    if (reachnum > 0 && !BotMove_ShouldAvoidReach(ms, reachnum))
+    {
+        return reachnum;
+    }
+
+    const aas_areasettings_t *settings = &aasworld.areasettings[ms->areanum];
+    int bestReach = 0;
+    int bestTime = 0;
+    for (int offset = 0; offset < settings->numreachableareas; ++offset)
+    {
+        int reachIndex = settings->firstreachablearea + offset;
+        if (reachIndex <= 0 || reachIndex >= aasworld.numReachability)
+        {
+            continue;
+        }
+
+        if (BotMove_ShouldAvoidReach(ms, reachIndex))
+        {
+            continue;
+        }
+
+        const aas_reachability_t *candidate = &aasworld.reachability[reachIndex];
+        if (!BotMove_TravelAllowed(candidate->traveltype & TRAVELTYPE_MASK, flags))
+        {
+            continue;
+        }
+
+        int time = candidate->traveltime;
+        if (candidate->areanum != goalArea)
+        {
+            vec3_t end;
+            VectorCopy(candidate->end, end);
+            int remaining = AAS_AreaTravelTimeToGoalArea(candidate->areanum, end, goalArea, flags);
+            if (remaining <= 0)
+            {
+                continue;
+            }
+            time += remaining;
+        }
+
+        if (bestReach == 0 || time < bestTime)
+        {
+            bestReach = reachIndex;
+            bestTime = time;
+        }
+    }
+
+    return bestReach;
+}
+
+static int BotGetReachabilityToGoal(bot_movestate_t *ms,
+                                    const bot_goal_t *goal,
+                                    int travelflags,
+                                    aas_reachability_t *out,
+                                    int *resultFlags)
+{
+    if (resultFlags != NULL)
+    {
+        *resultFlags = 0;
+    }
+
+    if (ms == NULL || goal == NULL || out == NULL)
+    {
+        return 0;
+    }
+
+    if (!aasworld.loaded ||
+        aasworld.areasettings == NULL ||
+        aasworld.reachability == NULL ||
+        aasworld.numReachability <= 0)
+    {
+        return 0;
+    }
+
+    if (ms->areanum <= 0 || ms->areanum >= aasworld.numAreaSettings)
+    {
+        return 0;
+    }
+
+    int goalArea = goal->areanum;
+    if (goalArea <= 0 || goalArea >= aasworld.numAreaSettings)
+    {
+        return 0;
+    }
+
+    int reachnum = AAS_RouteGraphReady() ? BotMove_RoutedReachToGoal(ms, goalArea, travelflags)
+                                         : BotMove_BreadthFirstReachToGoal(ms, goalArea, travelflags);
     if (reachnum <= 0)
     {
         return 0;
@@ -5,6 +5,7 @@
 #include "botlib/common/l_memory.h"
 #include "botlib/precomp/l_precomp.h"
 #include "botlib/precomp/l_script.h"
+#include "shared/q_platform.h"
 
 #include <ctype.h>
 #include <stdbool.h>
@@ -615,7 +616,8 @@ int BotWeight_FindIndex(const bot_weight_config_t *config, const char *name)
 
     for (int i = 0; i < config->num_weights; ++i) {
         const char *entry_name = config->weights[i].name;
-        if (entry_name != NULL && strcmp(entry_name, name) == 0) {
+        /* weapons.c names "grenades" while fw_weap.c weighs "Grenades". */
+        if (entry_name != NULL && Q_stricmp(entry_name, name) == 0) {
             return i;
         }
     }
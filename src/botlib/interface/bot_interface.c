@@ -41,6 +41,7 @@
 #include "botlib_interface.h"
 #include "bot_interface.h"
 #include "bot_state.h"
+#include "bot_workers.h"
 
 static void BotInterface_Printf(int priority, const char *fmt, ...);
 
@@ -57,16 +58,35 @@ typedef struct botinterface_map_cache_s
     botinterface_asset_list_t images;
 } botinterface_map_cache_t;
 
-typedef struct botinterface_entity_snapshot_s
+#define BOTINTERFACE_ENTITY_VALID 0x01
+#define BOTINTERFACE_ENTITY_INVISIBLE 0x02
+#define BOTINTERFACE_ENTITY_SHOOTING 0x04
+
+/* The part of an entity update the enemy scans read for every candidate. */
+typedef struct botinterface_entity_hot_s
+{
+    vec3_t origin;
+    vec3_t old_origin;
+    int flags;   /* BOTINTERFACE_ENTITY_* */
+    int cluster; /* PVS cluster of origin, -1 when unknown */
+} botinterface_entity_hot_t;
+
+/*
+ * Mirror of the latest update for each entity, sized from the bridge entity
+ * limit at map load.  The full records sit in their own column so the scans
+ * over every client only pull in the hot one.
+ */
+typedef struct botinterface_entity_cache_s
 {
-    qboolean valid;
-    bot_updateentity_t state;
-} botinterface_entity_snapshot_t;
+    int capacity;
+    botinterface_entity_hot_t *hot;
+    bot_updateentity_t *state;
+} botinterface_entity_cache_t;
 
-#define BOT_INTERFACE_MAX_ENTITIES 1024
+#define BOT_INTERFACE_MIN_ENTITIES 64
 
 static botinterface_map_cache_t g_botInterfaceMapCache;
-static botinterface_entity_snapshot_t g_botInterfaceEntityCache[BOT_INTERFACE_MAX_ENTITIES];
+static botinterface_entity_cache_t g_botInterfaceEntities;
 static float g_botInterfaceFrameTime = 0.0f;
 static unsigned int g_botInterfaceFrameNumber = 0;
 static bool g_botInterfaceDebugDrawEnabled = false;
@@ -110,9 +130,9 @@ static int BotAI_MaxTrackedClients(void)
     {
         value = 0;
     }
-    if (value > BOT_INTERFACE_MAX_ENTITIES)
+    if (value > g_botInterfaceEntities.capacity)
     {
-        value = BOT_INTERFACE_MAX_ENTITIES;
+        value = g_botInterfaceEntities.capacity;
     }
     return value;
 }
@@ -214,6 +234,12 @@ static bool BotInterface_HasLineOfSight(const vec3_t from,
     return trace.fraction >= 1.0f || trace.ent == target;
 }
 
+/* Cheap PVS reject ahead of the engine trace; unknown clusters pass. */
+static bool BotInterface_PotentiallyVisible(const bot_client_state_t *viewer, int target)
+{
+    return AAS_BSPClustersVisible(viewer->eye_cluster, g_botInterfaceEntities.hot[target].cluster) ? true : false;
+}
+
 static bool BotInterface_SameTeam(const bot_client_state_t *lhs, const bot_client_state_t *rhs)
 {
     if (lhs == NULL || rhs == NULL)
@@ -239,26 +265,48 @@ static bool BotInterface_IsChatting(const bot_client_state_t *state)
     return (state->last_client_update.stats[STAT_LAYOUTS] & 1) != 0;
 }
 
-static bool BotInterface_IsInvisible(const bot_updateentity_t *snapshot)
+static int BotInterface_EntityFlags(const bot_updateentity_t *snapshot)
 {
-    if (snapshot == NULL)
+    const int weapon_fx = EF_BLASTER | EF_ROCKET | EF_GRENADE | EF_HYPERBLASTER | EF_BFG | EF_IONRIPPER |
+                          EF_BLUEHYPERBLASTER | EF_TRACKER | EF_PLASMA;
+
+    int flags = BOTINTERFACE_ENTITY_VALID;
+    if ((snapshot->renderfx & RF_TRANSLUCENT) != 0)
     {
-        return false;
+        flags |= BOTINTERFACE_ENTITY_INVISIBLE;
     }
-
-    return (snapshot->renderfx & RF_TRANSLUCENT) != 0;
+    if ((snapshot->effects & weapon_fx) != 0)
+    {
+        flags |= BOTINTERFACE_ENTITY_SHOOTING;
+    }
+    return flags;
 }
 
-static bool BotInterface_IsShooting(const bot_updateentity_t *snapshot)
+/* NULL unless the entity has a cached update. */
+static const botinterface_entity_hot_t *BotInterface_EntityHot(int ent)
 {
-    if (snapshot == NULL)
+    if (ent < 0 || ent >= g_botInterfaceEntities.capacity)
     {
-        return false;
+        return NULL;
     }
 
-    const int weapon_fx = EF_BLASTER | EF_ROCKET | EF_GRENADE | EF_HYPERBLASTER | EF_BFG | EF_IONRIPPER |
-                          EF_BLUEHYPERBLASTER | EF_TRACKER | EF_PLASMA;
-    return (snapshot->effects & weapon_fx) != 0;
+    const botinterface_entity_hot_t *hot = &g_botInterfaceEntities.hot[ent];
+    return ((hot->flags & BOTINTERFACE_ENTITY_VALID) != 0) ? hot : NULL;
+}
+
+static const bot_updateentity_t *BotInterface_EntityState(int ent)
+{
+    return (BotInterface_EntityHot(ent) != NULL) ? &g_botInterfaceEntities.state[ent] : NULL;
+}
+
+static bool BotInterface_IsInvisible(const botinterface_entity_hot_t *entity)
+{
+    return (entity->flags & BOTINTERFACE_ENTITY_INVISIBLE) != 0;
+}
+
+static bool BotInterface_IsShooting(const botinterface_entity_hot_t *entity)
+{
+    return (entity->flags & BOTINTERFACE_ENTITY_SHOOTING) != 0;
 }
 
 static float BotInterface_VectorLengthSquared(const vec3_t v)
@@ -271,35 +319,68 @@ static float BotInterface_VectorLengthSquared(const vec3_t v)
     return v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
 }
 
-static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy)
+#define BOTAI_MAX_ENEMY_CANDIDATES MAX_CLIENTS
+
+typedef struct botai_enemy_candidate_s
 {
-    if (enemy == NULL)
-    {
-        return;
-    }
+    int entity;
+    float distance_sq;
+    float fov;
+    bool invisible;
+    bool shooting;
+    bool chatting;
+} botai_enemy_candidate_t;
 
-    BotAI_InitEnemyInfo(enemy);
+/*
+ * The enemy search, split around its line-of-sight traces.  The candidates
+ * are kept in the order the search would have traced them, so the first one
+ * with a clear line of sight is the enemy.
+ */
+typedef struct botai_enemy_scan_s
+{
+    bool active;
+    bool health_drop;
+    float alertness;
+    float easyfragger;
+    int current_enemy; /* -1 when the bot has none */
+    vec3_t eye_position;
+    int numCandidates;
+    int selected; /* first candidate in sight, -1 = none */
+    botai_enemy_candidate_t candidates[BOTAI_MAX_ENEMY_CANDIDATES];
+} botai_enemy_scan_t;
 
-    if (state == NULL)
-    {
-        return;
-    }
+static void BotAI_ClearEnemyScan(botai_enemy_scan_t *scan)
+{
+    scan->active = false;
+    scan->health_drop = false;
+    scan->alertness = 0.5f;
+    scan->easyfragger = 1.0f;
+    scan->current_enemy = -1;
+    VectorClear(scan->eye_position);
+    scan->numCandidates = 0;
+    scan->selected = -1;
+}
 
-    if (!state->client_update_valid)
+/* Main thread: damage tracking and the characteristics the search depends on. */
+static void BotAI_BeginEnemyScan(bot_client_state_t *state, botai_enemy_scan_t *scan)
+{
+    BotAI_ClearEnemyScan(scan);
+
+    if (state == NULL || !state->client_update_valid)
     {
         return;
     }
 
-    bot_combat_state_t *combat = &state->combat;
+    scan->active = true;
 
+    bot_combat_state_t *combat = &state->combat;
     int current_health = state->last_client_update.stats[STAT_HEALTH];
-    bool health_drop = false;
     if (combat->last_health_valid && current_health < combat->last_known_health)
     {
         combat->took_damage = true;
         combat->last_damage_amount = combat->last_known_health - current_health;
         combat->last_damage_time = g_botInterfaceFrameTime;
-        health_drop = true;
+        scan->health_drop = true;
     }
     else
     {
@@ -308,26 +389,57 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
     combat->last_known_health = current_health;
     combat->last_health_valid = true;
 
-    float alertness = 0.5f;
-    float easyfragger = 1.0f;
     if (state->character_handle > 0)
     {
-        alertness = Characteristic_BFloat(state->character_handle, CHARACTERISTIC_ALERTNESS, 0.0f, 1.0f);
-        easyfragger = Characteristic_BFloat(state->character_handle, CHARACTERISTIC_EASY_FRAGGER, 0.0f, 1.0f);
+        scan->alertness = Characteristic_BFloat(state->character_handle, CHARACTERISTIC_ALERTNESS, 0.0f, 1.0f);
+        scan->easyfragger = Characteristic_BFloat(state->character_handle, CHARACTERISTIC_EASY_FRAGGER, 0.0f, 1.0f);
     }
+}
+
+static void BotAI_AddEnemyCandidate(botai_enemy_scan_t *scan,
+                                    int entity,
+                                    float distance_sq,
+                                    float fov,
+                                    bool invisible,
+                                    bool shooting,
+                                    bool chatting)
+{
+    if (scan->numCandidates >= BOTAI_MAX_ENEMY_CANDIDATES)
+    {
+        return;
+    }
+
+    botai_enemy_candidate_t *candidate = &scan->candidates[scan->numCandidates++];
+    candidate->entity = entity;
+    candidate->distance_sq = distance_sq;
+    candidate->fov = fov;
+    candidate->invisible = invisible;
+    candidate->shooting = shooting;
+    candidate->chatting = chatting;
+}
+
+/*
+ * Every test short of the trace.  Only reads this frame's snapshots and only
+ * writes the bot's own combat state, so BotAIFrame runs it on worker threads.
+ */
+static void BotAI_GatherEnemyCandidates(bot_client_state_t *state, botai_enemy_scan_t *scan)
+{
+    if (!scan->active)
+    {
+        return;
+    }
+
+    bot_combat_state_t *combat = &state->combat;
 
     vec3_t self_origin;
     VectorCopy(state->last_client_update.origin, self_origin);
-    vec3_t eye_position;
-    BotInterface_ClientEyePosition(state, eye_position);
+    BotInterface_ClientEyePosition(state, scan->eye_position);
 
     int curenemy = combat->current_enemy;
-    const bot_updateentity_t *current_snapshot = NULL;
+    const botinterface_entity_hot_t *current_snapshot = BotInterface_EntityHot(curenemy);
     float current_enemy_dist_sq = FLT_MAX;
-    if (curenemy >= 0 && curenemy < BOT_INTERFACE_MAX_ENTITIES &&
-        g_botInterfaceEntityCache[curenemy].valid)
+    if (current_snapshot != NULL)
     {
-        current_snapshot = &g_botInterfaceEntityCache[curenemy].state;
         vec3_t delta;
         VectorSubtract(current_snapshot->origin, self_origin, delta);
         current_enemy_dist_sq = BotInterface_VectorLengthSquared(delta);
@@ -337,6 +449,7 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
         curenemy = -1;
         combat->current_enemy = -1;
     }
+    scan->current_enemy = curenemy;
 
     if (curenemy >= 0 && current_snapshot != NULL)
     {
@@ -348,7 +461,7 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
         if (!(invisible && !shooting))
         {
             vec3_t to_enemy;
-            VectorSubtract(current_snapshot->origin, eye_position, to_enemy);
+            VectorSubtract(current_snapshot->origin, scan->eye_position, to_enemy);
             vec3_t target_angles;
             BotInterface_VectorToAngles(to_enemy, target_angles);
 
@@ -357,48 +470,15 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
                                 : current_enemy_dist_sq;
             float fov = 90.0f + (limited / (810.0f * 9.0f));
             bool in_fov = BotInterface_InFieldOfVision(state->last_client_update.viewangles, fov, target_angles);
-            bool has_los = BotInterface_HasLineOfSight(eye_position, current_snapshot->origin, state->client_number, curenemy);
-
-            if (in_fov && has_los)
+            if (in_fov && BotInterface_PotentiallyVisible(state, curenemy))
             {
-                enemy->valid = true;
-                enemy->visible = true;
-                enemy->entity = curenemy;
-                VectorCopy(current_snapshot->origin, enemy->origin);
-                vec3_t displacement;
-                VectorSubtract(current_snapshot->origin, current_snapshot->old_origin, displacement);
-                VectorCopy(displacement, enemy->velocity);
-                enemy->distance = sqrtf(current_enemy_dist_sq);
-                enemy->last_seen_time = g_botInterfaceFrameTime;
-                enemy->field_of_view = fov;
-                enemy->is_invisible = invisible;
-                enemy->is_chatting = chatting;
-                enemy->is_shooting = shooting;
-                enemy->triggered_by_damage = health_drop;
-                enemy->in_field_of_view = in_fov;
-                enemy->has_line_of_sight = has_los;
-
-                combat->current_enemy = curenemy;
-                combat->enemy_visible = true;
-                combat->enemy_visible_time = g_botInterfaceFrameTime;
-                combat->enemy_last_seen_time = g_botInterfaceFrameTime;
-                VectorCopy(current_snapshot->origin, combat->last_enemy_origin);
-                VectorCopy(displacement, combat->last_enemy_velocity);
-                combat->enemy_death_time = -FLT_MAX;
-                return;
+                BotAI_AddEnemyCandidate(scan, curenemy, current_enemy_dist_sq, fov, invisible, shooting, chatting);
             }
         }
     }
 
-    bool had_visible_enemy = combat->enemy_visible;
-    combat->enemy_visible = false;
-    if (had_visible_enemy)
-    {
-        combat->enemy_death_time = g_botInterfaceFrameTime;
-    }
-
     int max_clients = BotAI_MaxTrackedClients();
-    float max_range = 900.0f + alertness * 4000.0f;
+    float max_range = 900.0f + scan->alertness * 4000.0f;
     float max_range_sq = max_range * max_range;
 
     for (int ent = 0; ent < max_clients; ++ent)
@@ -408,17 +488,12 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
             continue;
         }
 
-        if (ent < 0 || ent >= BOT_INTERFACE_MAX_ENTITIES)
-        {
-            continue;
-        }
-
-        if (!g_botInterfaceEntityCache[ent].valid)
+        const botinterface_entity_hot_t *snapshot = BotInterface_EntityHot(ent);
+        if (snapshot == NULL)
         {
             continue;
         }
 
-        const bot_updateentity_t *snapshot = &g_botInterfaceEntityCache[ent].state;
         vec3_t delta;
         VectorSubtract(snapshot->origin, self_origin, delta);
         float distance_sq = BotInterface_VectorLengthSquared(delta);
@@ -447,16 +522,16 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
         }
 
         bool chatting = BotInterface_IsChatting(other);
-        if (easyfragger < 0.5f && chatting)
+        if (scan->easyfragger < 0.5f && chatting)
         {
             continue;
         }
 
         float limited = (distance_sq > 810.0f * 810.0f) ? 810.0f * 810.0f : distance_sq;
-        float fov = (curenemy < 0 && (health_drop || shooting)) ? 360.0f : 90.0f + (limited / (810.0f * 9.0f));
+        float fov = (curenemy < 0 && (scan->health_drop || shooting)) ? 360.0f : 90.0f + (limited / (810.0f * 9.0f));
 
         vec3_t to_enemy;
-        VectorSubtract(snapshot->origin, eye_position, to_enemy);
+        VectorSubtract(snapshot->origin, scan->eye_position, to_enemy);
         vec3_t target_angles;
         BotInterface_VectorToAngles(to_enemy, target_angles);
         bool in_fov = BotInterface_InFieldOfVision(state->last_client_update.viewangles, fov, target_angles);
@@ -465,13 +540,12 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
             continue;
         }
 
-        bool has_los = BotInterface_HasLineOfSight(eye_position, snapshot->origin, state->client_number, ent);
-        if (!has_los)
+        if (!BotInterface_PotentiallyVisible(state, ent))
         {
             continue;
         }
 
-        if (curenemy < 0 && distance_sq > (100.0f * 100.0f) && !health_drop && !shooting)
+        if (curenemy < 0 && distance_sq > (100.0f * 100.0f) && !scan->health_drop && !shooting)
         {
             bool bot_in_enemy_fov = true;
             if (other != NULL)
@@ -489,42 +563,115 @@ static void BotAI_FindEnemy(bot_client_state_t *state, ai_dm_enemy_info_t *enemy
             }
         }
 
-        enemy->valid = true;
-        enemy->visible = true;
-        enemy->entity = ent;
-        VectorCopy(snapshot->origin, enemy->origin);
-        vec3_t displacement;
-        VectorSubtract(snapshot->origin, snapshot->old_origin, displacement);
-        VectorCopy(displacement, enemy->velocity);
-        enemy->distance = sqrtf(distance_sq);
-        enemy->last_seen_time = g_botInterfaceFrameTime;
-        enemy->field_of_view = fov;
-        enemy->is_invisible = invisible;
-        enemy->is_chatting = chatting;
-        enemy->is_shooting = shooting;
-        enemy->triggered_by_damage = health_drop;
-        enemy->in_field_of_view = in_fov;
-        enemy->has_line_of_sight = has_los;
-
-        bool enemy_changed = (combat->current_enemy != ent);
-        combat->current_enemy = ent;
-        combat->enemy_visible = true;
-        combat->enemy_visible_time = g_botInterfaceFrameTime;
-        combat->enemy_last_seen_time = g_botInterfaceFrameTime;
-        combat->enemy_death_time = -FLT_MAX;
-        VectorCopy(snapshot->origin, combat->last_enemy_origin);
-        VectorCopy(displacement, combat->last_enemy_velocity);
-        if (enemy_changed && curenemy >= 0)
-        {
-            combat->enemy_sight_time = g_botInterfaceFrameTime - 2.0f;
+        BotAI_AddEnemyCandidate(scan, ent, distance_sq, fov, invisible, shooting, chatting);
+    }
+}
+
+/* Main thread: traces candidates in order until one is in sight. */
+static void BotAI_ResolveEnemyCandidates(const bot_client_state_t *state, botai_enemy_scan_t *scan)
+{
+    for (int index = 0; index < scan->numCandidates && scan->selected < 0; ++index)
+    {
+        const botai_enemy_candidate_t *candidate = &scan->candidates[index];
+        const botinterface_entity_hot_t *snapshot = &g_botInterfaceEntities.hot[candidate->entity];
+        if (BotInterface_HasLineOfSight(scan->eye_position,
+                                        snapshot->origin,
+                                        state->client_number,
+                                        candidate->entity))
+        {
+            scan->selected = index;
         }
-        else
+    }
+}
+
+static void BotAI_ApplyEnemyScan(bot_client_state_t *state, const botai_enemy_scan_t *scan, ai_dm_enemy_info_t *enemy)
+{
+    BotAI_InitEnemyInfo(enemy);
+
+    if (!scan->active)
+    {
+        return;
+    }
+
+    bot_combat_state_t *combat = &state->combat;
+    const botai_enemy_candidate_t *chosen = (scan->selected >= 0) ? &scan->candidates[scan->selected] : NULL;
+    bool kept_current = (chosen != NULL && chosen->entity == scan->current_enemy);
+
+    if (!kept_current)
+    {
+        bool had_visible_enemy = combat->enemy_visible;
+        combat->enemy_visible = false;
+        if (had_visible_enemy)
         {
-            combat->enemy_sight_time = g_botInterfaceFrameTime;
+            combat->enemy_death_time = g_botInterfaceFrameTime;
         }
+    }
 
+    if (chosen == NULL)
+    {
         return;
     }
+
+    const botinterface_entity_hot_t *snapshot = &g_botInterfaceEntities.hot[chosen->entity];
+    vec3_t displacement;
+    VectorSubtract(snapshot->origin, snapshot->old_origin, displacement);
+
+    enemy->valid = true;
+    enemy->visible = true;
+    enemy->entity = chosen->entity;
+    VectorCopy(snapshot->origin, enemy->origin);
+    VectorCopy(displacement, enemy->velocity);
+    enemy->distance = sqrtf(chosen->distance_sq);
+    enemy->last_seen_time = g_botInterfaceFrameTime;
+    enemy->field_of_view = chosen->fov;
+    enemy->is_invisible = chosen->invisible;
+    enemy->is_chatting = chosen->chatting;
+    enemy->is_shooting = chosen->shooting;
+    enemy->triggered_by_damage = scan->health_drop;
+    enemy->in_field_of_view = true;
+    enemy->has_line_of_sight = true;
+
+    bool enemy_changed = (combat->current_enemy != chosen->entity);
+    combat->current_enemy = chosen->entity;
+    combat->enemy_visible = true;
+    combat->enemy_visible_time = g_botInterfaceFrameTime;
+    combat->enemy_last_seen_time = g_botInterfaceFrameTime;
+    combat->enemy_death_time = -FLT_MAX;
+    VectorCopy(snapshot->origin, combat->last_enemy_origin);
+    VectorCopy(displacement, combat->last_enemy_velocity);
+    if (kept_current)
+    {
+        return;
+    }
+
+    if (enemy_changed && scan->current_enemy >= 0)
+    {
+        combat->enemy_sight_time = g_botInterfaceFrameTime - 2.0f;
+    }
+    else
+    {
+        combat->enemy_sight_time = g_botInterfaceFrameTime;
+    }
+}
+
+typedef struct botai_think_s
+{
+    bot_client_state_t *state;
+    float thinktime;
+    int status;
+    ai_goal_selection_t selection;
+    bot_input_t input;
+    botai_enemy_scan_t enemy_scan;
+} botai_think_t;
+
+static botai_think_t *g_botAIFrameWork = NULL;
+static int g_botAIFrameWorkCapacity = 0;
+
+static void BotAI_FreeFrameWork(void)
+{
+    free(g_botAIFrameWork);
+    g_botAIFrameWork = NULL;
+    g_botAIFrameWorkCapacity = 0;
 }
 
 static void BotInterface_SynchroniseCombatState(bot_client_state_t *state)
@@ -645,14 +792,59 @@ static bool BotInterface_CopyAssetList(botinterface_asset_list_t *target,
     return true;
 }
 
+/* Grows both columns geometrically to hold at least count entities. */
+static bool BotInterface_EnsureEntityCache(int count)
+{
+    botinterface_entity_cache_t *cache = &g_botInterfaceEntities;
+    if (count <= cache->capacity)
+    {
+        return true;
+    }
+
+    int capacity = (cache->capacity > 0) ? cache->capacity : BOT_INTERFACE_MIN_ENTITIES;
+    while (capacity < count)
+    {
+        capacity *= 2;
+    }
+
+    botinterface_entity_hot_t *hot =
+        (botinterface_entity_hot_t *)realloc(cache->hot, (size_t)capacity * sizeof(*hot));
+    if (hot == NULL)
+    {
+        return false;
+    }
+    cache->hot = hot;
+
+    bot_updateentity_t *state = (bot_updateentity_t *)realloc(cache->state, (size_t)capacity * sizeof(*state));
+    if (state == NULL)
+    {
+        return false;
+    }
+    cache->state = state;
+
+    size_t added = (size_t)(capacity - cache->capacity);
+    memset(cache->hot + cache->capacity, 0, added * sizeof(*cache->hot));
+    memset(cache->state + cache->capacity, 0, added * sizeof(*cache->state));
+    cache->capacity = capacity;
+    return true;
+}
+
 static void BotInterface_ResetEntityCache(void)
 {
-    for (size_t index = 0; index < BOT_INTERFACE_MAX_ENTITIES; ++index)
+    botinterface_entity_cache_t *cache = &g_botInterfaceEntities;
+    if (cache->hot != NULL)
     {
-        g_botInterfaceEntityCache[index].valid = qfalse;
+        memset(cache->hot, 0, (size_t)cache->capacity * sizeof(*cache->hot));
     }
 }
 
+static void BotInterface_FreeEntityCache(void)
+{
+    free(g_botInterfaceEntities.hot);
+    free(g_botInterfaceEntities.state);
+    memset(&g_botInterfaceEntities, 0, sizeof(g_botInterfaceEntities));
+}
+
 static void BotInterface_ResetMapCache(void)
 {
     BotMove_MoverCatalogueReset();
@@ -1105,8 +1297,6 @@ static void BotInterface_BeginFrame(float time)
     g_botInterfaceFrameNumber += 1U;
     Bridge_SetFrameTime(time);
     AAS_SoundSubsystem_SetFrameTime(time);
-    AAS_RouteFrameUpdate();
-    AAS_ReachabilityFrameUpdate();
     BotInterface_ResetFrameQueues();
 
     for (int client = 0; client < MAX_CLIENTS; ++client)
@@ -1662,6 +1852,9 @@ static int BotShutdownLibraryWrapper(void)
     BotInterface_ResetMapCache();
     BotInterface_ResetEntityCache();
     BotInterface_ResetFrameQueues();
+    BotWorkers_Shutdown();
+    BotAI_FreeFrameWork();
+    BotInterface_FreeEntityCache();
     g_botInterfaceDebugDrawEnabled = false;
     Q2Bridge_SetDebugLinesEnabled(false);
 
@@ -1690,6 +1883,9 @@ static int BotInterface_BotShutdownLibrary(void)
     BotInterface_ResetMapCache();
     BotInterface_ResetEntityCache();
     BotInterface_ResetFrameQueues();
+    BotWorkers_Shutdown();
+    BotAI_FreeFrameWork();
+    BotInterface_FreeEntityCache();
     g_botInterfaceDebugDrawEnabled = false;
     Q2Bridge_SetDebugLinesEnabled(false);
 
@@ -1789,6 +1985,12 @@ static int BotLoadMap(char *mapname,
     BotInterface_ResetMapCache();
     TranslateEntity_SetWorldLoaded(qfalse);
 
+    if (!BotInterface_EnsureEntityCache(Bridge_EntityLimit()))
+    {
+        BotInterface_Printf(PRT_ERROR, "[bot_interface] BotLoadMap: failed to allocate the entity cache\n");
+        return BLERR_INVALIDIMPORT;
+    }
+
     int status = AAS_LoadMap(mapname,
                              modelindexes,
                              modelindex,
@@ -2124,6 +2326,65 @@ static int BotStartFrame(float time)
     return BLERR_NOERROR;
 }
 
+static int BotInterface_StoreClientUpdate(bot_client_state_t *state, int client, bot_updateclient_t *buc)
+{
+    int status = Bridge_UpdateClient(client, buc);
+    if (status != BLERR_NOERROR)
+    {
+        return status;
+    }
+
+    const AASClientFrame *translated = Bridge_ClientFrame(client);
+    if (translated == NULL)
+    {
+        return BLERR_AIUPDATEINACTIVECLIENT;
+    }
+
+    bot_updateclient_t *quantised = &state->last_client_update;
+    memset(quantised, 0, sizeof(*quantised));
+    quantised->pm_type = translated->pm_type;
+    VectorCopy(translated->origin, quantised->origin);
+    VectorCopy(translated->velocity, quantised->velocity);
+    VectorCopy(translated->delta_angles, quantised->delta_angles);
+    quantised->pm_flags = translated->pm_flags;
+    quantised->pm_time = translated->pm_time;
+    quantised->gravity = translated->gravity;
+    VectorCopy(translated->viewangles, quantised->viewangles);
+    VectorCopy(translated->viewoffset, quantised->viewoffset);
+    VectorCopy(translated->kick_angles, quantised->kick_angles);
+    VectorCopy(translated->gunangles, quantised->gunangles);
+    VectorCopy(translated->gunoffset, quantised->gunoffset);
+    quantised->gunindex = translated->gunindex;
+    quantised->gunframe = translated->gunframe;
+    memcpy(quantised->blend, translated->blend, sizeof(quantised->blend));
+    quantised->fov = translated->fov;
+    quantised->rdflags = translated->rdflags;
+    memcpy(quantised->stats, translated->stats, sizeof(quantised->stats));
+    memcpy(quantised->inventory, translated->inventory, sizeof(quantised->inventory));
+
+    if (buc != NULL)
+    {
+        *buc = *quantised;
+    }
+
+    state->client_update_valid = true;
+    vec3_t eye;
+    BotInterface_ClientEyePosition(state, eye);
+    state->eye_cluster = AAS_BSPPointCluster(eye);
+    state->last_update_time = translated->last_update_time;
+
+    if (state->goal_state != NULL)
+    {
+        status = AI_GoalState_RecordClientUpdate(state->goal_state, quantised);
+        if (status != BLERR_NOERROR)
+        {
+            return status;
+        }
+    }
+
+    return BLERR_NOERROR;
+}
+
 static int BotUpdateClient(int client, bot_updateclient_t *buc)
 {
     if (g_botImport == NULL)
@@ -2144,55 +2405,81 @@ static int BotUpdateClient(int client, bot_updateclient_t *buc)
         return BLERR_AIUPDATEINACTIVECLIENT;
     }
 
-    int status = Bridge_UpdateClient(client, buc);
-    if (status != BLERR_NOERROR)
+    return BotInterface_StoreClientUpdate(state, client, buc);
+}
+
+/* BotUpdateClient for a batch; returns the first error, the other clients are still updated. */
+static int BotUpdateClients(int *clients, bot_updateclient_t *bucs, int count)
+{
+    if (g_botImport == NULL)
     {
-        return status;
+        return BLERR_LIBRARYNOTSETUP;
     }
 
-    AASClientFrame translated;
-    if (!Bridge_ReadClientFrame(client, &translated))
+    if (!BotLibraryInitialized())
     {
-        return BLERR_AIUPDATEINACTIVECLIENT;
+        BotInterface_Printf(PRT_ERROR, "[bot_interface] BotUpdateClients: library not initialised\n");
+        return BLERR_LIBRARYNOTSETUP;
     }
 
-    bot_updateclient_t quantised = {0};
-    quantised.pm_type = translated.pm_type;
-    VectorCopy(translated.origin, quantised.origin);
-    VectorCopy(translated.velocity, quantised.velocity);
-    VectorCopy(translated.delta_angles, quantised.delta_angles);
-    quantised.pm_flags = translated.pm_flags;
-    quantised.pm_time = translated.pm_time;
-    quantised.gravity = translated.gravity;
-    VectorCopy(translated.viewangles, quantised.viewangles);
-    VectorCopy(translated.viewoffset, quantised.viewoffset);
-    VectorCopy(translated.kick_angles, quantised.kick_angles);
-    VectorCopy(translated.gunangles, quantised.gunangles);
-    VectorCopy(translated.gunoffset, quantised.gunoffset);
-    quantised.gunindex = translated.gunindex;
-    quantised.gunframe = translated.gunframe;
-    memcpy(quantised.blend, translated.blend, sizeof(quantised.blend));
-    quantised.fov = translated.fov;
-    quantised.rdflags = translated.rdflags;
-    memcpy(quantised.stats, translated.stats, sizeof(quantised.stats));
-    memcpy(quantised.inventory, translated.inventory, sizeof(quantised.inventory));
-
-    if (buc != NULL)
+    if (count <= 0)
     {
-        *buc = quantised;
+        return BLERR_NOERROR;
     }
 
-    state->last_client_update = quantised;
-    state->client_update_valid = true;
-    state->last_update_time = translated.last_update_time;
+    if (clients == NULL || bucs == NULL)
+    {
+        return BLERR_INVALIDCLIENTNUMBER;
+    }
 
-    if (state->goal_state != NULL)
+    int result = BLERR_NOERROR;
+    for (int index = 0; index < count; ++index)
     {
-        status = AI_GoalState_RecordClientUpdate(state->goal_state, &quantised);
-        if (status != BLERR_NOERROR)
+        int client = clients[index];
+        int status = BLERR_AIUPDATEINACTIVECLIENT;
+        bot_client_state_t *state = BotState_Get(client);
+        if (state == NULL || !state->active)
         {
-            return status;
+            BotInterface_Printf(PRT_WARNING, "[bot_interface] BotUpdateClients: client %d inactive\n", client);
+        }
+        else
+        {
+            status = BotInterface_StoreClientUpdate(state, client, &bucs[index]);
         }
+
+        if (result == BLERR_NOERROR)
+        {
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Hands a translated bridge frame to AAS and mirrors the raw update for the
+ * enemy scans.  AAS still has to see unchanged entities to keep them in use
+ * this frame, but their frame carries no dirty flags so nothing is relinked,
+ * and the mirrored copy is already current.
+ */
+static int BotInterface_StoreEntityFrame(int ent, const bot_updateentity_t *bue, const AASEntityFrame *frame)
+{
+    int status = AAS_UpdateEntity(ent, frame);
+    if (status != BLERR_NOERROR)
+    {
+        Bridge_ClearEntitySlot(ent);
+        return status;
+    }
+
+    if (ent >= 0 && BotInterface_EnsureEntityCache(ent + 1)
+        && (Bridge_EntityChanged(ent) || BotInterface_EntityHot(ent) == NULL))
+    {
+        botinterface_entity_hot_t *hot = &g_botInterfaceEntities.hot[ent];
+        VectorCopy(bue->origin, hot->origin);
+        VectorCopy(bue->old_origin, hot->old_origin);
+        hot->flags = BotInterface_EntityFlags(bue);
+        hot->cluster = AAS_BSPPointCluster(bue->origin);
+        g_botInterfaceEntities.state[ent] = *bue;
     }
 
     return BLERR_NOERROR;
@@ -2213,6 +2500,7 @@ static int BotUpdateEntity(int ent, bot_updateentity_t *bue)
 
     if (bue == NULL)
     {
+        Bridge_ClearEntitySlot(ent);
         return AAS_UpdateEntity(ent, NULL);
     }
 
@@ -2222,26 +2510,79 @@ static int BotUpdateEntity(int ent, bot_updateentity_t *bue)
         return status;
     }
 
-    AASEntityFrame translated = {0};
-    if (!Bridge_ReadEntityFrame(ent, &translated))
+    const AASEntityFrame *translated = Bridge_EntityFrame(ent);
+    if (translated == NULL)
     {
         return BLERR_INVALIDIMPORT;
     }
 
-    status = AAS_UpdateEntity(ent, &translated);
+    status = BotInterface_StoreEntityFrame(ent, bue, translated);
     if (status != BLERR_NOERROR)
     {
         return status;
     }
 
-    if (bue != NULL && ent >= 0 && ent < BOT_INTERFACE_MAX_ENTITIES)
+    aasworld.entitiesValid = qtrue;
+    return BLERR_NOERROR;
+}
+
+/*
+ * BotUpdateEntity for a batch.  The bridge validates and translates the
+ * whole batch in one pass, then each translated frame goes to AAS without
+ * being copied out of the bridge.  Entries that fail are skipped and the
+ * first error is returned.  Removing an entity still goes through
+ * BotUpdateEntity(ent, NULL).
+ */
+static int BotUpdateEntities(int *ents, bot_updateentity_t *bues, int count)
+{
+    if (g_botImport == NULL)
     {
-        g_botInterfaceEntityCache[ent].state = *bue;
-        g_botInterfaceEntityCache[ent].valid = qtrue;
+        return BLERR_LIBRARYNOTSETUP;
     }
 
-    aasworld.entitiesValid = qtrue;
-    return BLERR_NOERROR;
+    if (!BotLibraryInitialized())
+    {
+        BotInterface_Printf(PRT_ERROR, "[bot_interface] BotUpdateEntities: library not initialised\n");
+        return BLERR_LIBRARYNOTSETUP;
+    }
+
+    if (count <= 0)
+    {
+        return BLERR_NOERROR;
+    }
+
+    int result = Bridge_UpdateEntities(ents, bues, count);
+    if (ents == NULL || bues == NULL || result == BLERR_LIBRARYNOTSETUP)
+    {
+        return result;
+    }
+
+    bool stored = false;
+    for (int index = 0; index < count; ++index)
+    {
+        const AASEntityFrame *translated = Bridge_EntityFrame(ents[index]);
+        if (translated == NULL)
+        {
+            continue;
+        }
+
+        int status = BotInterface_StoreEntityFrame(ents[index], &bues[index], translated);
+        if (status != BLERR_NOERROR)
+        {
+            if (result == BLERR_NOERROR)
+            {
+                result = status;
+            }
+            continue;
+        }
+        stored = true;
+    }
+
+    if (stored)
+    {
+        aasworld.entitiesValid = qtrue;
+    }
+    return result;
 }
 
 static int BotAddSound(vec3_t origin,
@@ -2300,8 +2641,13 @@ static int BotAddPointLight(vec3_t origin,
     return BLERR_NOERROR;
 }
 
-static int BotAI_Think(bot_client_state_t *state, float thinktime)
+/* Weapon, goal and movement work: these subsystems share state between bots, so this part stays serial. */
+static int BotAI_ThinkBegin(bot_client_state_t *state, float thinktime, botai_think_t *think)
 {
+    think->state = state;
+    think->thinktime = thinktime;
+    BotAI_ClearEnemyScan(&think->enemy_scan);
+
     if (state == NULL)
     {
         return BLERR_AIUPDATEINACTIVECLIENT;
@@ -2350,31 +2696,40 @@ static int BotAI_Think(bot_client_state_t *state, float thinktime)
         return status;
     }
 
-    ai_goal_selection_t selection = {0};
-    status = AI_GoalOrchestrator_Refresh(state->goal_state, g_botInterfaceFrameTime, &selection);
+    memset(&think->selection, 0, sizeof(think->selection));
+    status = AI_GoalOrchestrator_Refresh(state->goal_state, g_botInterfaceFrameTime, &think->selection);
     if (status != BLERR_NOERROR)
     {
         return status;
     }
 
-    bot_input_t input = {0};
-    status = AI_MoveOrchestrator_Dispatch(state->move_state, &selection, &input);
+    memset(&think->input, 0, sizeof(think->input));
+    status = AI_MoveOrchestrator_Dispatch(state->move_state, &think->selection, &think->input);
     if (status != BLERR_NOERROR)
     {
         return status;
     }
 
-    ai_dm_enemy_info_t enemy_info;
-    BotAI_InitEnemyInfo(&enemy_info);
     if (state->dm_state != NULL)
     {
-        BotAI_FindEnemy(state, &enemy_info);
+        BotAI_BeginEnemyScan(state, &think->enemy_scan);
     }
 
-    input.thinktime = thinktime;
-    VectorCopy(state->last_client_update.viewangles, input.viewangles);
+    return BLERR_NOERROR;
+}
+
+static int BotAI_ThinkFinish(botai_think_t *think)
+{
+    bot_client_state_t *state = think->state;
 
-    status = AI_MoveOrchestrator_Submit(state->move_state, state->client_number, &input);
+    ai_dm_enemy_info_t enemy_info;
+    BotAI_ApplyEnemyScan(state, &think->enemy_scan, &enemy_info);
+
+    bot_input_t *input = &think->input;
+    input->thinktime = think->thinktime;
+    VectorCopy(state->last_client_update.viewangles, input->viewangles);
+
+    int status = AI_MoveOrchestrator_Submit(state->move_state, state->client_number, input);
     if (status != BLERR_NOERROR)
     {
         return status;
@@ -2384,15 +2739,15 @@ static int BotAI_Think(bot_client_state_t *state, float thinktime)
     {
         AI_DMState_Update(state->dm_state,
                           state,
-                          &selection,
+                          &think->selection,
                           &enemy_info,
-                          &input,
+                          input,
                           g_botInterfaceFrameTime);
         BotInterface_SynchroniseCombatState(state);
     }
 
     bot_input_t final_input = {0};
-    status = EA_GetInput(state->client_number, thinktime, &final_input);
+    status = EA_GetInput(state->client_number, think->thinktime, &final_input);
     if (status != BLERR_NOERROR)
     {
         return status;
@@ -2404,6 +2759,20 @@ static int BotAI_Think(bot_client_state_t *state, float thinktime)
     return BLERR_NOERROR;
 }
 
+static int BotAI_Think(bot_client_state_t *state, float thinktime)
+{
+    botai_think_t think;
+    int status = BotAI_ThinkBegin(state, thinktime, &think);
+    if (status != BLERR_NOERROR)
+    {
+        return status;
+    }
+
+    BotAI_GatherEnemyCandidates(state, &think.enemy_scan);
+    BotAI_ResolveEnemyCandidates(state, &think.enemy_scan);
+    return BotAI_ThinkFinish(&think);
+}
+
 static int BotAI(int client, float thinktime)
 {
     if (g_botImport == NULL)
@@ -2427,6 +2796,121 @@ static int BotAI(int client, float thinktime)
     return BotAI_Think(state, thinktime);
 }
 
+static void BotAI_GatherEnemyCandidatesJob(void *context, int index)
+{
+    botai_think_t *think = &((botai_think_t *)context)[index];
+    if (think->status == BLERR_NOERROR)
+    {
+        BotAI_GatherEnemyCandidates(think->state, &think->enemy_scan);
+    }
+}
+
+static int BotAI_FrameThreads(void)
+{
+    libvar_t *threads = Bridge_AIThreads();
+    return (threads != NULL) ? (int)threads->value : 0;
+}
+
+/*
+ * BotAI for a batch of clients.  Each bot's think runs in four phases:
+ * goal and movement work one bot at a time, the enemy candidate scans on the
+ * aithreads worker pool, one pass on this thread that resolves the deferred
+ * line-of-sight traces, then applying the enemies and submitting the input.
+ * Returns the first error any client hit; the other clients still think.
+ */
+static int BotAIFrame(int *clients, int count, float thinktime)
+{
+    if (g_botImport == NULL)
+    {
+        return BLERR_LIBRARYNOTSETUP;
+    }
+
+    if (!BotLibraryInitialized())
+    {
+        BotInterface_Printf(PRT_ERROR, "[bot_interface] BotAIFrame: library not initialised\n");
+        return BLERR_LIBRARYNOTSETUP;
+    }
+
+    if (count <= 0)
+    {
+        return BLERR_NOERROR;
+    }
+
+    if (clients == NULL || count > MAX_CLIENTS)
+    {
+        BotInterface_Printf(PRT_ERROR, "[bot_interface] BotAIFrame: invalid client list (%d)\n", count);
+        return BLERR_INVALIDCLIENTNUMBER;
+    }
+
+    if (count > g_botAIFrameWorkCapacity)
+    {
+        botai_think_t *work = (botai_think_t *)realloc(g_botAIFrameWork, (size_t)count * sizeof(*work));
+        if (work == NULL)
+        {
+            BotInterface_Printf(PRT_ERROR, "[bot_interface] BotAIFrame: out of memory\n");
+            return BLERR_INVALIDIMPORT;
+        }
+        g_botAIFrameWork = work;
+        g_botAIFrameWorkCapacity = count;
+    }
+
+    botai_think_t *work = g_botAIFrameWork;
+    bool queued[MAX_CLIENTS] = {false};
+    for (int index = 0; index < count; ++index)
+    {
+        botai_think_t *think = &work[index];
+        int client = clients[index];
+        bot_client_state_t *state = BotState_Get(client);
+
+        BotAI_ClearEnemyScan(&think->enemy_scan);
+        think->state = state;
+        if (state == NULL || !state->active)
+        {
+            BotInterface_Printf(PRT_WARNING, "[bot_interface] BotAIFrame: client %d inactive\n", client);
+            think->status = BLERR_AICLIENTNOTSETUP;
+            continue;
+        }
+
+        if (queued[client])
+        {
+            BotInterface_Printf(PRT_WARNING, "[bot_interface] BotAIFrame: client %d listed twice\n", client);
+            think->status = BLERR_INVALIDCLIENTNUMBER;
+            continue;
+        }
+        queued[client] = true;
+
+        think->status = BotAI_ThinkBegin(state, thinktime, think);
+    }
+
+    BotWorkers_SetThreadCount(BotAI_FrameThreads());
+    BotWorkers_Run(count, BotAI_GatherEnemyCandidatesJob, work);
+
+    for (int index = 0; index < count; ++index)
+    {
+        if (work[index].status == BLERR_NOERROR)
+        {
+            BotAI_ResolveEnemyCandidates(work[index].state, &work[index].enemy_scan);
+        }
+    }
+
+    int result = BLERR_NOERROR;
+    for (int index = 0; index < count; ++index)
+    {
+        botai_think_t *think = &work[index];
+        if (think->status == BLERR_NOERROR)
+        {
+            think->status = BotAI_ThinkFinish(think);
+        }
+
+        if (result == BLERR_NOERROR)
+        {
+            result = think->status;
+        }
+    }
+
+    return result;
+}
+
 static int BotConsoleMessage(int client, int type, char *message)
 {
     if (g_botImport == NULL)
@@ -2658,7 +3142,7 @@ static int BotInterface_Test(int parm0, char *parm1, vec3_t parm2, vec3_t parm3)
             return BLERR_AIUPDATEINACTIVECLIENT;
         }
 
-        if (mover_ent < 0 || mover_ent >= BOT_INTERFACE_MAX_ENTITIES)
+        if (mover_ent < 0 || mover_ent >= Bridge_EntityLimit())
         {
             BotInterface_Printf(PRT_ERROR,
                                  "[bot_interface] Test teleport_mover: mover %d out of range\n",
@@ -2666,7 +3150,8 @@ static int BotInterface_Test(int parm0, char *parm1, vec3_t parm2, vec3_t parm3)
             return BLERR_INVALIDENTITYNUMBER;
         }
 
-        if (!g_botInterfaceEntityCache[mover_ent].valid)
+        const bot_updateentity_t *snapshot = BotInterface_EntityState(mover_ent);
+        if (snapshot == NULL)
         {
             BotInterface_Printf(PRT_WARNING,
                                  "[bot_interface] Test teleport_mover: mover entity %d has no snapshot\n",
@@ -2674,7 +3159,6 @@ static int BotInterface_Test(int parm0, char *parm1, vec3_t parm2, vec3_t parm3)
             return BLERR_INVALIDENTITYNUMBER;
         }
 
-        const bot_updateentity_t *snapshot = &g_botInterfaceEntityCache[mover_ent].state;
         const bot_mover_catalogue_entry_t *entry = BotMove_MoverCatalogueFindByModel(snapshot->modelindex);
         if (entry == NULL)
         {
@@ -3426,6 +3910,9 @@ GLADIATOR_API bot_export_t *GetBotAPI(bot_import_t *import)
     exportTable.BotEnterChat = BotInterface_BotEnterChat;
     exportTable.BotReplyChat = BotInterface_BotReplyChat;
     exportTable.BotChatLength = BotInterface_BotChatLength;
+    exportTable.BotAIFrame = BotAIFrame;
+    exportTable.BotUpdateClients = BotUpdateClients;
+    exportTable.BotUpdateEntities = BotUpdateEntities;
 
     return &exportTable;
 }
@@ -105,6 +105,7 @@ static void BotState_FreeResources(bot_client_state_t *state)
     state->team = -1;
     memset(&state->last_client_update, 0, sizeof(state->last_client_update));
     state->client_update_valid = false;
+    state->eye_cluster = -1;
     state->last_update_time = 0.0f;
     state->active = false;
     memset(&state->client_settings, 0, sizeof(state->client_settings));
@@ -73,6 +73,7 @@ struct bot_client_state_s {
     int goal_snapshot_count;
     bot_updateclient_t last_client_update;
     bool client_update_valid;
+    int eye_cluster; /* PVS cluster of the last eye position, -1 when unknown */
     float last_update_time;
     bot_moveresult_t last_move_result;
     bool has_move_result;
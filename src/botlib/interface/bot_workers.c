@@ -0,0 +1,194 @@
+#include "bot_workers.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include "botlib/common/l_log.h"
+
+typedef struct bot_workers_s
+{
+    bot_worker_job_fn job;
+    void *context;
+    int count;
+    int next;
+    int finished;
+    unsigned int generation; /* bumped for every batch so sleeping workers can tell a new one arrived */
+    bool stop;
+    int numThreads;
+#ifndef _WIN32
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    pthread_t threads[BOT_WORKERS_MAX_THREADS];
+#endif
+} bot_workers_t;
+
+static bot_workers_t g_botWorkers = {
+#ifndef _WIN32
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+#endif
+    .job = NULL,
+};
+
+#ifndef _WIN32
+/* Lock held.  Takes jobs until the batch is drained, dropping the lock around each one. */
+static void BotWorkers_Drain(bot_workers_t *pool)
+{
+    while (pool->next < pool->count)
+    {
+        int index = pool->next++;
+        bot_worker_job_fn job = pool->job;
+        void *context = pool->context;
+
+        pthread_mutex_unlock(&pool->lock);
+        job(context, index);
+        pthread_mutex_lock(&pool->lock);
+
+        pool->finished += 1;
+        if (pool->finished == pool->count)
+        {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+}
+
+static void *BotWorkers_Thread(void *arg)
+{
+    bot_workers_t *pool = (bot_workers_t *)arg;
+
+    pthread_mutex_lock(&pool->lock);
+    unsigned int seen = pool->generation;
+    for (;;)
+    {
+        while (!pool->stop && pool->generation == seen)
+        {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        if (pool->stop)
+        {
+            break;
+        }
+
+        seen = pool->generation;
+        BotWorkers_Drain(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+static void BotWorkers_StopThreads(bot_workers_t *pool)
+{
+    if (pool->numThreads == 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int index = 0; index < pool->numThreads; ++index)
+    {
+        pthread_join(pool->threads[index], NULL);
+    }
+    pool->numThreads = 0;
+    pool->stop = false;
+}
+#endif
+
+void BotWorkers_SetThreadCount(int count)
+{
+#ifndef _WIN32
+    bot_workers_t *pool = &g_botWorkers;
+    if (count < 0)
+    {
+        count = 0;
+    }
+    if (count > BOT_WORKERS_MAX_THREADS)
+    {
+        count = BOT_WORKERS_MAX_THREADS;
+    }
+
+    if (count == pool->numThreads)
+    {
+        return;
+    }
+
+    BotWorkers_StopThreads(pool);
+
+    for (int index = 0; index < count; ++index)
+    {
+        if (pthread_create(&pool->threads[pool->numThreads], NULL, BotWorkers_Thread, pool) != 0)
+        {
+            BotLib_Print(PRT_WARNING,
+                         "BotWorkers: started %d of %d worker threads\n",
+                         pool->numThreads,
+                         count);
+            break;
+        }
+        pool->numThreads += 1;
+    }
+#else
+    (void)count;
+#endif
+}
+
+int BotWorkers_ThreadCount(void)
+{
+    return g_botWorkers.numThreads;
+}
+
+void BotWorkers_Run(int count, bot_worker_job_fn job, void *context)
+{
+    if (count <= 0 || job == NULL)
+    {
+        return;
+    }
+
+    bot_workers_t *pool = &g_botWorkers;
+    if (pool->numThreads == 0 || count == 1)
+    {
+        for (int index = 0; index < count; ++index)
+        {
+            job(context, index);
+        }
+        return;
+    }
+
+#ifndef _WIN32
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->context = context;
+    pool->count = count;
+    pool->next = 0;
+    pool->finished = 0;
+    pool->generation += 1U;
+    pthread_cond_broadcast(&pool->wake);
+
+    BotWorkers_Drain(pool);
+    while (pool->finished < pool->count)
+    {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+
+    pool->job = NULL;
+    pool->context = NULL;
+    pool->count = 0;
+    pool->next = 0;
+    pthread_mutex_unlock(&pool->lock);
+#endif
+}
+
+void BotWorkers_Shutdown(void)
+{
+    BotWorkers_SetThreadCount(0);
+}
@@ -0,0 +1,32 @@
+#ifndef BOTLIB_INTERFACE_BOT_WORKERS_H
+#define BOTLIB_INTERFACE_BOT_WORKERS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Small persistent thread pool used by BotAIFrame to spread per-bot work.
+ * BotWorkers_Run calls job(context, index) once for every index in
+ * [0, count) and returns when all of them have finished; the calling thread
+ * takes jobs as well.  With no worker threads the jobs simply run inline, in
+ * index order.  Only the main thread may call into this module.
+ */
+
+#define BOT_WORKERS_MAX_THREADS 16
+
+typedef void (*bot_worker_job_fn)(void *context, int index);
+
+/* Starts or stops threads so that count workers are running (0 = inline). */
+void BotWorkers_SetThreadCount(int count);
+int BotWorkers_ThreadCount(void);
+
+void BotWorkers_Run(int count, bot_worker_job_fn job, void *context);
+
+void BotWorkers_Shutdown(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* BOTLIB_INTERFACE_BOT_WORKERS_H */
@@ -92,6 +92,12 @@ static void Botlib_CacheLibraryVariables(void)
     g_library_variables.forcereachability = Botlib_ReadIntLibVarCached(Bridge_ForceReachability(), 0);
     g_library_variables.forcewrite = Botlib_ReadIntLibVarCached(Bridge_ForceWrite(), 0);
     g_library_variables.framereachability = Botlib_ReadIntLibVarCached(Bridge_FrameReachability(), 0);
+    g_library_variables.max_routingcache = Botlib_ReadIntLibVarCached(Bridge_MaxRoutingCache(), 4096);
+    g_library_variables.routeprecompute = Botlib_ReadIntLibVarCached(Bridge_RoutePrecompute(), 0);
+    g_library_variables.routecompact = Botlib_ReadIntLibVarCached(Bridge_RouteCompact(), 0);
+    g_library_variables.routematrix = Botlib_ReadIntLibVarCached(Bridge_RouteMatrix(), 0);
+    g_library_variables.areaorder = Botlib_ReadIntLibVarCached(Bridge_AreaOrder(), 0);
+    g_library_variables.aithreads = Botlib_ReadIntLibVarCached(Bridge_AIThreads(), 0);
 
     const libvar_t *weaponconfig = Bridge_WeaponConfig();
     const char *weaponconfig_string = (weaponconfig != NULL && weaponconfig->string != NULL && weaponconfig->string[0] != '\0')
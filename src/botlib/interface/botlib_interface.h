@@ -71,6 +71,12 @@ typedef struct botlib_library_variables_s {
     int forcereachability;
     int forcewrite;
     int framereachability;
+    int max_routingcache; /* routing cache budget in kilobytes, 0 = unbounded */
+    int routeprecompute;  /* route cache worker threads at map start, 0 = off */
+    int routecompact;     /* store world and cluster caches block-packed */
+    int routematrix;      /* largest area count that gets an all-pairs matrix, 0 = off */
+    int areaorder;        /* 1 renumbers areas along a space-filling curve at load, 0 = file order */
+    int aithreads;        /* BotAIFrame worker threads, 0 = every phase on the calling thread */
 } botlib_library_variables_t;
 
 /**
@@ -3,6 +3,13 @@
 
 #include "l_precomp.h"
 
+// Lexer features the original botlib compiled in.  The config loaders read
+// token intvalue/floatvalue directly, and weapons.c combines flags through
+// $evalint(...), so both the value cache and '$' punctuation are required.
+#define BINARYNUMBERS
+#define NUMBERVALUE
+#define DOLLAR
+
 // -----------------------------------------------------------------------------
 //  Lexer Token Model
 // -----------------------------------------------------------------------------
@@ -154,21 +154,8 @@ static void CopyScalarFrameFields(const bot_updateentity_t *src, AASEntityFrame
     dst->event_id = src->event;
 }
 
-bot_status_t TranslateEntityUpdate(int ent_num,
-                                   const bot_updateentity_t *src,
-                                   AASEntityFrame *dst)
+static void StampEntityFrameTime(AASEntityFrame *dst)
 {
-    if (src == NULL || dst == NULL)
-    {
-        return BLERR_INVALIDIMPORT;
-    }
-
-    if (!g_aas_loaded)
-    {
-        BotlibLog(PRT_MESSAGE, "AAS_UpdateEntity: not loaded\n");
-        return BLERR_NOAASFILE;
-    }
-
     float previous_time = dst->last_update_time;
     dst->last_update_time = g_aas_current_time;
     if (previous_time <= 0.0f)
@@ -183,6 +170,24 @@ bot_status_t TranslateEntityUpdate(int ent_num,
             dst->frame_delta = 0.0f;
         }
     }
+}
+
+bot_status_t TranslateEntityUpdate(int ent_num,
+                                   const bot_updateentity_t *src,
+                                   AASEntityFrame *dst)
+{
+    if (src == NULL || dst == NULL)
+    {
+        return BLERR_INVALIDIMPORT;
+    }
+
+    if (!g_aas_loaded)
+    {
+        BotlibLog(PRT_MESSAGE, "AAS_UpdateEntity: not loaded\n");
+        return BLERR_NOAASFILE;
+    }
+
+    StampEntityFrameTime(dst);
 
     dst->number = ent_num;
 
@@ -240,6 +245,29 @@ bot_status_t TranslateEntityUpdate(int ent_num,
     return BLERR_NOERROR;
 }
 
+bot_status_t TranslateEntityUnchanged(int ent_num, AASEntityFrame *dst)
+{
+    if (dst == NULL)
+    {
+        return BLERR_INVALIDIMPORT;
+    }
+
+    if (!g_aas_loaded)
+    {
+        BotlibLog(PRT_MESSAGE, "AAS_UpdateEntity: not loaded\n");
+        return BLERR_NOAASFILE;
+    }
+
+    StampEntityFrameTime(dst);
+
+    dst->number = ent_num;
+    dst->angles_dirty = false;
+    dst->bounds_dirty = false;
+    dst->origin_dirty = false;
+
+    return BLERR_NOERROR;
+}
+
 void BotlibLog(int level, const char *fmt, ...)
 {
     va_list args;
@@ -169,6 +169,17 @@ bot_status_t TranslateEntityUpdate(int ent_num,
                                    const bot_updateentity_t *src,
                                    AASEntityFrame *dst);
 
+/**
+ * \brief Refresh an AASEntityFrame whose BotUpdateEntity payload matches the
+ * one it was last translated from.
+ *
+ * Produces the same frame TranslateEntityUpdate would for the repeated
+ * payload: the timestamps advance and every *_dirty flag clears, so callers
+ * skip the spatial relink. Fails like TranslateEntityUpdate when the AAS
+ * world is not loaded.
+ */
+bot_status_t TranslateEntityUnchanged(int ent_num, AASEntityFrame *dst);
+
 /**
  * \brief Emit botlib-style diagnostics.
  *
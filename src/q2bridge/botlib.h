@@ -290,6 +290,9 @@ typedef struct bot_export_s {
     void (*BotEnterChat)(bot_chatstate_t *state, int client, int sendto);
     int (*BotReplyChat)(bot_chatstate_t *state, const char *message, unsigned long context);
     int (*BotChatLength)(const char *message);
+    int (*BotAIFrame)(int *clients, int count, float thinktime);
+    int (*BotUpdateClients)(int *clients, bot_updateclient_t *bucs, int count);
+    int (*BotUpdateEntities)(int *ents, bot_updateentity_t *bues, int count);
 } bot_export_t;
 
 // Bot library imported functions
@@ -40,6 +40,12 @@ typedef struct bridge_config_cache_s {
     libvar_t *forcereachability;
     libvar_t *forcewrite;
     libvar_t *framereachability;
+    libvar_t *max_routingcache;
+    libvar_t *routeprecompute;
+    libvar_t *routecompact;
+    libvar_t *routematrix;
+    libvar_t *areaorder;
+    libvar_t *aithreads;
 } bridge_config_cache_t;
 
 static bridge_config_cache_t g_bridge_config_cache;
@@ -127,6 +133,12 @@ bool BridgeConfig_Init(void)
     BridgeConfig_CacheLibVar(&g_bridge_config_cache.forcereachability, "forcereachability", "0");
     BridgeConfig_CacheLibVar(&g_bridge_config_cache.forcewrite, "forcewrite", "0");
     BridgeConfig_CacheLibVar(&g_bridge_config_cache.framereachability, "framereachability", "0");
+    BridgeConfig_CacheLibVar(&g_bridge_config_cache.max_routingcache, "max_routingcache", "4096");
+    BridgeConfig_CacheLibVar(&g_bridge_config_cache.routeprecompute, "routeprecompute", "0");
+    BridgeConfig_CacheLibVar(&g_bridge_config_cache.routecompact, "routecompact", "0");
+    BridgeConfig_CacheLibVar(&g_bridge_config_cache.routematrix, "routematrix", "0");
+    BridgeConfig_CacheLibVar(&g_bridge_config_cache.areaorder, "areaorder", "0");
+    BridgeConfig_CacheLibVar(&g_bridge_config_cache.aithreads, "aithreads", "0");
 
     g_bridge_config_initialised = true;
     return true;
@@ -309,3 +321,33 @@ libvar_t *Bridge_FrameReachability(void)
 {
     return g_bridge_config_cache.framereachability;
 }
+
+libvar_t *Bridge_MaxRoutingCache(void)
+{
+    return g_bridge_config_cache.max_routingcache;
+}
+
+libvar_t *Bridge_RoutePrecompute(void)
+{
+    return g_bridge_config_cache.routeprecompute;
+}
+
+libvar_t *Bridge_RouteCompact(void)
+{
+    return g_bridge_config_cache.routecompact;
+}
+
+libvar_t *Bridge_RouteMatrix(void)
+{
+    return g_bridge_config_cache.routematrix;
+}
+
+libvar_t *Bridge_AreaOrder(void)
+{
+    return g_bridge_config_cache.areaorder;
+}
+
+libvar_t *Bridge_AIThreads(void)
+{
+    return g_bridge_config_cache.aithreads;
+}
@@ -45,6 +45,12 @@ libvar_t *Bridge_ForceClustering(void);
 libvar_t *Bridge_ForceReachability(void);
 libvar_t *Bridge_ForceWrite(void);
 libvar_t *Bridge_FrameReachability(void);
+libvar_t *Bridge_MaxRoutingCache(void);
+libvar_t *Bridge_RoutePrecompute(void);
+libvar_t *Bridge_RouteCompact(void);
+libvar_t *Bridge_RouteMatrix(void);
+libvar_t *Bridge_AreaOrder(void);
+libvar_t *Bridge_AIThreads(void);
 
 #ifdef __cplusplus
 }
@@ -26,17 +26,24 @@ typedef struct bridge_client_slot_s
     AASClientFrame frame;
 } bridge_client_slot_t;
 
-typedef struct bridge_entity_slot_s
+#define BRIDGE_ENTITY_SEEN 0x01
+#define BRIDGE_ENTITY_LOGGED 0x02
+#define BRIDGE_ENTITY_FRAME_VALID 0x04
+#define BRIDGE_ENTITY_CHANGED 0x08 /* the latest update differed from the one before it */
+
+/*
+ * Entity cache kept as parallel columns indexed by entity number, so the
+ * batched update and the frame lookups only walk the arrays they touch.
+ */
+typedef struct bridge_entity_store_s
 {
-    qboolean seen;
-    qboolean logged;
-    bot_updateentity_t snapshot;
-    qboolean frame_valid;
-    AASEntityFrame frame;
-} bridge_entity_slot_t;
+    bot_updateentity_t *snapshots;
+    AASEntityFrame *frames;
+    unsigned char *flags; /* BRIDGE_ENTITY_* */
+} bridge_entity_store_t;
 
 static bridge_client_slot_t g_bridge_clients[MAX_CLIENTS];
-static bridge_entity_slot_t *g_bridge_entities = NULL;
+static bridge_entity_store_t g_bridge_entities = {NULL, NULL, NULL};
 static int g_bridge_entity_capacity = 0;
 static int g_bridge_max_client_index = MAX_CLIENTS - 1;
 static int g_bridge_max_entity_index = -1;
@@ -120,6 +127,36 @@ static int Bridge_ReadConfiguredMaxEntities(void)
     return configured;
 }
 
+int Bridge_EntityLimit(void)
+{
+    return Bridge_ReadConfiguredMaxEntities();
+}
+
+/* Grows one column, zeroing the new tail.  Returns NULL and leaves the column alone on failure. */
+static void *Bridge_GrowEntityColumn(void *column, size_t element_size, int old_capacity, int new_capacity)
+{
+    unsigned char *resized = (unsigned char *)realloc(column, (size_t)new_capacity * element_size);
+    if (resized == NULL)
+    {
+        return NULL;
+    }
+
+    memset(resized + (size_t)old_capacity * element_size,
+           0,
+           (size_t)(new_capacity - old_capacity) * element_size);
+    return resized;
+}
+
+static void Bridge_FreeEntityStore(bridge_entity_store_t *store)
+{
+    free(store->snapshots);
+    free(store->frames);
+    free(store->flags);
+    store->snapshots = NULL;
+    store->frames = NULL;
+    store->flags = NULL;
+}
+
 static qboolean Bridge_GrowEntityTable(int new_capacity)
 {
     if (new_capacity <= g_bridge_entity_capacity)
@@ -127,10 +164,27 @@ static qboolean Bridge_GrowEntityTable(int new_capacity)
         return qtrue;
     }
 
-    size_t new_size = (size_t)new_capacity * sizeof(*g_bridge_entities);
-    bridge_entity_slot_t *resized =
-        (bridge_entity_slot_t *)realloc(g_bridge_entities, new_size);
-    if (resized == NULL)
+    bridge_entity_store_t *store = &g_bridge_entities;
+    int old_capacity = g_bridge_entity_capacity;
+
+    void *snapshots = Bridge_GrowEntityColumn(store->snapshots, sizeof(*store->snapshots), old_capacity, new_capacity);
+    if (snapshots != NULL)
+    {
+        store->snapshots = (bot_updateentity_t *)snapshots;
+    }
+
+    void *frames = (snapshots != NULL)
+                       ? Bridge_GrowEntityColumn(store->frames, sizeof(*store->frames), old_capacity, new_capacity)
+                       : NULL;
+    if (frames != NULL)
+    {
+        store->frames = (AASEntityFrame *)frames;
+    }
+
+    void *flags = (frames != NULL)
+                      ? Bridge_GrowEntityColumn(store->flags, sizeof(*store->flags), old_capacity, new_capacity)
+                      : NULL;
+    if (flags == NULL)
     {
         Bridge_LogMessage(PRT_ERROR,
                           "[q2bridge] failed to grow entity cache to %d slots\n",
@@ -138,13 +192,7 @@ static qboolean Bridge_GrowEntityTable(int new_capacity)
         return qfalse;
     }
 
-    size_t old_size = (size_t)g_bridge_entity_capacity * sizeof(*resized);
-    if (new_size > old_size)
-    {
-        memset((unsigned char *)resized + old_size, 0, new_size - old_size);
-    }
-
-    g_bridge_entities = resized;
+    store->flags = (unsigned char *)flags;
     g_bridge_entity_capacity = new_capacity;
     return qtrue;
 }
@@ -152,15 +200,19 @@ static qboolean Bridge_GrowEntityTable(int new_capacity)
 static void Bridge_ResetEntityTable(void)
 {
     int configured = Bridge_ReadConfiguredMaxEntities();
+    bridge_entity_store_t *store = &g_bridge_entities;
 
     if (configured != g_bridge_entity_capacity)
     {
-        bridge_entity_slot_t *fresh = NULL;
         if (configured > 0)
         {
-            fresh = (bridge_entity_slot_t *)calloc((size_t)configured, sizeof(*fresh));
-            if (fresh == NULL)
+            bridge_entity_store_t fresh;
+            fresh.snapshots = (bot_updateentity_t *)calloc((size_t)configured, sizeof(*fresh.snapshots));
+            fresh.frames = (AASEntityFrame *)calloc((size_t)configured, sizeof(*fresh.frames));
+            fresh.flags = (unsigned char *)calloc((size_t)configured, sizeof(*fresh.flags));
+            if (fresh.snapshots == NULL || fresh.frames == NULL || fresh.flags == NULL)
             {
+                Bridge_FreeEntityStore(&fresh);
                 Bridge_LogMessage(PRT_ERROR,
                                   "[q2bridge] failed to allocate entity cache for %d slots\n",
                                   configured);
@@ -168,21 +220,23 @@ static void Bridge_ResetEntityTable(void)
             }
             else
             {
-                free(g_bridge_entities);
-                g_bridge_entities = fresh;
+                Bridge_FreeEntityStore(store);
+                *store = fresh;
                 g_bridge_entity_capacity = configured;
             }
         }
         else
         {
-            free(g_bridge_entities);
-            g_bridge_entities = NULL;
+            Bridge_FreeEntityStore(store);
             g_bridge_entity_capacity = 0;
         }
     }
-    else if (g_bridge_entities != NULL)
+    else if (store->flags != NULL)
     {
-        memset(g_bridge_entities, 0, (size_t)g_bridge_entity_capacity * sizeof(*g_bridge_entities));
+        size_t count = (size_t)g_bridge_entity_capacity;
+        memset(store->snapshots, 0, count * sizeof(*store->snapshots));
+        memset(store->frames, 0, count * sizeof(*store->frames));
+        memset(store->flags, 0, count * sizeof(*store->flags));
     }
 
     if (configured > g_bridge_entity_capacity)
@@ -313,6 +367,53 @@ static void Bridge_LogFirstCapture(qboolean *logged, const char *fmt, ...)
     *logged = qtrue;
 }
 
+/*
+ * Caller has validated ent against the entity limit and the store.  Most
+ * entities resend the same record every frame, so a payload identical to the
+ * stored snapshot only refreshes the frame's timestamps.
+ */
+static int Bridge_StoreEntityUpdate(int ent, const bot_updateentity_t *update)
+{
+    bridge_entity_store_t *store = &g_bridge_entities;
+    bot_status_t status;
+
+    if ((store->flags[ent] & BRIDGE_ENTITY_FRAME_VALID) != 0
+        && memcmp(&store->snapshots[ent], update, sizeof(*update)) == 0)
+    {
+        store->flags[ent] &= (unsigned char)~(BRIDGE_ENTITY_FRAME_VALID | BRIDGE_ENTITY_CHANGED);
+        status = TranslateEntityUnchanged(ent, &store->frames[ent]);
+        if (status != BLERR_NOERROR)
+        {
+            return status;
+        }
+
+        store->flags[ent] |= BRIDGE_ENTITY_FRAME_VALID;
+        return BLERR_NOERROR;
+    }
+
+    memcpy(&store->snapshots[ent], update, sizeof(*update));
+
+    store->flags[ent] &= (unsigned char)~BRIDGE_ENTITY_FRAME_VALID;
+    status = TranslateEntityUpdate(ent, update, &store->frames[ent]);
+    if (status != BLERR_NOERROR)
+    {
+        return status;
+    }
+
+    store->flags[ent] |= BRIDGE_ENTITY_FRAME_VALID | BRIDGE_ENTITY_SEEN | BRIDGE_ENTITY_CHANGED;
+
+    if ((store->flags[ent] & BRIDGE_ENTITY_LOGGED) == 0)
+    {
+        qboolean logged = qfalse;
+        Bridge_LogFirstCapture(&logged,
+                               "[q2bridge] captured BotUpdateEntity frame for ent %d\n",
+                               ent);
+        store->flags[ent] |= BRIDGE_ENTITY_LOGGED;
+    }
+
+    return BLERR_NOERROR;
+}
+
 int Bridge_UpdateClient(int client, const bot_updateclient_t *update)
 {
     if (!Bridge_CheckLibraryReady("BotUpdateClient"))
@@ -374,7 +475,7 @@ int Bridge_UpdateEntity(int ent, const bot_updateentity_t *update)
         return BLERR_INVALIDENTITYNUMBER;
     }
 
-    if (g_bridge_entities == NULL)
+    if (g_bridge_entities.flags == NULL)
     {
         Bridge_LogMessage(PRT_ERROR,
                           "BotUpdateEntity: entity cache unavailable for index %d\n",
@@ -382,24 +483,58 @@ int Bridge_UpdateEntity(int ent, const bot_updateentity_t *update)
         return BLERR_INVALIDENTITYNUMBER;
     }
 
-    bridge_entity_slot_t *slot = &g_bridge_entities[ent];
-    memcpy(&slot->snapshot, update, sizeof(*update));
+    return Bridge_StoreEntityUpdate(ent, update);
+}
 
-    slot->frame_valid = qfalse;
-    bot_status_t status = TranslateEntityUpdate(ent, update, &slot->frame);
-    if (status != BLERR_NOERROR)
+int Bridge_UpdateEntities(const int *ents, const bot_updateentity_t *updates, int count)
+{
+    if (!Bridge_CheckLibraryReady("BotUpdateEntities"))
     {
-        return status;
+        return BLERR_LIBRARYNOTSETUP;
     }
 
-    slot->frame_valid = qtrue;
-    slot->seen = qtrue;
+    if (count <= 0)
+    {
+        return BLERR_NOERROR;
+    }
 
-    Bridge_LogFirstCapture(&slot->logged,
-                           "[q2bridge] captured BotUpdateEntity frame for ent %d\n",
-                           ent);
+    if (ents == NULL || updates == NULL)
+    {
+        Bridge_LogMessage(PRT_ERROR, "BotUpdateEntities: NULL update payload provided\n");
+        return BLERR_INVALIDENTITYNUMBER;
+    }
 
-    return BLERR_NOERROR;
+    Bridge_SynchroniseEntityLimit();
+    if (g_bridge_entities.flags == NULL)
+    {
+        Bridge_LogMessage(PRT_ERROR, "BotUpdateEntities: entity cache unavailable\n");
+        return BLERR_INVALIDENTITYNUMBER;
+    }
+
+    int result = BLERR_NOERROR;
+    for (int index = 0; index < count; ++index)
+    {
+        int ent = ents[index];
+        int status = BLERR_INVALIDENTITYNUMBER;
+        if (ent < 0 || ent > g_bridge_max_entity_index)
+        {
+            Bridge_LogMessage(PRT_ERROR,
+                              "BotUpdateEntities: invalid entity number %d, [0, %d]\n",
+                              ent,
+                              g_bridge_max_entity_index);
+        }
+        else
+        {
+            status = Bridge_StoreEntityUpdate(ent, &updates[index]);
+        }
+
+        if (result == BLERR_NOERROR)
+        {
+            result = status;
+        }
+    }
+
+    return result;
 }
 
 void Bridge_ResetCachedUpdates(void)
@@ -421,6 +556,16 @@ void Bridge_ClearClientSlot(int client)
     memset(&g_bridge_clients[client], 0, sizeof(g_bridge_clients[client]));
 }
 
+void Bridge_ClearEntitySlot(int ent)
+{
+    if (ent < 0 || ent > g_bridge_max_entity_index || g_bridge_entities.flags == NULL)
+    {
+        return;
+    }
+
+    g_bridge_entities.flags[ent] &= (unsigned char)~(BRIDGE_ENTITY_FRAME_VALID | BRIDGE_ENTITY_CHANGED);
+}
+
 int Bridge_MoveClientSlot(int old_client, int new_client)
 {
     if (!Bridge_CheckLibraryReady("BotMoveClient"))
@@ -501,17 +646,48 @@ qboolean Bridge_ReadEntityFrame(int ent, AASEntityFrame *frame_out)
         return qfalse;
     }
 
-    if (g_bridge_entities == NULL)
+    const AASEntityFrame *frame = Bridge_EntityFrame(ent);
+    if (frame == NULL || frame_out == NULL)
     {
         return qfalse;
     }
 
-    bridge_entity_slot_t *slot = &g_bridge_entities[ent];
-    if (!slot->frame_valid || frame_out == NULL)
+    *frame_out = *frame;
+    return qtrue;
+}
+
+const AASClientFrame *Bridge_ClientFrame(int client)
+{
+    if (client < 0 || client > g_bridge_max_client_index)
+    {
+        return NULL;
+    }
+
+    const bridge_client_slot_t *slot = &g_bridge_clients[client];
+    return slot->frame_valid ? &slot->frame : NULL;
+}
+
+const AASEntityFrame *Bridge_EntityFrame(int ent)
+{
+    if (ent < 0 || ent > g_bridge_max_entity_index || g_bridge_entities.flags == NULL)
+    {
+        return NULL;
+    }
+
+    if ((g_bridge_entities.flags[ent] & BRIDGE_ENTITY_FRAME_VALID) == 0)
+    {
+        return NULL;
+    }
+
+    return &g_bridge_entities.frames[ent];
+}
+
+qboolean Bridge_EntityChanged(int ent)
+{
+    if (Bridge_EntityFrame(ent) == NULL)
     {
         return qfalse;
     }
 
-    *frame_out = slot->frame;
-    return qtrue;
+    return (g_bridge_entities.flags[ent] & BRIDGE_ENTITY_CHANGED) != 0 ? qtrue : qfalse;
 }
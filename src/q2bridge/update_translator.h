@@ -35,6 +35,26 @@ int Bridge_UpdateClient(int client, const bot_updateclient_t *update);
  */
 int Bridge_UpdateEntity(int ent, const bot_updateentity_t *update);
 
+/**
+ * @brief Cache a batch of BotUpdateEntity payloads.
+ *
+ * The library and the entity limit are checked once for the whole batch,
+ * then every update is stored and translated in order. An entry that fails
+ * is logged and skipped without stopping the batch.
+ *
+ * @return BLERR_NOERROR when every entry was stored, otherwise the first
+ *         failure.
+ */
+int Bridge_UpdateEntities(const int *ents, const bot_updateentity_t *updates, int count);
+
+/**
+ * @brief Number of entity slots the bridge accepts: maxentities, defaulting
+ *        to 1024 and capped at 2048.
+ *
+ * Lets the AAS and interface entity tables be sized once at map load.
+ */
+int Bridge_EntityLimit(void);
+
 /**
  * @brief Reset the cached bridge state.
  */
@@ -50,6 +70,12 @@ void Bridge_HandleMapStateChange(void);
  */
 void Bridge_ClearClientSlot(int client);
 
+/**
+ * @brief Drop the translated frame for an entity slot so its next update is
+ *        translated in full.
+ */
+void Bridge_ClearEntitySlot(int ent);
+
 /**
  * @brief Reassign cached client state when a bot moves to a new slot.
  */
@@ -75,6 +101,32 @@ qboolean Bridge_ReadClientFrame(int client, AASClientFrame *frame_out);
  */
 qboolean Bridge_ReadEntityFrame(int ent, AASEntityFrame *frame_out);
 
+/**
+ * @brief Borrow the translated client frame without copying it.
+ *
+ * @return NULL when the slot holds no valid frame. The pointer is valid
+ *         until the slot is next updated or cleared.
+ */
+const AASClientFrame *Bridge_ClientFrame(int client);
+
+/**
+ * @brief Borrow the translated entity frame without copying it.
+ *
+ * @return NULL when the slot holds no valid frame. The pointer is valid
+ *         until the slot is next updated or the cache is reset.
+ */
+const AASEntityFrame *Bridge_EntityFrame(int ent);
+
+/**
+ * @brief Report whether the latest update for an entity changed its record.
+ *
+ * An update identical to the previous one only refreshes the frame times and
+ * clears the dirty flags, so callers can skip any work keyed on the payload.
+ *
+ * @return qfalse for unchanged entities and for slots without a valid frame.
+ */
+qboolean Bridge_EntityChanged(int ent);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,8 @@
 #define chdir _chdir
 #define getcwd _getcwd
 #define unlink _unlink
+#else
+#include <unistd.h>
 #endif
 
 #ifndef PATH_MAX
@@ -210,6 +212,29 @@ static int aas_environment_setup(void **state)
     return 0;
 }
 
+static int aas_synthetic_setup(void **state)
+{
+    aas_test_environment_t *env = (aas_test_environment_t *)calloc(1, sizeof(aas_test_environment_t));
+    if (env == NULL) {
+        return -1;
+    }
+
+    BotInterface_SetImportTable(&g_test_imports);
+    env->import_table_set = true;
+
+    LibVar_Init();
+    env->libvar_initialised = true;
+
+    if (!BridgeConfig_Init()) {
+        free(env);
+        return -1;
+    }
+    env->bridge_config_initialised = true;
+
+    *state = env;
+    return 0;
+}
+
 static int aas_environment_teardown(void **state)
 {
     aas_test_environment_t *env = (aas_test_environment_t *)(*state);
@@ -375,8 +400,9 @@ static void test_aas_entity_linking_and_reachability(void **state)
     fixtures[2].maxs[2] = 8.0f;
 
     aasworld.time = 1.0f;
+    TranslateEntity_SetCurrentTime(aasworld.time);
     AASEntityFrame translated = {0};
-    status = TranslateEntityUpdate(1, &fixtures[0], aasworld.time, &translated);
+    status = TranslateEntityUpdate(1, &fixtures[0], &translated);
     assert_int_equal(status, BLERR_NOERROR);
     status = AAS_UpdateEntity(1, &translated);
     assert_int_equal(status, BLERR_NOERROR);
@@ -389,7 +415,8 @@ static void test_aas_entity_linking_and_reachability(void **state)
     assert_area_entity_list_contains(1, 1);
 
     aasworld.time = 2.0f;
-    status = TranslateEntityUpdate(1, &fixtures[1], aasworld.time, &translated);
+    TranslateEntity_SetCurrentTime(aasworld.time);
+    status = TranslateEntityUpdate(1, &fixtures[1], &translated);
     assert_int_equal(status, BLERR_NOERROR);
     status = AAS_UpdateEntity(1, &translated);
     assert_int_equal(status, BLERR_NOERROR);
@@ -401,7 +428,8 @@ static void test_aas_entity_linking_and_reachability(void **state)
     assert_area_entity_list_contains(2, 1);
 
     aasworld.time = 3.0f;
-    status = TranslateEntityUpdate(1, &fixtures[2], aasworld.time, &translated);
+    TranslateEntity_SetCurrentTime(aasworld.time);
+    status = TranslateEntityUpdate(1, &fixtures[2], &translated);
     assert_int_equal(status, BLERR_NOERROR);
     status = AAS_UpdateEntity(1, &translated);
     assert_int_equal(status, BLERR_NOERROR);
@@ -506,6 +534,1403 @@ static void test_reachability_force_clustering_toggle(void **state)
     LibVarSet("forceclustering", "0");
 }
 
+typedef struct synthetic_link_s {
+    int from;
+    int to;
+    unsigned short traveltime;
+} synthetic_link_t;
+
+/* Resets the world and gives it num_areas areas joined by walk links. */
+static void build_synthetic_areas(const synthetic_link_t *links, int num_links, int num_areas)
+{
+    AAS_Shutdown();
+    memset(&aasworld, 0, sizeof(aasworld));
+
+    aasworld.numAreas = num_areas;
+    aasworld.areas = (aas_area_t *)calloc((size_t)num_areas + 1U, sizeof(aas_area_t));
+    aasworld.numAreaSettings = num_areas + 1;
+    aasworld.areasettings =
+        (aas_areasettings_t *)calloc((size_t)num_areas + 1U, sizeof(aas_areasettings_t));
+    aasworld.numReachability = num_links + 1;
+    aasworld.reachability =
+        (aas_reachability_t *)calloc((size_t)num_links + 1U, sizeof(aas_reachability_t));
+    assert_non_null(aasworld.areas);
+    assert_non_null(aasworld.areasettings);
+    assert_non_null(aasworld.reachability);
+
+    int reach_index = 1;
+    for (int area = 1; area <= num_areas; ++area) {
+        aasworld.areasettings[area].firstreachablearea = reach_index;
+        for (int link = 0; link < num_links; ++link) {
+            if (links[link].from != area) {
+                continue;
+            }
+            aasworld.reachability[reach_index].areanum = links[link].to;
+            aasworld.reachability[reach_index].traveltype = TRAVEL_WALK;
+            aasworld.reachability[reach_index].traveltime = links[link].traveltime;
+            aasworld.areasettings[area].numreachableareas += 1;
+            reach_index += 1;
+        }
+    }
+}
+
+/*
+ * Builds a five area corridor: areas 1-2 form cluster 1, area 3 is the portal
+ * between the clusters and areas 4-5 form cluster 2.
+ */
+static void build_two_cluster_world(void)
+{
+    static const synthetic_link_t links[] = {
+        {1, 2, 10}, {2, 1, 5}, {2, 3, 20}, {3, 2, 5},
+        {3, 4, 30}, {4, 3, 5}, {4, 5, 40}, {5, 4, 5},
+    };
+
+    build_synthetic_areas(links, (int)(sizeof(links) / sizeof(links[0])), 5);
+
+    aasworld.numClusters = 3;
+    aasworld.clusters = (aas_cluster_t *)calloc(3U, sizeof(aas_cluster_t));
+    aasworld.numPortals = 2;
+    aasworld.portals = (aas_portal_t *)calloc(2U, sizeof(aas_portal_t));
+    aasworld.numPortalIndex = 2;
+    aasworld.portalIndex = (aas_portalindex_t *)calloc(2U, sizeof(aas_portalindex_t));
+    assert_non_null(aasworld.clusters);
+    assert_non_null(aasworld.portals);
+    assert_non_null(aasworld.portalIndex);
+
+    for (int cluster = 1; cluster <= 2; ++cluster) {
+        aasworld.clusters[cluster].numareas = 3;
+        aasworld.clusters[cluster].numreachabilityareas = 3;
+        aasworld.clusters[cluster].numportals = 1;
+        aasworld.clusters[cluster].firstportal = cluster - 1;
+        aasworld.portalIndex[cluster - 1] = 1;
+    }
+
+    aasworld.areasettings[1].cluster = 1;
+    aasworld.areasettings[1].clusterareanum = 0;
+    aasworld.areasettings[2].cluster = 1;
+    aasworld.areasettings[2].clusterareanum = 1;
+    aasworld.areasettings[3].cluster = -1;
+    aasworld.areasettings[4].cluster = 2;
+    aasworld.areasettings[4].clusterareanum = 0;
+    aasworld.areasettings[5].cluster = 2;
+    aasworld.areasettings[5].clusterareanum = 1;
+
+    aasworld.portals[1].areanum = 3;
+    aasworld.portals[1].frontcluster = 1;
+    aasworld.portals[1].backcluster = 2;
+    aasworld.portals[1].clusterareanum[0] = 2;
+    aasworld.portals[1].clusterareanum[1] = 2;
+
+    AAS_InitTravelFlagFromType();
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+    aasworld.loaded = qtrue;
+}
+
+static void test_cluster_routing_crosses_portals(void **state)
+{
+    (void)state;
+
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+    assert_true(aasworld.clusterRouting);
+    assert_int_equal(AAS_ClusterAreaNum(1, 3), 2);
+    assert_int_equal(AAS_ClusterAreaNum(2, 3), 2);
+    assert_int_equal(AAS_ClusterAreaNum(2, 1), -1);
+
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 100);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(5, NULL, 1, TFL_DEFAULT), 20);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(3, NULL, 5, TFL_DEFAULT), 70);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 3, TFL_DEFAULT), 30);
+
+    for (aas_routingcache_t *cache = aasworld.routingCacheHead; cache != NULL; cache = cache->next) {
+        assert_true(cache->type != AAS_ROUTECACHE_WORLD);
+        assert_true(cache->numTraveltimes <= 3);
+    }
+
+    AAS_Shutdown();
+}
+
+static void assert_route_to_goal(int areanum, int goalareanum, int expected_time, int expected_reach)
+{
+    int traveltime = -1;
+    int reachnum = -1;
+    assert_true(AAS_AreaRouteToGoalArea(areanum, NULL, goalareanum, TFL_DEFAULT, &traveltime, &reachnum));
+    assert_int_equal(traveltime, expected_time);
+    assert_int_equal(reachnum, expected_reach);
+}
+
+static void test_route_to_goal_reports_next_reachability(void **state)
+{
+    (void)state;
+
+    /* Reachability 1 is 1->2, 3 is 2->3, 5 is 3->4 and 8 is 5->4. */
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+    assert_true(aasworld.clusterRouting);
+    assert_route_to_goal(1, 5, 100, 1);
+    assert_route_to_goal(2, 5, 90, 3);
+    assert_route_to_goal(3, 5, 70, 5);
+    assert_route_to_goal(5, 1, 20, 8);
+    assert_route_to_goal(4, 4, 0, 0);
+
+    /* Whole-map caches must agree with the hierarchical answer. */
+    AAS_FreeAllRoutingCaches();
+    aasworld.clusterRouting = qfalse;
+    assert_route_to_goal(1, 5, 100, 1);
+    assert_route_to_goal(3, 5, 70, 5);
+    assert_route_to_goal(5, 1, 20, 8);
+
+    /* Drop 3->4 so cluster 2 becomes unreachable from cluster 1. */
+    aasworld.areasettings[3].numreachableareas = 1;
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+    AAS_FreeAllRoutingCaches();
+    int traveltime = -1;
+    int reachnum = -1;
+    assert_false(AAS_AreaRouteToGoalArea(1, NULL, 5, TFL_DEFAULT, &traveltime, &reachnum));
+    assert_int_equal(traveltime, 0);
+    assert_int_equal(reachnum, 0);
+
+    AAS_Shutdown();
+}
+
+/*
+ * Builds two clusters joined by portals 3 and 6.  Inside cluster 1 area 1
+ * reaches area 2 only over a slow link; through cluster 2 (1-3-4-6-2) the
+ * trip is much cheaper, but the in-cluster route is what a query takes.
+ */
+static void build_portal_detour_world(void)
+{
+    static const synthetic_link_t links[] = {
+        {1, 2, 100}, {2, 1, 100}, {1, 3, 5}, {3, 1, 5}, {3, 4, 5}, {4, 3, 5},
+        {4, 6, 5}, {6, 4, 5}, {6, 2, 5}, {2, 6, 5}, {4, 5, 5}, {5, 4, 5},
+    };
+
+    build_synthetic_areas(links, (int)(sizeof(links) / sizeof(links[0])), 6);
+
+    aasworld.numClusters = 3;
+    aasworld.clusters = (aas_cluster_t *)calloc(3U, sizeof(aas_cluster_t));
+    aasworld.numPortals = 3;
+    aasworld.portals = (aas_portal_t *)calloc(3U, sizeof(aas_portal_t));
+    aasworld.numPortalIndex = 4;
+    aasworld.portalIndex = (aas_portalindex_t *)calloc(4U, sizeof(aas_portalindex_t));
+    assert_non_null(aasworld.clusters);
+    assert_non_null(aasworld.portals);
+    assert_non_null(aasworld.portalIndex);
+
+    for (int cluster = 1; cluster <= 2; ++cluster) {
+        aasworld.clusters[cluster].numareas = 4;
+        aasworld.clusters[cluster].numreachabilityareas = 4;
+        aasworld.clusters[cluster].numportals = 2;
+        aasworld.clusters[cluster].firstportal = (cluster - 1) * 2;
+        aasworld.portalIndex[(cluster - 1) * 2] = 1;
+        aasworld.portalIndex[(cluster - 1) * 2 + 1] = 2;
+    }
+
+    aasworld.areasettings[1].cluster = 1;
+    aasworld.areasettings[1].clusterareanum = 0;
+    aasworld.areasettings[2].cluster = 1;
+    aasworld.areasettings[2].clusterareanum = 1;
+    aasworld.areasettings[3].cluster = -1;
+    aasworld.areasettings[4].cluster = 2;
+    aasworld.areasettings[4].clusterareanum = 0;
+    aasworld.areasettings[5].cluster = 2;
+    aasworld.areasettings[5].clusterareanum = 1;
+    aasworld.areasettings[6].cluster = -2;
+
+    for (int portal = 1; portal <= 2; ++portal) {
+        aasworld.portals[portal].areanum = (portal == 1) ? 3 : 6;
+        aasworld.portals[portal].frontcluster = 1;
+        aasworld.portals[portal].backcluster = 2;
+        aasworld.portals[portal].clusterareanum[0] = portal + 1;
+        aasworld.portals[portal].clusterareanum[1] = portal + 1;
+    }
+
+    AAS_InitTravelFlagFromType();
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+    aasworld.loaded = qtrue;
+}
+
+static void test_batched_travel_times_match_single_queries(void **state)
+{
+    (void)state;
+
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+
+    const int goals[] = {5, 1, 4, 3, 0, 5};
+    int times[6];
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(3, NULL, goals, 6, TFL_DEFAULT, times), 5);
+    for (int i = 0; i < 6; ++i) {
+        int single = (goals[i] > 0) ? AAS_AreaTravelTimeToGoalArea(3, NULL, goals[i], TFL_DEFAULT) : 0;
+        assert_int_equal(times[i], single);
+    }
+    assert_int_equal(times[0], 70);
+    assert_int_equal(times[4], 0);
+
+    /* The batched search must not populate per-goal routing caches. */
+    AAS_FreeAllRoutingCaches();
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(1, NULL, goals, 1, TFL_DEFAULT, times), 1);
+    assert_int_equal(times[0], 100);
+    assert_null(aasworld.routingCacheHead);
+
+    AAS_Shutdown();
+}
+
+static void test_batched_travel_times_keep_in_cluster_routes(void **state)
+{
+    (void)state;
+
+    build_portal_detour_world();
+    AAS_InitClusterRouting();
+    assert_true(aasworld.clusterRouting);
+
+    /* Area 2 shares cluster 1 with the start, area 5 does not. */
+    const int goals[] = {2, 5};
+    int times[2];
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(1, NULL, goals, 2, TFL_DEFAULT, times), 2);
+    assert_int_equal(times[0], AAS_AreaTravelTimeToGoalArea(1, NULL, 2, TFL_DEFAULT));
+    assert_int_equal(times[0], 100);
+    assert_int_equal(times[1], AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT));
+    assert_int_equal(times[1], 15);
+
+    /* A cached goal is answered from its cache, even outside the shared cluster. */
+    AAS_FreeAllRoutingCaches();
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 15);
+    assert_non_null(aasworld.routingCacheHead);
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(1, NULL, &goals[1], 1, TFL_DEFAULT, times), 1);
+    assert_int_equal(times[0], 15);
+
+    AAS_Shutdown();
+}
+
+static void test_batched_travel_times_reuse_frame_search(void **state)
+{
+    (void)state;
+
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+    AAS_RouteCacheResetDiagnostics();
+
+    /* The second batch resumes the first one's search past area 4. */
+    int goal = 4;
+    int traveltime = 0;
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(1, NULL, &goal, 1, TFL_DEFAULT, &traveltime), 1);
+    assert_int_equal(traveltime, 60);
+    goal = 5;
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(1, NULL, &goal, 1, TFL_DEFAULT, &traveltime), 1);
+    assert_int_equal(traveltime, 100);
+    assert_int_equal(AAS_RouteForwardSearchCounter(), 1);
+
+    /* Another start area or a new frame searches again. */
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(2, NULL, &goal, 1, TFL_DEFAULT, &traveltime), 1);
+    assert_int_equal(traveltime, 90);
+    assert_int_equal(AAS_RouteForwardSearchCounter(), 2);
+    aasworld.numFrames += 1;
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(1, NULL, &goal, 1, TFL_DEFAULT, &traveltime), 1);
+    assert_int_equal(traveltime, 100);
+    assert_int_equal(AAS_RouteForwardSearchCounter(), 3);
+    assert_null(aasworld.routingCacheHead);
+
+    AAS_Shutdown();
+}
+
+static void test_cluster_routing_rejects_malformed_lumps(void **state)
+{
+    (void)state;
+
+    build_two_cluster_world();
+    aasworld.portals[1].backcluster = 7;
+    AAS_InitClusterRouting();
+    assert_false(aasworld.clusterRouting);
+
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 100);
+    assert_non_null(aasworld.routingCacheHead);
+    assert_int_equal(aasworld.routingCacheHead->type, AAS_ROUTECACHE_WORLD);
+
+    AAS_Shutdown();
+}
+
+/* Builds a cluster-less corridor where each area links to its neighbours. */
+static void build_corridor_world(int num_areas)
+{
+    AAS_Shutdown();
+    memset(&aasworld, 0, sizeof(aasworld));
+
+    int num_reach = 2 * (num_areas - 1);
+    aasworld.numAreas = num_areas;
+    aasworld.areas = (aas_area_t *)calloc((size_t)num_areas + 1U, sizeof(aas_area_t));
+    aasworld.numAreaSettings = num_areas + 1;
+    aasworld.areasettings =
+        (aas_areasettings_t *)calloc((size_t)num_areas + 1U, sizeof(aas_areasettings_t));
+    aasworld.numReachability = num_reach + 1;
+    aasworld.reachability =
+        (aas_reachability_t *)calloc((size_t)num_reach + 1U, sizeof(aas_reachability_t));
+    assert_non_null(aasworld.areas);
+    assert_non_null(aasworld.areasettings);
+    assert_non_null(aasworld.reachability);
+
+    int reach_index = 1;
+    for (int area = 1; area <= num_areas; ++area) {
+        aasworld.areasettings[area].firstreachablearea = reach_index;
+        for (int neighbour = area - 1; neighbour <= area + 1; neighbour += 2) {
+            if (neighbour < 1 || neighbour > num_areas) {
+                continue;
+            }
+            aasworld.reachability[reach_index].areanum = neighbour;
+            aasworld.reachability[reach_index].traveltype = TRAVEL_WALK;
+            aasworld.reachability[reach_index].traveltime = 10;
+            aasworld.areasettings[area].numreachableareas += 1;
+            reach_index += 1;
+        }
+    }
+
+    AAS_InitTravelFlagFromType();
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+    AAS_InitClusterRouting();
+    aasworld.loaded = qtrue;
+}
+
+static void test_route_cache_lru_respects_budget(void **state)
+{
+    (void)state;
+
+    build_corridor_world(64);
+    LibVarSet("max_routingcache", "1");
+    AAS_RouteCacheResetDiagnostics();
+
+    for (int goal = 2; goal <= 64; ++goal) {
+        assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, goal, TFL_DEFAULT), (goal - 1) * 10);
+        assert_true(AAS_RouteCacheBytesInUse() <= 1024U);
+    }
+
+    assert_int_equal(AAS_RouteCacheMissCounter(), 63);
+    assert_true(AAS_RouteCacheEvictionCounter() > 0);
+    assert_int_equal(aasworld.routingCacheTail->goalArea, 64);
+
+    /* Touching an older cache moves it to the most recently used end. */
+    int resident = aasworld.routingCacheHead->goalArea;
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, resident, TFL_DEFAULT), (resident - 1) * 10);
+    assert_int_equal(AAS_RouteCacheHitCounter(), 1);
+    assert_int_equal(aasworld.routingCacheTail->goalArea, resident);
+
+    /* The first goal was evicted long ago and has to be rebuilt. */
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 2, TFL_DEFAULT), 10);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 64);
+
+    LibVarSet("max_routingcache", "4096");
+    AAS_Shutdown();
+}
+
+static void test_route_precompute_publishes_worker_caches(void **state)
+{
+    (void)state;
+
+#ifdef _WIN32
+    skip();
+#endif
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+    assert_true(aasworld.clusterRouting);
+    LibVarSet("routeprecompute", "2");
+    AAS_RegisterRouteGoalArea(5);
+    AAS_RegisterRouteGoalArea(1);
+    AAS_RouteCacheResetDiagnostics();
+
+    AAS_RouteFrameUpdate();
+    for (int frame = 0; frame < 1000 && AAS_RoutePrecomputePendingCounter() > 0; ++frame) {
+        usleep(1000);
+        AAS_RouteFrameUpdate();
+    }
+    assert_int_equal(AAS_RoutePrecomputePendingCounter(), 0);
+
+    /* Only the portal searches still run on this thread; every leg is cached. */
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 100);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(5, NULL, 1, TFL_DEFAULT), 20);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 2);
+
+    LibVarSet("routeprecompute", "0");
+    AAS_Shutdown();
+}
+
+static int count_route_caches(void)
+{
+    int count = 0;
+    for (aas_routingcache_t *cache = aasworld.routingCacheHead; cache != NULL; cache = cache->next) {
+        ++count;
+    }
+    return count;
+}
+
+static void test_mover_invalidation_only_drops_dependent_caches(void **state)
+{
+    (void)state;
+
+    build_corridor_world(4);
+    for (int index = 1; index < aasworld.numReachability; ++index) {
+        if (aasworld.reachabilityFromArea[index] == 2 && aasworld.reachability[index].areanum == 3) {
+            aasworld.reachability[index].traveltype = TRAVEL_ELEVATOR;
+            aasworld.reachability[index].facenum = 5;
+        }
+    }
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_DEFAULT), 30);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_WALK), 0);
+    assert_int_equal(count_route_caches(), 2);
+
+    assert_int_equal(AAS_InvalidateModelRouteCaches(6), 0);
+    assert_int_equal(AAS_InvalidateModelRouteCaches(5), 1);
+    assert_int_equal(count_route_caches(), 1);
+    assert_int_equal(aasworld.routingCacheHead->travelflags, TFL_WALK);
+    assert_int_equal(AAS_RouteCacheMoverInvalidationCounter(), 1);
+
+    AAS_Shutdown();
+}
+
+static void set_mover_reachability(int from, int to, int modelnum)
+{
+    for (int index = 1; index < aasworld.numReachability; ++index) {
+        if (aasworld.reachabilityFromArea[index] == from && aasworld.reachability[index].areanum == to) {
+            aasworld.reachability[index].traveltype = TRAVEL_ELEVATOR;
+            aasworld.reachability[index].facenum = modelnum;
+        }
+    }
+}
+
+static void test_mover_invalidation_tracks_routes_taken(void **state)
+{
+    (void)state;
+
+    /* Models 5 and 37 would share a bit if model numbers were folded into 32. */
+    build_corridor_world(6);
+    set_mover_reachability(2, 3, 5);
+    set_mover_reachability(4, 5, 37);
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+
+    /* Routes to area 3 ride mover 5 only; the search merely looks at mover 37. */
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 3, TFL_DEFAULT), 20);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 6, TFL_DEFAULT), 50);
+    assert_int_equal(count_route_caches(), 2);
+
+    assert_int_equal(AAS_InvalidateModelRouteCaches(37), 1);
+    assert_int_equal(count_route_caches(), 1);
+    assert_int_equal(aasworld.routingCacheHead->goalArea, 3);
+    assert_int_equal(AAS_InvalidateModelRouteCaches(5), 1);
+    assert_int_equal(count_route_caches(), 0);
+
+    /* Portal caches only take the movers of the cluster legs they use. */
+    build_two_cluster_world();
+    set_mover_reachability(4, 5, 37);
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+    AAS_InitClusterRouting();
+    assert_true(aasworld.clusterRouting);
+
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(5, NULL, 1, TFL_DEFAULT), 20);
+    int caches = count_route_caches();
+    assert_true(caches > 0);
+    assert_int_equal(AAS_InvalidateModelRouteCaches(37), 0);
+    assert_int_equal(count_route_caches(), caches);
+
+    /* Routing towards area 5 does ride mover 37; moving it keeps the caches above. */
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 100);
+    assert_true(AAS_InvalidateModelRouteCaches(37) > 0);
+    AAS_RouteCacheResetDiagnostics();
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(5, NULL, 1, TFL_DEFAULT), 20);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 0);
+
+    AAS_Shutdown();
+}
+
+static void test_equivalent_travel_flags_share_route_cache(void **state)
+{
+    (void)state;
+
+    /* The corridor only has walk reachabilities: the extra bits are inert. */
+    build_corridor_world(4);
+    AAS_RouteCacheResetDiagnostics();
+
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_DEFAULT), 30);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_DEFAULT | TFL_ROCKETJUMP), 30);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_DEFAULT | TFL_NOTTEAM1), 30);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_WALK), 30);
+    assert_int_equal(count_route_caches(), 1);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 1);
+    assert_int_equal(aasworld.routingCacheHead->travelflags, TFL_WALK);
+
+    AAS_Shutdown();
+}
+
+static void test_compact_route_caches_match_flat_caches(void **state)
+{
+    (void)state;
+
+    build_corridor_world(80);
+    int times[81];
+    int reaches[81];
+    for (int area = 1; area <= 80; ++area) {
+        assert_true(AAS_AreaRouteToGoalArea(area, NULL, 40, TFL_DEFAULT, &times[area], &reaches[area]));
+    }
+    size_t flatBytes = AAS_RouteCacheBytesInUse();
+
+    AAS_FreeAllRoutingCaches();
+    LibVarSet("routecompact", "1");
+    for (int area = 1; area <= 80; ++area) {
+        int traveltime = -1;
+        int reachnum = -1;
+        assert_true(AAS_AreaRouteToGoalArea(area, NULL, 40, TFL_DEFAULT, &traveltime, &reachnum));
+        assert_int_equal(traveltime, times[area]);
+        assert_int_equal(reachnum, reaches[area]);
+    }
+    assert_non_null(aasworld.routingCacheHead->blocks);
+    assert_true(AAS_RouteCacheBytesInUse() < flatBytes);
+
+    LibVarSet("routecompact", "0");
+    AAS_Shutdown();
+}
+
+static void test_framereachability_spreads_route_search_over_frames(void **state)
+{
+    (void)state;
+
+    build_corridor_world(80);
+    int times[81];
+    for (int area = 1; area <= 80; ++area) {
+        times[area] = AAS_AreaTravelTimeToGoalArea(area, NULL, 40, TFL_DEFAULT);
+    }
+
+    AAS_FreeAllRoutingCaches();
+    LibVarSet("framereachability", "8");
+    AAS_RouteFrameUpdate();
+
+    /* The miss only spends this frame's budget; far areas have no route yet. */
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 40, TFL_DEFAULT), 0);
+    assert_non_null(aasworld.routingCacheHead);
+    assert_non_null(aasworld.routingCacheHead->frontier);
+
+    int frames = 0;
+    while (aasworld.routingCacheHead->frontier != NULL && frames < 20) {
+        for (int area = 1; area <= 80; ++area) {
+            int traveltime = AAS_AreaTravelTimeToGoalArea(area, NULL, 40, TFL_DEFAULT);
+            assert_true(traveltime == 0 || traveltime >= times[area]);
+        }
+        AAS_RouteFrameUpdate();
+        ++frames;
+    }
+    assert_null(aasworld.routingCacheHead->frontier);
+    assert_true(frames > 1);
+
+    for (int area = 1; area <= 80; ++area) {
+        assert_int_equal(AAS_AreaTravelTimeToGoalArea(area, NULL, 40, TFL_DEFAULT), times[area]);
+    }
+    assert_int_equal(AAS_RouteCacheMissCounter(), 2);
+
+    LibVarSet("framereachability", "0");
+    AAS_Shutdown();
+}
+
+static void test_framereachability_reports_pending_cross_cluster_routes(void **state)
+{
+    (void)state;
+
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+    assert_true(aasworld.clusterRouting);
+    LibVarSet("framereachability", "1");
+    AAS_RouteFrameUpdate();
+
+    /* The portal route needs cluster legs this frame's budget cannot finish. */
+    int goal = 5;
+    int traveltime = -1;
+    assert_int_equal(AAS_AreaTravelTimesToGoalAreas(1, NULL, &goal, 1, TFL_DEFAULT, &traveltime), 0);
+    assert_int_equal(traveltime, AAS_TRAVELTIME_PENDING);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 0);
+    for (aas_routingcache_t *cache = aasworld.routingCacheHead; cache != NULL; cache = cache->next) {
+        assert_true(cache->type != AAS_ROUTECACHE_PORTAL);
+    }
+
+    int frames = 0;
+    while (traveltime == AAS_TRAVELTIME_PENDING && frames < 20) {
+        AAS_RouteFrameUpdate();
+        (void)AAS_AreaTravelTimesToGoalAreas(1, NULL, &goal, 1, TFL_DEFAULT, &traveltime);
+        ++frames;
+    }
+    assert_true(frames > 1);
+    assert_int_equal(traveltime, 100);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 100);
+
+    LibVarSet("framereachability", "0");
+    AAS_Shutdown();
+}
+
+static void test_area_order_renumbers_behind_original_numbers(void **state)
+{
+    (void)state;
+
+    static const float centers[6] = {0.0f, 200.0f, 0.0f, 400.0f, 100.0f, 300.0f};
+    build_two_cluster_world();
+    for (int area = 1; area <= 5; ++area) {
+        VectorSet(aasworld.areas[area].center, centers[area], 0.0f, 0.0f);
+    }
+    AAS_InitClusterRouting();
+
+    int times[6][6];
+    for (int area = 1; area <= 5; ++area) {
+        for (int goal = 1; goal <= 5; ++goal) {
+            times[area][goal] = AAS_AreaTravelTimeToGoalArea(area, NULL, goal, TFL_DEFAULT);
+        }
+    }
+
+    /* File order unless areaorder asks for the curve. */
+    AAS_RenumberAreas();
+    assert_null(aasworld.areaOriginalNum);
+    assert_int_equal(AAS_AreaInternalNum(4), 4);
+
+    LibVarSet("areaorder", "1");
+    AAS_FreeAllRoutingCaches();
+    AAS_ClearReachabilityData();
+    AAS_RenumberAreas();
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+    AAS_InitClusterRouting();
+    assert_true(aasworld.clusterRouting);
+    assert_int_equal(aasworld.areaOrder, 1);
+
+    /* Areas now follow their centres along x. */
+    for (int area = 1; area <= 5; ++area) {
+        assert_int_equal(AAS_AreaOriginalNum(AAS_AreaInternalNum(area)), area);
+        assert_true(aasworld.areas[area].center[0] == (float)(area - 1) * 100.0f);
+        assert_int_equal(aasworld.areas[area].areanum, area);
+    }
+    assert_int_equal(AAS_AreaInternalNum(3), 5);
+    assert_int_equal(aasworld.portals[1].areanum, 5);
+
+    for (int area = 1; area <= 5; ++area) {
+        for (int goal = 1; goal <= 5; ++goal) {
+            int traveltime = AAS_AreaTravelTimeToGoalArea(
+                AAS_AreaInternalNum(area), NULL, AAS_AreaInternalNum(goal), TFL_DEFAULT);
+            assert_int_equal(traveltime, times[area][goal]);
+        }
+    }
+
+    LibVarSet("areaorder", "0");
+    AAS_Shutdown();
+    assert_null(aasworld.areaOriginalNum);
+}
+
+static void test_area_order_keeps_file_order_for_mismatched_lumps(void **state)
+{
+    (void)state;
+
+    build_two_cluster_world();
+    for (int area = 1; area <= 5; ++area) {
+        VectorSet(aasworld.areas[area].center, (float)(5 - area) * 100.0f, 0.0f, 0.0f);
+    }
+
+    /* One area has no settings entry; renumbering would walk past the lump. */
+    aasworld.numAreaSettings = 5;
+    LibVarSet("areaorder", "1");
+    AAS_RenumberAreas();
+    assert_null(aasworld.areaOriginalNum);
+    assert_int_equal(aasworld.areaOrder, 0);
+    assert_int_equal(aasworld.numAreas, 5);
+    assert_int_equal(aasworld.numAreaSettings, 5);
+    assert_int_equal(AAS_AreaInternalNum(1), 1);
+    assert_true(aasworld.areas[1].center[0] == 400.0f);
+
+    LibVarSet("areaorder", "0");
+    AAS_Shutdown();
+}
+
+static void test_point_area_num_walks_node_tree(void **state)
+{
+    (void)state;
+
+    /* Two areas whose bounds overlap, split by the plane x = 0. */
+    build_corridor_world(2);
+    for (int area = 1; area <= 2; ++area) {
+        VectorSet(aasworld.areas[area].mins, -64.0f, -64.0f, -64.0f);
+        VectorSet(aasworld.areas[area].maxs, 64.0f, 64.0f, 64.0f);
+    }
+
+    vec3_t east = {16.0f, 0.0f, 0.0f};
+    vec3_t west = {-16.0f, 0.0f, 0.0f};
+    assert_int_equal(AAS_PointAreaNum(east), 1);
+
+    aasworld.numPlanes = 1;
+    aasworld.planes = (aas_plane_t *)calloc(1U, sizeof(aas_plane_t));
+    aasworld.numNodes = 2;
+    aasworld.nodes = (aas_node_t *)calloc(2U, sizeof(aas_node_t));
+    assert_non_null(aasworld.planes);
+    assert_non_null(aasworld.nodes);
+    VectorSet(aasworld.planes[0].normal, 1.0f, 0.0f, 0.0f);
+    aasworld.nodes[1].planenum = 0;
+    aasworld.nodes[1].children[0] = -2;
+    aasworld.nodes[1].children[1] = -1;
+
+    assert_int_equal(AAS_PointAreaNum(east), 2);
+    assert_int_equal(AAS_PointAreaNum(west), 1);
+
+    aasworld.nodes[1].children[0] = 0;
+    assert_int_equal(AAS_PointAreaNum(east), 0);
+
+    aasworld.nodes[1].planenum = 7;
+    assert_int_equal(AAS_PointAreaNum(west), 0);
+
+    AAS_Shutdown();
+}
+
+static void test_box_and_trace_queries_walk_node_tree(void **state)
+{
+    (void)state;
+
+    /* x = 0 splits off area 3 to the west; y = 0 splits the east into 1 and 2. */
+    build_corridor_world(3);
+    VectorSet(aasworld.areas[1].mins, 0.0f, 0.0f, -64.0f);
+    VectorSet(aasworld.areas[1].maxs, 64.0f, 64.0f, 64.0f);
+    VectorSet(aasworld.areas[2].mins, 0.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[2].maxs, 64.0f, 0.0f, 64.0f);
+    VectorSet(aasworld.areas[3].mins, -64.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[3].maxs, 0.0f, 64.0f, 64.0f);
+
+    vec3_t start = {-32.0f, 48.0f, 0.0f};
+    vec3_t end = {32.0f, -16.0f, 0.0f};
+    int areas[4];
+    vec3_t points[4];
+
+    /* Without a tree both queries scan area bounds. */
+    assert_int_equal(AAS_TraceAreas(start, end, areas, points, 4), 3);
+    assert_int_equal(areas[0], 3);
+    assert_int_equal(areas[1], 1);
+    assert_int_equal(areas[2], 2);
+    assert_float_equal(points[1][1], 16.0f, 0.001f);
+    assert_float_equal(points[2][0], 16.0f, 0.001f);
+
+    aasworld.numPlanes = 2;
+    aasworld.planes = (aas_plane_t *)calloc(2U, sizeof(aas_plane_t));
+    aasworld.numNodes = 3;
+    aasworld.nodes = (aas_node_t *)calloc(3U, sizeof(aas_node_t));
+    assert_non_null(aasworld.planes);
+    assert_non_null(aasworld.nodes);
+    VectorSet(aasworld.planes[0].normal, 1.0f, 0.0f, 0.0f);
+    VectorSet(aasworld.planes[1].normal, 0.0f, 1.0f, 0.0f);
+    aasworld.nodes[1].planenum = 0;
+    aasworld.nodes[1].children[0] = 2;
+    aasworld.nodes[1].children[1] = -3;
+    aasworld.nodes[2].planenum = 1;
+    aasworld.nodes[2].children[0] = -1;
+    aasworld.nodes[2].children[1] = -2;
+
+    memset(areas, 0, sizeof(areas));
+    assert_int_equal(AAS_TraceAreas(start, end, areas, points, 4), 3);
+    assert_int_equal(areas[0], 3);
+    assert_int_equal(areas[1], 1);
+    assert_int_equal(areas[2], 2);
+    assert_float_equal(points[0][0], -32.0f, 0.001f);
+    assert_float_equal(points[1][0], 0.0f, 0.001f);
+    assert_float_equal(points[1][1], 16.0f, 0.001f);
+    assert_float_equal(points[2][0], 16.0f, 0.001f);
+    assert_float_equal(points[2][1], 0.0f, 0.001f);
+    assert_int_equal(AAS_TraceAreas(start, end, areas, NULL, 2), 2);
+    assert_int_equal(areas[1], 1);
+
+    vec3_t mins = {-8.0f, -8.0f, -8.0f};
+    vec3_t maxs = {8.0f, 8.0f, 8.0f};
+    assert_int_equal(AAS_BBoxAreas(mins, maxs, areas, 4), 3);
+    assert_int_equal(areas[0] + areas[1] + areas[2], 6);
+
+    VectorSet(mins, 8.0f, 8.0f, -8.0f);
+    VectorSet(maxs, 24.0f, 24.0f, 8.0f);
+    assert_int_equal(AAS_BBoxAreas(mins, maxs, areas, 4), 1);
+    assert_int_equal(areas[0], 1);
+
+    AAS_Shutdown();
+}
+
+typedef struct bsp_fixture_s {
+    unsigned char data[1024];
+    size_t size;
+    q2_lump_t lumps[Q2_BSP_LUMP_MAX];
+} bsp_fixture_t;
+
+static void bsp_put_long(bsp_fixture_t *bsp, int32_t value)
+{
+    uint32_t bits = (uint32_t)value;
+    for (int byte = 0; byte < 4; ++byte) {
+        bsp->data[bsp->size++] = (unsigned char)(bits >> (8 * byte));
+    }
+}
+
+static void bsp_put_float(bsp_fixture_t *bsp, float value)
+{
+    int32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bsp_put_long(bsp, bits);
+}
+
+static void bsp_put_short(bsp_fixture_t *bsp, int value)
+{
+    bsp->data[bsp->size++] = (unsigned char)(value & 0xff);
+    bsp->data[bsp->size++] = (unsigned char)((value >> 8) & 0xff);
+}
+
+static void bsp_begin_lump(bsp_fixture_t *bsp, int lump)
+{
+    bsp->lumps[lump].offset = (int32_t)bsp->size;
+}
+
+static void bsp_end_lump(bsp_fixture_t *bsp, int lump)
+{
+    bsp->lumps[lump].length = (int32_t)bsp->size - bsp->lumps[lump].offset;
+}
+
+static void bsp_put_plane(bsp_fixture_t *bsp, float x, float y, float z, float dist, int type)
+{
+    bsp_put_float(bsp, x);
+    bsp_put_float(bsp, y);
+    bsp_put_float(bsp, z);
+    bsp_put_float(bsp, dist);
+    bsp_put_long(bsp, type);
+}
+
+static void bsp_put_node(bsp_fixture_t *bsp, int planenum, int front, int back)
+{
+    bsp_put_long(bsp, planenum);
+    bsp_put_long(bsp, front);
+    bsp_put_long(bsp, back);
+    for (int pad = 0; pad < 8; ++pad) {
+        bsp_put_short(bsp, 0);
+    }
+}
+
+static void bsp_put_leaf(bsp_fixture_t *bsp, int contents, int cluster, int firstbrush, int numbrushes)
+{
+    bsp_put_long(bsp, contents);
+    bsp_put_short(bsp, cluster);
+    for (int pad = 0; pad < 7; ++pad) {
+        bsp_put_short(bsp, 0);
+    }
+    bsp_put_short(bsp, 0);
+    bsp_put_short(bsp, 0);
+    bsp_put_short(bsp, firstbrush);
+    bsp_put_short(bsp, numbrushes);
+}
+
+/*
+ * One solid brush filling 64 <= x <= 128 and |y|, |z| <= 64.  The open space
+ * west of it is cluster 0 and east of it cluster 1; the PVS row count is ten
+ * so the rows exercise the zero-run coding.
+ */
+static void build_single_brush_bsp(bsp_fixture_t *bsp)
+{
+    memset(bsp, 0, sizeof(*bsp));
+
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_PLANES);
+    bsp_put_plane(bsp, 1.0f, 0.0f, 0.0f, 128.0f, 0);
+    bsp_put_plane(bsp, -1.0f, 0.0f, 0.0f, -64.0f, 0);
+    bsp_put_plane(bsp, 0.0f, 1.0f, 0.0f, 64.0f, 1);
+    bsp_put_plane(bsp, 0.0f, -1.0f, 0.0f, 64.0f, 1);
+    bsp_put_plane(bsp, 0.0f, 0.0f, 1.0f, 64.0f, 2);
+    bsp_put_plane(bsp, 0.0f, 0.0f, -1.0f, 64.0f, 2);
+    bsp_put_plane(bsp, 1.0f, 0.0f, 0.0f, 64.0f, 0);
+    bsp_end_lump(bsp, Q2_BSP_LUMP_PLANES);
+
+    /* x = 64 then x = 128 isolate leaf 1 as the slab holding the brush. */
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_NODES);
+    bsp_put_node(bsp, 6, 1, -3);
+    bsp_put_node(bsp, 0, -4, -2);
+    bsp_end_lump(bsp, Q2_BSP_LUMP_NODES);
+
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_LEAFS);
+    bsp_put_leaf(bsp, CONTENTS_SOLID, -1, 0, 0);
+    bsp_put_leaf(bsp, CONTENTS_SOLID, -1, 0, 1);
+    bsp_put_leaf(bsp, 0, 0, 0, 0);
+    bsp_put_leaf(bsp, 0, 1, 0, 0);
+    bsp_end_lump(bsp, Q2_BSP_LUMP_LEAFS);
+
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_VISIBILITY);
+    int vis_start = (int)bsp->size;
+    bsp_put_long(bsp, 10);
+    for (int cluster = 0; cluster < 10; ++cluster) {
+        int row = 4 + 10 * 8 + ((cluster < 2) ? cluster : 2) * 3;
+        bsp_put_long(bsp, row);
+        bsp_put_long(bsp, row);
+    }
+    assert_int_equal((int)bsp->size - vis_start, 4 + 10 * 8);
+    const unsigned char rows[] = {0x01, 0x00, 0x01, 0x02, 0x00, 0x01, 0xff, 0x03};
+    memcpy(&bsp->data[bsp->size], rows, sizeof(rows));
+    bsp->size += sizeof(rows);
+    bsp_end_lump(bsp, Q2_BSP_LUMP_VISIBILITY);
+
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_LEAFBRUSHES);
+    bsp_put_short(bsp, 0);
+    bsp_end_lump(bsp, Q2_BSP_LUMP_LEAFBRUSHES);
+
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_BRUSHES);
+    bsp_put_long(bsp, 0);
+    bsp_put_long(bsp, 6);
+    bsp_put_long(bsp, CONTENTS_SOLID);
+    bsp_end_lump(bsp, Q2_BSP_LUMP_BRUSHES);
+
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_BRUSHSIDES);
+    for (int side = 0; side < 6; ++side) {
+        bsp_put_short(bsp, side);
+        bsp_put_short(bsp, 0);
+    }
+    bsp_end_lump(bsp, Q2_BSP_LUMP_BRUSHSIDES);
+
+    bsp_begin_lump(bsp, Q2_BSP_LUMP_MODELS);
+    for (int value = 0; value < 9; ++value) {
+        bsp_put_float(bsp, 0.0f);
+    }
+    bsp_put_long(bsp, 0);
+    bsp_put_long(bsp, 0);
+    bsp_put_long(bsp, 0);
+    bsp_end_lump(bsp, Q2_BSP_LUMP_MODELS);
+
+    assert_true(bsp->size <= sizeof(bsp->data));
+}
+
+static void test_native_bsp_trace_clips_against_brushes(void **state)
+{
+    (void)state;
+
+    bsp_fixture_t bsp;
+    build_single_brush_bsp(&bsp);
+    assert_int_equal(AAS_LoadBSPCollision(bsp.data, bsp.size, bsp.lumps), BLERR_NOERROR);
+    assert_true(AAS_BSPCollisionLoaded());
+
+    vec3_t inside = {96.0f, 0.0f, 0.0f};
+    vec3_t before = {0.0f, 0.0f, 0.0f};
+    vec3_t beyond = {200.0f, 0.0f, 0.0f};
+    assert_int_equal(AAS_BSPPointContents(inside), CONTENTS_SOLID);
+    assert_int_equal(AAS_BSPPointContents(before), 0);
+    assert_int_equal(AAS_BSPPointContents(beyond), 0);
+
+    vec3_t start = {0.0f, 0.0f, 0.0f};
+    vec3_t end = {256.0f, 0.0f, 0.0f};
+    bsp_trace_t trace = AAS_BSPTrace(start, NULL, NULL, end, MASK_SOLID);
+    assert_false(trace.startsolid);
+    assert_float_equal(trace.fraction, (64.0f - 0.03125f) / 256.0f, 0.0001f);
+    assert_float_equal(trace.endpos[0], 64.0f - 0.03125f, 0.01f);
+    assert_float_equal(trace.plane.normal[0], -1.0f, 0.0001f);
+    assert_int_equal(trace.contents, CONTENTS_SOLID);
+    assert_int_equal(trace.ent, 0);
+
+    vec3_t mins = {-16.0f, -16.0f, -16.0f};
+    vec3_t maxs = {16.0f, 16.0f, 16.0f};
+    trace = AAS_BSPTrace(start, mins, maxs, end, MASK_SOLID);
+    assert_float_equal(trace.endpos[0], 48.0f - 0.03125f, 0.01f);
+
+    trace = AAS_BSPTrace(start, NULL, NULL, end, CONTENTS_WATER);
+    assert_float_equal(trace.fraction, 1.0f, 0.0001f);
+
+    vec3_t over_start = {0.0f, 0.0f, 100.0f};
+    vec3_t over_end = {256.0f, 0.0f, 100.0f};
+    trace = AAS_BSPTrace(over_start, NULL, NULL, over_end, MASK_SOLID);
+    assert_float_equal(trace.fraction, 1.0f, 0.0001f);
+    assert_float_equal(trace.endpos[0], 256.0f, 0.0001f);
+
+    trace = AAS_BSPTrace(inside, mins, maxs, inside, MASK_SOLID);
+    assert_true(trace.startsolid);
+    assert_true(trace.allsolid);
+
+    /* A node pointing past the leaf lump disables native traces. */
+    int32_t bad_child = 7;
+    memcpy(&bsp.data[bsp.lumps[Q2_BSP_LUMP_NODES].offset + 4], &bad_child, sizeof(bad_child));
+    assert_int_equal(AAS_LoadBSPCollision(bsp.data, bsp.size, bsp.lumps), BLERR_CANNOTREADBSPLUMP);
+    assert_false(AAS_BSPCollisionLoaded());
+    trace = AAS_BSPTrace(start, NULL, NULL, end, MASK_SOLID);
+    assert_float_equal(trace.fraction, 1.0f, 0.0001f);
+}
+
+static void test_native_bsp_pvs_separates_clusters(void **state)
+{
+    (void)state;
+
+    bsp_fixture_t bsp;
+    build_single_brush_bsp(&bsp);
+    assert_int_equal(AAS_LoadBSPCollision(bsp.data, bsp.size, bsp.lumps), BLERR_NOERROR);
+
+    vec3_t west = {0.0f, 0.0f, 0.0f};
+    vec3_t inside = {96.0f, 0.0f, 0.0f};
+    vec3_t east = {200.0f, 0.0f, 0.0f};
+    assert_int_equal(AAS_BSPPointCluster(west), 0);
+    assert_int_equal(AAS_BSPPointCluster(inside), -1);
+    assert_int_equal(AAS_BSPPointCluster(east), 1);
+
+    assert_true(AAS_BSPClustersVisible(0, 0));
+    assert_true(AAS_BSPClustersVisible(1, 1));
+    assert_false(AAS_BSPClustersVisible(0, 1));
+    assert_false(AAS_BSPClustersVisible(1, 0));
+    assert_false(AAS_BSPClustersVisible(0, 9));
+    assert_true(AAS_BSPClustersVisible(2, 9));
+    assert_true(AAS_BSPClustersVisible(-1, 1));
+    assert_true(AAS_BSPClustersVisible(0, 10));
+
+    /* Without a visibility lump nothing is culled. */
+    bsp.lumps[Q2_BSP_LUMP_VISIBILITY].length = 0;
+    assert_int_equal(AAS_LoadBSPCollision(bsp.data, bsp.size, bsp.lumps), BLERR_NOERROR);
+    assert_true(AAS_BSPClustersVisible(0, 1));
+
+    /* A row running past the lump disables the PVS but keeps traces. */
+    bsp.lumps[Q2_BSP_LUMP_VISIBILITY].length = 4 + 10 * 8 + 4;
+    assert_int_equal(AAS_LoadBSPCollision(bsp.data, bsp.size, bsp.lumps), BLERR_NOERROR);
+    assert_true(AAS_BSPCollisionLoaded());
+    assert_true(AAS_BSPClustersVisible(0, 1));
+}
+
+static void test_entity_linking_walks_node_tree(void **state)
+{
+    (void)state;
+
+    /* Areas 1 and 2 sit either side of x = 0; area 3 overlaps both but is
+     * unreachable through the tree and must never be linked. */
+    build_corridor_world(3);
+    VectorSet(aasworld.areas[1].mins, -64.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[1].maxs, 0.0f, 64.0f, 64.0f);
+    VectorSet(aasworld.areas[2].mins, 0.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[2].maxs, 64.0f, 64.0f, 64.0f);
+    VectorSet(aasworld.areas[3].mins, -64.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[3].maxs, 64.0f, 64.0f, 64.0f);
+
+    aasworld.numPlanes = 1;
+    aasworld.planes = (aas_plane_t *)calloc(1U, sizeof(aas_plane_t));
+    aasworld.numNodes = 2;
+    aasworld.nodes = (aas_node_t *)calloc(2U, sizeof(aas_node_t));
+    assert_non_null(aasworld.planes);
+    assert_non_null(aasworld.nodes);
+    VectorSet(aasworld.planes[0].normal, 1.0f, 0.0f, 0.0f);
+    aasworld.nodes[1].children[0] = -2;
+    aasworld.nodes[1].children[1] = -1;
+
+    AASEntityFrame frame = {0};
+    VectorSet(frame.mins, -8.0f, -8.0f, -8.0f);
+    VectorSet(frame.maxs, 8.0f, 8.0f, 8.0f);
+    frame.origin_dirty = true;
+    assert_int_equal(AAS_UpdateEntity(1, &frame), BLERR_NOERROR);
+    int both_areas[] = {1, 2};
+    assert_entity_area_membership(1, both_areas, 2);
+    assert_area_entity_list_contains(1, 1);
+    assert_area_entity_list_contains(2, 1);
+    assert_null(aasworld.areaEntityLists[3]);
+    assert_true(AAS_EntityInArea(1, 1));
+    assert_true(AAS_EntityInArea(1, 2));
+    assert_false(AAS_EntityInArea(1, 3));
+    assert_int_equal(AAS_AreaEntityCount(1), 1);
+    assert_int_equal(AAS_AreaEntityCount(2), 1);
+    assert_int_equal(AAS_AreaEntityCount(3), 0);
+
+    VectorSet(frame.origin, 32.0f, 0.0f, 0.0f);
+    assert_int_equal(AAS_UpdateEntity(1, &frame), BLERR_NOERROR);
+    int east_area[] = {2};
+    assert_entity_area_membership(1, east_area, 1);
+    assert_null(aasworld.areaEntityLists[1]);
+    assert_false(AAS_EntityInArea(1, 1));
+    assert_true(AAS_EntityInArea(1, 2));
+    assert_int_equal(AAS_AreaEntityCount(1), 0);
+    assert_int_equal(AAS_AreaEntityCount(2), 1);
+
+    assert_int_equal(AAS_UpdateEntity(1, NULL), BLERR_NOERROR);
+    assert_false(AAS_EntityInArea(1, 2));
+    assert_int_equal(AAS_AreaEntityCount(2), 0);
+
+    /* Relinking recycles pooled links rather than growing the pool. */
+    assert_non_null(aasworld.linkBlocks);
+    assert_null(aasworld.linkBlocks->next);
+    assert_non_null(aasworld.freeLinks);
+
+    AAS_Shutdown();
+    assert_null(aasworld.linkBlocks);
+}
+
+static void test_entity_area_queries_past_inline_slots(void **state)
+{
+    (void)state;
+
+    /* Twelve stacked areas: one entity spans them all, a second sits in one. */
+    build_corridor_world(12);
+    for (int area = 1; area <= 12; ++area) {
+        VectorSet(aasworld.areas[area].mins, (float)(area - 1) * 16.0f, -16.0f, -16.0f);
+        VectorSet(aasworld.areas[area].maxs, (float)area * 16.0f, 16.0f, 16.0f);
+    }
+
+    AASEntityFrame wide = {0};
+    VectorSet(wide.mins, 1.0f, -8.0f, -8.0f);
+    VectorSet(wide.maxs, 191.0f, 8.0f, 8.0f);
+    wide.origin_dirty = true;
+    assert_int_equal(AAS_UpdateEntity(1, &wide), BLERR_NOERROR);
+    assert_true(aasworld.entities[1].areaOccupancyCount > AAS_ENTITY_AREA_SLOTS);
+
+    AASEntityFrame small = {0};
+    VectorSet(small.origin, 168.0f, 0.0f, 0.0f);
+    VectorSet(small.mins, -4.0f, -4.0f, -4.0f);
+    VectorSet(small.maxs, 4.0f, 4.0f, 4.0f);
+    small.origin_dirty = true;
+    assert_int_equal(AAS_UpdateEntity(2, &small), BLERR_NOERROR);
+    assert_int_equal(aasworld.entities[2].areaOccupancyCount, 1);
+
+    for (int area = 1; area <= 12; ++area) {
+        assert_true(AAS_EntityInArea(1, area));
+        assert_int_equal(AAS_EntityInArea(2, area), area == 11);
+        assert_int_equal(AAS_AreaEntityCount(area), area == 11 ? 2 : 1);
+    }
+    assert_false(AAS_EntityInArea(1, 13));
+    assert_int_equal(AAS_AreaEntityCount(13), 0);
+
+    assert_int_equal(AAS_UpdateEntity(1, NULL), BLERR_NOERROR);
+    for (int area = 1; area <= 12; ++area) {
+        assert_false(AAS_EntityInArea(1, area));
+        assert_int_equal(AAS_AreaEntityCount(area), area == 11 ? 1 : 0);
+    }
+
+    AAS_Shutdown();
+}
+
+static void test_frame_entity_lists_unlink_stale_entities(void **state)
+{
+    (void)state;
+
+    build_corridor_world(2);
+    VectorSet(aasworld.areas[1].mins, -64.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[1].maxs, 0.0f, 64.0f, 64.0f);
+    VectorSet(aasworld.areas[2].mins, 0.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[2].maxs, 64.0f, 64.0f, 64.0f);
+
+    AASEntityFrame west = {0};
+    VectorSet(west.origin, -32.0f, 0.0f, 0.0f);
+    VectorSet(west.mins, -4.0f, -4.0f, -4.0f);
+    VectorSet(west.maxs, 4.0f, 4.0f, 4.0f);
+    west.origin_dirty = true;
+    AASEntityFrame east = west;
+    VectorSet(east.origin, 32.0f, 0.0f, 0.0f);
+
+    /* Frame 1: both entities linked; a repeated update lists them once. */
+    assert_int_equal(AAS_UpdateEntity(3, &west), BLERR_NOERROR);
+    assert_int_equal(AAS_UpdateEntity(5, &east), BLERR_NOERROR);
+    assert_int_equal(AAS_UpdateEntity(5, &east), BLERR_NOERROR);
+    assert_int_equal(aasworld.numFrameEntities, 2);
+    assert_int_equal(aasworld.entities[4].number, 4);
+
+    /* Frame 2: only entity 3 is updated, and unchanged so it is not relinked. */
+    AAS_UnlinkInvalidEntities();
+    AAS_InvalidateEntities();
+    assert_int_equal(aasworld.numFrameEntities, 0);
+    assert_int_equal(aasworld.numLastFrameEntities, 2);
+    assert_false(aasworld.entities[3].inuse);
+    west.origin_dirty = false;
+    assert_int_equal(AAS_UpdateEntity(3, &west), BLERR_NOERROR);
+    assert_true(AAS_EntityInArea(3, 1));
+    assert_true(AAS_EntityInArea(5, 2));
+
+    /* Frame 3: entity 5 missed the last frame and drops out of its areas. */
+    AAS_UnlinkInvalidEntities();
+    AAS_InvalidateEntities();
+    assert_true(AAS_EntityInArea(3, 1));
+    assert_false(AAS_EntityInArea(5, 2));
+    assert_true(aasworld.entities[5].outsideAllAreas);
+    assert_int_equal(AAS_AreaEntityCount(2), 0);
+
+    AAS_Shutdown();
+    assert_null(aasworld.frameEntities);
+    assert_null(aasworld.lastFrameEntities);
+}
+
+static void test_entity_table_grows_geometrically(void **state)
+{
+    (void)state;
+
+    build_corridor_world(1);
+    VectorSet(aasworld.areas[1].mins, -64.0f, -64.0f, -64.0f);
+    VectorSet(aasworld.areas[1].maxs, 64.0f, 64.0f, 64.0f);
+
+    AASEntityFrame frame = {0};
+    VectorSet(frame.mins, -4.0f, -4.0f, -4.0f);
+    VectorSet(frame.maxs, 4.0f, 4.0f, 4.0f);
+    frame.origin_dirty = true;
+
+    assert_int_equal(AAS_UpdateEntity(2, &frame), BLERR_NOERROR);
+    assert_int_equal(aasworld.maxEntities, 64);
+    assert_int_equal(AAS_UpdateEntity(63, &frame), BLERR_NOERROR);
+    assert_int_equal(aasworld.maxEntities, 64);
+    assert_int_equal(AAS_UpdateEntity(64, &frame), BLERR_NOERROR);
+    assert_int_equal(aasworld.maxEntities, 128);
+    assert_int_equal(AAS_UpdateEntity(1500, &frame), BLERR_NOERROR);
+    assert_int_equal(aasworld.maxEntities, 2048);
+
+    /* Earlier entities survive the moves and keep their links. */
+    assert_true(AAS_EntityInArea(2, 1));
+    assert_true(AAS_EntityInArea(1500, 1));
+    assert_int_equal(AAS_AreaEntityCount(1), 4);
+    assert_int_equal(aasworld.entities[1000].number, 1000);
+    assert_false(aasworld.entities[1000].inuse);
+    assert_int_equal(aasworld.numFrameEntities, 4);
+
+    AAS_Shutdown();
+}
+
+static void set_sidecar_identity(const char *aas_path, int aas_checksum)
+{
+    snprintf(aasworld.aasFilePath, sizeof(aasworld.aasFilePath), "%s", aas_path);
+    aasworld.aasChecksum = aas_checksum;
+    aasworld.bspChecksum = 5678;
+}
+
+static void test_route_cache_sidecar_round_trip(void **state)
+{
+    (void)state;
+
+    char temp_path[L_tmpnam];
+    assert_non_null(tmpnam(temp_path));
+    char aas_path[PATH_MAX];
+    char rcd_path[PATH_MAX];
+    snprintf(aas_path, sizeof(aas_path), "%s.aas", temp_path);
+    snprintf(rcd_path, sizeof(rcd_path), "%s.rcd", temp_path);
+
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+    set_sidecar_identity(aas_path, 1234);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 5, TFL_DEFAULT), 100);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(5, NULL, 1, TFL_DEFAULT), 20);
+    int written = count_route_caches();
+    assert_true(written > 0);
+
+    /* Tearing the world down with forcewrite set saves the caches. */
+    LibVarSet("forcewrite", "1");
+    build_two_cluster_world();
+    LibVarSet("forcewrite", "0");
+    AAS_InitClusterRouting();
+    set_sidecar_identity(aas_path, 1234);
+
+    assert_int_equal(AAS_ReadRouteCache(), written);
+    AAS_RouteCacheResetDiagnostics();
+    int traveltime = 0;
+    int reachnum = 0;
+    assert_true(AAS_AreaRouteToGoalArea(1, NULL, 5, TFL_DEFAULT, &traveltime, &reachnum));
+    assert_int_equal(traveltime, 100);
+    assert_int_equal(reachnum, 1);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(5, NULL, 1, TFL_DEFAULT), 20);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 0);
+
+    /* A sidecar written for different AAS data is ignored. */
+    AAS_FreeAllRoutingCaches();
+    set_sidecar_identity(aas_path, 4321);
+    assert_int_equal(AAS_ReadRouteCache(), 0);
+    assert_null(aasworld.routingCacheHead);
+
+    remove(rcd_path);
+    AAS_Shutdown();
+}
+
+static void assert_routes_match(const int *times, const int *reaches, int numAreas)
+{
+    for (int area = 1; area <= numAreas; ++area) {
+        for (int goal = 1; goal <= numAreas; ++goal) {
+            int traveltime = -1;
+            int reachnum = -1;
+            (void)AAS_AreaRouteToGoalArea(area, NULL, goal, TFL_DEFAULT, &traveltime, &reachnum);
+            assert_int_equal(traveltime, times[area * (numAreas + 1) + goal]);
+            assert_int_equal(reachnum, reaches[area * (numAreas + 1) + goal]);
+        }
+    }
+}
+
+static void test_route_matrix_sidecar_answers_without_caches(void **state)
+{
+    (void)state;
+
+    char temp_path[L_tmpnam];
+    assert_non_null(tmpnam(temp_path));
+    char aas_path[PATH_MAX];
+    char rtm_path[PATH_MAX];
+    snprintf(aas_path, sizeof(aas_path), "%s.aas", temp_path);
+    snprintf(rtm_path, sizeof(rtm_path), "%s.rtm", temp_path);
+
+    build_two_cluster_world();
+    AAS_InitClusterRouting();
+    set_sidecar_identity(aas_path, 1234);
+
+    int numAreas = aasworld.numAreas;
+    int *times = calloc((size_t)(numAreas + 1) * (size_t)(numAreas + 1), sizeof(int));
+    int *reaches = calloc((size_t)(numAreas + 1) * (size_t)(numAreas + 1), sizeof(int));
+    assert_non_null(times);
+    assert_non_null(reaches);
+    for (int area = 1; area <= numAreas; ++area) {
+        for (int goal = 1; goal <= numAreas; ++goal) {
+            int index = area * (numAreas + 1) + goal;
+            (void)AAS_AreaRouteToGoalArea(area, NULL, goal, TFL_DEFAULT, &times[index], &reaches[index]);
+        }
+    }
+
+    /* Maps above the area limit keep routing through the caches. */
+    LibVarSet("routematrix", "2");
+    assert_false(AAS_InitRouteMatrix());
+
+    LibVarSet("routematrix", "64");
+    AAS_FreeAllRoutingCaches();
+    assert_true(AAS_InitRouteMatrix());
+    AAS_RouteCacheResetDiagnostics();
+    assert_routes_match(times, reaches, numAreas);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 0);
+    assert_null(aasworld.routingCacheHead);
+
+    /* The second load maps the sidecar the first one wrote. */
+    FILE *sidecar = fopen(rtm_path, "rb");
+    assert_non_null(sidecar);
+    fclose(sidecar);
+    assert_true(AAS_InitRouteMatrix());
+    assert_routes_match(times, reaches, numAreas);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 0);
+
+    /* A sidecar written for different AAS data is rebuilt. */
+    set_sidecar_identity(aas_path, 4321);
+    assert_true(AAS_InitRouteMatrix());
+    assert_routes_match(times, reaches, numAreas);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 0);
+
+    LibVarSet("routematrix", "0");
+    free(times);
+    free(reaches);
+    remove(rtm_path);
+    AAS_Shutdown();
+}
+
+static void test_route_matrix_survives_mover_moves(void **state)
+{
+    (void)state;
+
+    char temp_path[L_tmpnam];
+    assert_non_null(tmpnam(temp_path));
+    char aas_path[PATH_MAX];
+    char rtm_path[PATH_MAX];
+    snprintf(aas_path, sizeof(aas_path), "%s.aas", temp_path);
+    snprintf(rtm_path, sizeof(rtm_path), "%s.rtm", temp_path);
+
+    build_corridor_world(4);
+    for (int index = 1; index < aasworld.numReachability; ++index) {
+        if (aasworld.reachabilityFromArea[index] == 2 && aasworld.reachability[index].areanum == 3) {
+            aasworld.reachability[index].traveltype = TRAVEL_ELEVATOR;
+            aasworld.reachability[index].facenum = 5;
+        }
+    }
+    assert_int_equal(AAS_PrepareReachability(), BLERR_NOERROR);
+    set_sidecar_identity(aas_path, 1234);
+
+    LibVarSet("routematrix", "64");
+    assert_true(AAS_InitRouteMatrix());
+    AAS_RouteCacheResetDiagnostics();
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_DEFAULT), 30);
+
+    /* The matrix holds static reachability times; a moving elevator leaves it in use. */
+    AAS_InvalidateModelRouteCaches(5);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(1, NULL, 4, TFL_DEFAULT), 30);
+    assert_int_equal(AAS_AreaTravelTimeToGoalArea(4, NULL, 1, TFL_DEFAULT), 30);
+    assert_int_equal(AAS_RouteCacheMissCounter(), 0);
+    assert_null(aasworld.routingCacheHead);
+
+    LibVarSet("routematrix", "0");
+    remove(rtm_path);
+    AAS_Shutdown();
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -527,6 +1952,87 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_reachability_force_clustering_toggle,
                                         aas_environment_setup,
                                         aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_cluster_routing_crosses_portals,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_route_to_goal_reports_next_reachability,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_batched_travel_times_match_single_queries,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_batched_travel_times_keep_in_cluster_routes,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_route_cache_sidecar_round_trip,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_batched_travel_times_reuse_frame_search,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_cluster_routing_rejects_malformed_lumps,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_route_cache_lru_respects_budget,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_route_precompute_publishes_worker_caches,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_mover_invalidation_only_drops_dependent_caches,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_mover_invalidation_tracks_routes_taken,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_equivalent_travel_flags_share_route_cache,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_compact_route_caches_match_flat_caches,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_route_matrix_sidecar_answers_without_caches,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_route_matrix_survives_mover_moves,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_framereachability_spreads_route_search_over_frames,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_framereachability_reports_pending_cross_cluster_routes,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_area_order_renumbers_behind_original_numbers,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_area_order_keeps_file_order_for_mismatched_lumps,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_point_area_num_walks_node_tree,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_box_and_trace_queries_walk_node_tree,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_native_bsp_trace_clips_against_brushes,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_native_bsp_pvs_separates_clusters,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_entity_linking_walks_node_tree,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_entity_area_queries_past_inline_slots,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_frame_entity_lists_unlink_stale_entities,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
+        cmocka_unit_test_setup_teardown(test_entity_table_grows_geometrically,
+                                        aas_synthetic_setup,
+                                        aas_environment_teardown),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -40,6 +40,73 @@ static char *duplicate_range(const char *json, const jsmntok_t *token)
     return copy;
 }
 
+/* Like duplicate_range, but decodes JSON escapes so "\\n" compares equal to a printed newline. */
+static char *duplicate_unescaped_range(const char *json, const jsmntok_t *token)
+{
+    char *copy = duplicate_range(json, token);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+
+    const char *in = copy;
+    char *out = copy;
+    while (*in != '\0')
+    {
+        if (*in != '\\' || in[1] == '\0')
+        {
+            *out++ = *in++;
+            continue;
+        }
+
+        ++in;
+        switch (*in)
+        {
+            case 'n':
+                *out++ = '\n';
+                break;
+            case 't':
+                *out++ = '\t';
+                break;
+            case 'r':
+                *out++ = '\r';
+                break;
+            case 'u':
+            {
+                unsigned int code = 0U;
+                if (sscanf(in + 1, "%4x", &code) != 1)
+                {
+                    *out++ = *in;
+                    break;
+                }
+                in += 4;
+                if (code < 0x80U)
+                {
+                    *out++ = (char)code;
+                }
+                else if (code < 0x800U)
+                {
+                    *out++ = (char)(0xC0U | (code >> 6));
+                    *out++ = (char)(0x80U | (code & 0x3FU));
+                }
+                else
+                {
+                    *out++ = (char)(0xE0U | (code >> 12));
+                    *out++ = (char)(0x80U | ((code >> 6) & 0x3FU));
+                    *out++ = (char)(0x80U | (code & 0x3FU));
+                }
+                break;
+            }
+            default:
+                *out++ = *in;
+                break;
+        }
+        ++in;
+    }
+    *out = '\0';
+    return copy;
+}
+
 static bool token_equals(const char *json, const jsmntok_t *token, const char *text)
 {
     size_t length = (size_t)(token->end - token->start);
@@ -153,7 +220,7 @@ static int parse_messages(
             }
             else if (token_equals(json, key, "text") && value->type == JSMN_STRING)
             {
-                message->text = duplicate_range(json, value);
+                message->text = duplicate_unescaped_range(json, value);
                 if (message->text == NULL)
                 {
                     free(messages);
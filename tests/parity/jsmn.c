@@ -1,5 +1,3 @@
-#define JSMN_PARENT_LINKS
-
 #include "jsmn.h"
 
 #include <limits.h>
@@ -69,6 +67,9 @@ static int jsmn_parse_primitive(jsmn_parser *parser, const char *js, size_t len,
         return JSMN_ERROR_NOMEM;
     }
     jsmn_fill_token(token, JSMN_PRIMITIVE, start, (int)parser->pos);
+#ifdef JSMN_PARENT_LINKS
+    token->parent = parser->toksuper;
+#endif
 
     parser->pos--;
     return 0;
@@ -229,8 +230,17 @@ int jsmn_parse(jsmn_parser *parser, const char *js, size_t len, jsmntok_t *token
             case '\r':
             case '\n':
             case ' ':
+                break;
             case ':':
+                /* The value that follows belongs to the key, so objects count keys only. */
+                parser->toksuper = (int)(parser->toknext - 1);
+                break;
             case ',':
+                if (tokens != NULL && parser->toksuper != -1 && tokens[parser->toksuper].type != JSMN_ARRAY
+                    && tokens[parser->toksuper].type != JSMN_OBJECT)
+                {
+                    parser->toksuper = tokens[parser->toksuper].parent;
+                }
                 break;
             case '-':
             case '0':
@@ -27,6 +27,9 @@
 
 #include <stddef.h>
 
+/* Set here so every includer agrees on the layout of jsmntok_t. */
+#define JSMN_PARENT_LINKS
+
 #ifdef __cplusplus
 extern "C" {
 #endif
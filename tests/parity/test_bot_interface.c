@@ -13,6 +13,7 @@
 #include "q2bridge/bridge.h"
 #include "botlib/interface/bot_interface.h"
 #include "botlib/interface/bot_state.h"
+#include "botlib/interface/bot_workers.h"
 #include "botlib/ai_chat/ai_chat.h"
 #include "botlib/ea/ea_local.h"
 #include "botlib/ai_move/mover_catalogue.h"
@@ -25,6 +26,7 @@
 #include "botlib/common/l_utils.h"
 #include "botlib/aas/aas_sound.h"
 #include "botlib/aas/aas_local.h"
+#include "botlib/aas/aas_map.h"
 #include "botlib/aas/aas_debug.h"
 #include "botlib_contract_loader.h"
 #include "../support/asset_env.h"
@@ -70,6 +72,8 @@ typedef struct bot_interface_test_context_s
     bool libvar_initialised;
 } bot_interface_test_context_t;
 
+static bool ensure_map_fixture(const asset_env_t *assets, const char *stem);
+
 static mock_bot_import_t *g_active_mock = NULL;
 static int g_mock_import_libvar_set_status = BLERR_NOERROR;
 
@@ -677,6 +681,10 @@ static int teardown_bot_interface(void **state)
     bot_interface_test_context_t *context =
         (bot_interface_test_context_t *)(state != NULL ? *state : NULL);
 
+    /* A failed assertion skips the test's own client shutdown; release the
+     * client states while the botlib heap they point into is still alive. */
+    BotState_ShutdownAll();
+
     if (context != NULL && context->api != NULL)
     {
         context->api->BotShutdownLibrary();
@@ -693,7 +701,6 @@ static int teardown_bot_interface(void **state)
         context->libvar_initialised = false;
     }
 
-    BotState_ShutdownAll();
     g_active_mock = NULL;
     BotInterface_SetImportTable(NULL);
     if (context != NULL)
@@ -736,6 +743,11 @@ static void test_bot_load_map_and_sensory_queues(void **state)
 {
     bot_interface_test_context_t *context = (bot_interface_test_context_t *)*state;
 
+    if (!ensure_map_fixture(&context->assets, "test1"))
+    {
+        cmocka_skip();
+    }
+
     Mock_Reset(&context->mock);
 
     LibVarSet("max_soundinfo", "64");
@@ -963,6 +975,11 @@ static void test_bot_usehook_defaults_disabled(void **state)
 {
     bot_interface_test_context_t *context = (bot_interface_test_context_t *)*state;
 
+    if (!ensure_map_fixture(&context->assets, "test1"))
+    {
+        cmocka_skip();
+    }
+
     Mock_Reset(&context->mock);
 
     int status = context->api->BotSetupLibrary();
@@ -1091,6 +1108,69 @@ static void test_bot_console_message_and_ai_pipeline(void **state)
     context->api->BotShutdownLibrary();
 }
 
+static void test_bot_ai_frame_thinks_for_every_listed_client(void **state)
+{
+    bot_interface_test_context_t *context = (bot_interface_test_context_t *)*state;
+
+    Mock_Reset(&context->mock);
+
+    int status = context->api->BotSetupLibrary();
+    assert_int_equal(status, BLERR_NOERROR);
+
+    status = context->api->BotLibVarSet("aithreads", "2");
+    assert_int_equal(status, BLERR_NOERROR);
+
+    bot_settings_t settings;
+    memset(&settings, 0, sizeof(settings));
+    snprintf(settings.characterfile, sizeof(settings.characterfile), "bots/babe_c.c");
+    snprintf(settings.charactername, sizeof(settings.charactername), "Babe");
+
+    for (int client = 1; client <= 3; ++client)
+    {
+        status = context->api->BotSetupClient(client, &settings);
+        assert_int_equal(status, BLERR_NOERROR);
+    }
+
+    context->api->BotStartFrame(0.1f);
+
+    for (int client = 1; client <= 3; ++client)
+    {
+        bot_updateclient_t update;
+        memset(&update, 0, sizeof(update));
+        update.viewangles[1] = 30.0f * (float)client;
+
+        status = context->api->BotUpdateClient(client, &update);
+        assert_int_equal(status, BLERR_NOERROR);
+    }
+
+    int clients[] = {3, 7, 1, 2};
+    status = context->api->BotAIFrame(clients, 4, 0.05f);
+    assert_int_equal(status, BLERR_AICLIENTNOTSETUP);
+    assert_int_equal(BotWorkers_ThreadCount(), 2);
+    assert_int_equal(context->mock.bot_input_count, 3);
+    assert_int_equal(context->mock.input_clients[0], 3);
+    assert_int_equal(context->mock.input_clients[1], 1);
+    assert_int_equal(context->mock.input_clients[2], 2);
+    for (int index = 0; index < 3; ++index)
+    {
+        int client = context->mock.input_clients[index];
+        assert_float_equal(context->mock.inputs[index].thinktime, 0.05f, 0.0001f);
+        assert_float_equal(context->mock.inputs[index].viewangles[1], 30.0f * (float)client, 0.01f);
+    }
+
+    int repeat[] = {1, 2, 3};
+    status = context->api->BotAIFrame(repeat, 3, 0.05f);
+    assert_int_equal(status, BLERR_AIUPDATEINACTIVECLIENT);
+    assert_int_equal(context->mock.bot_input_count, 3);
+
+    for (int client = 1; client <= 3; ++client)
+    {
+        context->api->BotShutdownClient(client);
+    }
+    context->api->BotShutdownLibrary();
+    assert_int_equal(BotWorkers_ThreadCount(), 0);
+}
+
 static void test_bot_lib_var_set_propagates_import_status(void **state)
 {
     bot_interface_test_context_t *context = (bot_interface_test_context_t *)*state;
@@ -1168,6 +1248,11 @@ static void test_bot_update_entity_populates_aas(void **state)
 {
     bot_interface_test_context_t *context = (bot_interface_test_context_t *)*state;
 
+    if (!ensure_map_fixture(&context->assets, "test2"))
+    {
+        cmocka_skip();
+    }
+
     Mock_Reset(&context->mock);
 
     int status = context->api->BotSetupLibrary();
@@ -1360,7 +1445,6 @@ static void test_bot_interface_mover_parity(void **state)
     memset(&settings, 0, sizeof(settings));
     snprintf(settings.characterfile, sizeof(settings.characterfile), "bots/babe_c.c");
     snprintf(settings.charactername, sizeof(settings.charactername), "Babe");
-    settings.skill = 1;
 
     status = context->api->BotSetupClient(1, &settings);
     assert_int_equal(status, BLERR_NOERROR);
@@ -1715,6 +1799,11 @@ static void test_bot_start_frame_entity_lifecycle(void **state)
 {
     bot_interface_test_context_t *context = (bot_interface_test_context_t *)*state;
 
+    if (!ensure_map_fixture(&context->assets, "test2"))
+    {
+        cmocka_skip();
+    }
+
     Mock_Reset(&context->mock);
 
     int status = context->api->BotSetupLibrary();
@@ -1733,7 +1822,6 @@ static void test_bot_start_frame_entity_lifecycle(void **state)
     entity.modelindex = 2;
     VectorSet(entity.origin, 32.0f, 24.0f, 40.0f);
     VectorCopy(entity.origin, entity.old_origin);
-    VectorCopy(entity.origin, entity.previous_origin);
     VectorSet(entity.mins, -16.0f, -16.0f, -16.0f);
     VectorSet(entity.maxs, 16.0f, 16.0f, 16.0f);
 
@@ -1767,6 +1855,11 @@ static void test_bot_start_frame_updates_routing_diagnostics(void **state)
 {
     bot_interface_test_context_t *context = (bot_interface_test_context_t *)*state;
 
+    if (!ensure_map_fixture(&context->assets, "test2"))
+    {
+        cmocka_skip();
+    }
+
     Mock_Reset(&context->mock);
 
     int status = context->api->BotSetupLibrary();
@@ -1843,6 +1936,9 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_bot_console_message_and_ai_pipeline,
                                         setup_bot_interface,
                                         teardown_bot_interface),
+        cmocka_unit_test_setup_teardown(test_bot_ai_frame_thinks_for_every_listed_client,
+                                        setup_bot_interface,
+                                        teardown_bot_interface),
         cmocka_unit_test_setup_teardown(test_bot_lib_var_set_propagates_import_status,
                                         setup_bot_interface,
                                         teardown_bot_interface),
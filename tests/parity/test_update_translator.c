@@ -140,6 +140,11 @@ static void translator_update_mock_limit_values(int max_clients, int max_entitie
                                  g_mock_limit_state.maxentities_string,
                                  sizeof(g_mock_limit_state.maxentities_string),
                                  g_configured_max_entities);
+
+    /* The bridge re-reads the limits through LibVarValue, which goes to the
+     * libvar store rather than these mock structs, so keep both in step. */
+    LibVarSet("maxclients", g_mock_limit_state.maxclients_string);
+    LibVarSet("maxentities", g_mock_limit_state.maxentities_string);
 }
 
 static void translator_set_mock_max_limits(int max_clients, int max_entities)
@@ -398,18 +403,10 @@ static void test_bridge_update_client_inactive_logs_contract_message(void **stat
 }
 
 static void test_bridge_update_client_rejects_out_of_range_slot(void **state)
-{
-    translator_test_context_t *context = (translator_test_context_t *)(*state);
-    context->print_count = 0U;
-
-    LibVarSet("maxclients", "2");
-    Bridge_ResetCachedUpdates();
-  
-static void test_bridge_update_client_rejects_indices_beyond_mocked_limit(void **state)
 {
     translator_test_context_t *context = (translator_test_context_t *)(*state);
 
-    translator_set_mock_max_clients(3);
+    translator_set_mock_max_clients(2);
     context->print_count = 0U;
 
     bot_updateclient_t update;
@@ -421,8 +418,19 @@ static void test_bridge_update_client_rejects_indices_beyond_mocked_limit(void *
     assert_string_equal(context->prints[0].message, "BotUpdateClient: invalid client number 2, [0, 1]\n");
     assert_int_equal(context->prints[0].severity, PRT_ERROR);
 
-    LibVarSet("maxclients", "4");
-    Bridge_ResetCachedUpdates();
+    translator_set_mock_max_clients(TRANSLATOR_DEFAULT_MAX_CLIENTS);
+}
+
+static void test_bridge_update_client_rejects_indices_beyond_mocked_limit(void **state)
+{
+    translator_test_context_t *context = (translator_test_context_t *)(*state);
+
+    translator_set_mock_max_clients(3);
+    context->print_count = 0U;
+
+    bot_updateclient_t update;
+    memset(&update, 0, sizeof(update));
+
     int status = Bridge_UpdateClient(3, &update);
     assert_int_equal(status, BLERR_INVALIDCLIENTNUMBER);
     assert_true(context->print_count > 0U);
@@ -603,6 +611,101 @@ static void test_bridge_update_entity_accepts_runtime_limit_increase(void **stat
     assert_float_equal(entity_frame.frame_delta, 0.0f, 0.0001f);
 }
 
+static void test_bridge_update_entities_translates_batch(void **state)
+{
+    translator_test_context_t *context = (translator_test_context_t *)(*state);
+
+    translator_set_mock_max_entities(8);
+    context->print_count = 0U;
+
+    TranslateEntity_SetWorldLoaded(qtrue);
+    Bridge_SetFrameTime(1.5f);
+
+    int ents[3] = {2, 9, 5};
+    bot_updateentity_t updates[3];
+    memset(updates, 0, sizeof(updates));
+    for (int index = 0; index < 3; ++index)
+    {
+        updates[index].origin[0] = 32.0f * (float)(index + 1);
+        updates[index].origin[2] = 8.0f;
+        updates[index].maxs[0] = 16.0f;
+        updates[index].solid = 2;
+    }
+
+    int status = Bridge_UpdateEntities(ents, updates, 3);
+    assert_int_equal(status, BLERR_INVALIDENTITYNUMBER);
+    assert_true(context->print_count > 0U);
+
+    const AASEntityFrame *frame = Bridge_EntityFrame(2);
+    assert_non_null(frame);
+    assert_int_equal(frame->number, 2);
+    assert_vec3_equal(frame->origin, updates[0].origin, 0.0001f);
+    assert_float_equal(frame->last_update_time, 1.5f, 0.0001f);
+    assert_true(frame->origin_dirty);
+
+    frame = Bridge_EntityFrame(5);
+    assert_non_null(frame);
+    assert_int_equal(frame->number, 5);
+    assert_vec3_equal(frame->origin, updates[2].origin, 0.0001f);
+    assert_int_equal(frame->solid, 2);
+
+    AASEntityFrame copied;
+    memset(&copied, 0, sizeof(copied));
+    assert_true(Bridge_ReadEntityFrame(5, &copied));
+    assert_memory_equal(&copied, frame, sizeof(copied));
+
+    assert_null(Bridge_EntityFrame(9));
+    assert_null(Bridge_EntityFrame(4));
+}
+
+static void test_bridge_update_entity_skips_unchanged_record(void **state)
+{
+    (void)state;
+
+    TranslateEntity_SetWorldLoaded(qtrue);
+    Bridge_SetFrameTime(1.0f);
+
+    bot_updateentity_t update;
+    memset(&update, 0, sizeof(update));
+    update.origin[0] = 48.0f;
+    update.maxs[2] = 24.0f;
+    update.solid = 2;
+    update.frame = 3;
+
+    assert_int_equal(Bridge_UpdateEntity(6, &update), BLERR_NOERROR);
+    assert_true(Bridge_EntityChanged(6));
+    const AASEntityFrame *frame = Bridge_EntityFrame(6);
+    assert_non_null(frame);
+    assert_true(frame->origin_dirty);
+    assert_true(frame->bounds_dirty);
+
+    Bridge_SetFrameTime(1.5f);
+    assert_int_equal(Bridge_UpdateEntity(6, &update), BLERR_NOERROR);
+    assert_false(Bridge_EntityChanged(6));
+    frame = Bridge_EntityFrame(6);
+    assert_non_null(frame);
+    assert_false(frame->origin_dirty);
+    assert_false(frame->bounds_dirty);
+    assert_false(frame->angles_dirty);
+    assert_float_equal(frame->last_update_time, 1.5f, 0.0001f);
+    assert_float_equal(frame->frame_delta, 0.5f, 0.0001f);
+    assert_float_equal(frame->origin[0], 48.0f, 0.0001f);
+
+    /* A scalar-only change still takes the full translation. */
+    update.frame = 4;
+    Bridge_SetFrameTime(2.0f);
+    assert_int_equal(Bridge_UpdateEntity(6, &update), BLERR_NOERROR);
+    assert_true(Bridge_EntityChanged(6));
+    assert_int_equal(Bridge_EntityFrame(6)->frame, 4);
+    assert_false(Bridge_EntityFrame(6)->origin_dirty);
+
+    Bridge_ClearEntitySlot(6);
+    assert_null(Bridge_EntityFrame(6));
+    assert_false(Bridge_EntityChanged(6));
+    assert_int_equal(Bridge_UpdateEntity(6, &update), BLERR_NOERROR);
+    assert_true(Bridge_EntityChanged(6));
+}
+
 static void test_translate_entity_dirty_flags_and_relink_logging(void **state)
 {
     translator_test_context_t *context = (translator_test_context_t *)(*state);
@@ -843,6 +946,12 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_bridge_update_entity_accepts_runtime_limit_increase,
                                         translator_setup,
                                         translator_teardown),
+        cmocka_unit_test_setup_teardown(test_bridge_update_entities_translates_batch,
+                                        translator_setup,
+                                        translator_teardown),
+        cmocka_unit_test_setup_teardown(test_bridge_update_entity_skips_unchanged_record,
+                                        translator_setup,
+                                        translator_teardown),
         cmocka_unit_test_setup_teardown(test_translate_entity_dirty_flags_and_relink_logging,
                                         translator_setup,
                                         translator_teardown),